@@ -0,0 +1,89 @@
+#ifndef LIBASSERT_BENCH_HPP
+#define LIBASSERT_BENCH_HPP
+
+// Shared pieces of the passing-path benchmarks. Benchmark sources undefine NDEBUG before including anything so that
+// DEBUG_ASSERT, DEBUG_ASSERT_VAL, and <cassert>'s assert are live and all variants check the same condition.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+ #define LIBASSERT_BENCH_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+ #define LIBASSERT_BENCH_COLD __declspec(noinline)
+#else
+ #define LIBASSERT_BENCH_COLD
+#endif
+
+namespace libassert_bench {
+    // the hand-written baseline: a branch to an out-of-line function which, like libassert's failure path, may return
+    LIBASSERT_BENCH_COLD inline void raw_check_failed(const char* expression, const char* file, int line) {
+        (void)std::fprintf(stderr, "check failed at %s:%d: %s\n", file, line, expression);
+        std::abort();
+    }
+
+    constexpr std::size_t n_values = 1024;
+
+    // every check in a benchmark is run once per value, all checks pass
+    template<typename T, typename F>
+    void run_checks(benchmark::State& state, const std::vector<T>& values, F&& check) {
+        for(auto _ : state) {
+            for(const auto& value : values) {
+                benchmark::DoNotOptimize(value);
+                check(value);
+            }
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(values.size()));
+    }
+}
+
+#define LIBASSERT_BENCH_RAW_CHECK(expr) \
+    do { \
+        if(!(expr)) { \
+            libassert_bench::raw_check_failed(#expr, __FILE__, __LINE__); \
+        } \
+    } while(false)
+
+// registers one benchmark per checking method for the condition cond over the values returned by make_values, the
+// value is bound to v
+#define LIBASSERT_BENCH_CHECKS(group, make_values, cond) \
+    static void group##_raw_if(benchmark::State& state) { \
+        libassert_bench::run_checks(state, make_values(), [&] (const auto& v) { LIBASSERT_BENCH_RAW_CHECK(cond); }); \
+    } \
+    static void group##_cassert(benchmark::State& state) { \
+        libassert_bench::run_checks(state, make_values(), [&] (const auto& v) { assert(cond); }); \
+    } \
+    static void group##_ASSERT(benchmark::State& state) { \
+        libassert_bench::run_checks(state, make_values(), [&] (const auto& v) { ASSERT(cond); }); \
+    } \
+    static void group##_DEBUG_ASSERT(benchmark::State& state) { \
+        libassert_bench::run_checks(state, make_values(), [&] (const auto& v) { DEBUG_ASSERT(cond); }); \
+    } \
+    static void group##_ASSUME(benchmark::State& state) { \
+        libassert_bench::run_checks(state, make_values(), [&] (const auto& v) { ASSUME(cond); }); \
+    } \
+    static void group##_ASSERT_VAL(benchmark::State& state) { \
+        libassert_bench::run_checks(state, make_values(), [&] (const auto& v) { \
+            benchmark::DoNotOptimize(ASSERT_VAL(cond)); \
+        }); \
+    } \
+    static void group##_DEBUG_ASSERT_VAL(benchmark::State& state) { \
+        libassert_bench::run_checks(state, make_values(), [&] (const auto& v) { \
+            benchmark::DoNotOptimize(DEBUG_ASSERT_VAL(cond)); \
+        }); \
+    } \
+    BENCHMARK(group##_raw_if); \
+    BENCHMARK(group##_cassert); \
+    BENCHMARK(group##_ASSERT); \
+    BENCHMARK(group##_DEBUG_ASSERT); \
+    BENCHMARK(group##_ASSUME); \
+    BENCHMARK(group##_ASSERT_VAL); \
+    BENCHMARK(group##_DEBUG_ASSERT_VAL)
+
+#endif
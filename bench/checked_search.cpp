@@ -0,0 +1,59 @@
+// Cost of libassert::checked::lower_bound's sampled sortedness check compared to std::lower_bound alone and to checking
+// the whole range with std::is_sorted before every search
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <libassert/checked-algorithms.hpp>
+
+namespace {
+    std::vector<int> make_sorted(std::size_t size) {
+        std::vector<int> values(size);
+        for(std::size_t i = 0; i < size; i++) {
+            values[i] = static_cast<int>(i * 2);
+        }
+        return values;
+    }
+
+    // every search looks up a pseudo-random value in the range
+    template<typename F>
+    void run_searches(benchmark::State& state, F&& search) {
+        const auto values = make_sorted(static_cast<std::size_t>(state.range(0)));
+        std::uint32_t key = 1;
+        for(auto _ : state) {
+            key = key * 1664525 + 1013904223;
+            const int value = static_cast<int>(key % (values.size() * 2));
+            benchmark::DoNotOptimize(search(values, value));
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    }
+}
+
+static void lower_bound_std(benchmark::State& state) {
+    run_searches(state, [] (const std::vector<int>& values, int value) {
+        return std::lower_bound(values.begin(), values.end(), value);
+    });
+}
+
+static void lower_bound_checked(benchmark::State& state) {
+    run_searches(state, [] (const std::vector<int>& values, int value) {
+        return libassert::checked::lower_bound(values.begin(), values.end(), value);
+    });
+}
+
+static void lower_bound_is_sorted(benchmark::State& state) {
+    run_searches(state, [] (const std::vector<int>& values, int value) {
+        LIBASSERT_ASSERT(std::is_sorted(values.begin(), values.end()));
+        return std::lower_bound(values.begin(), values.end(), value);
+    });
+}
+
+BENCHMARK(lower_bound_std)->Range(1 << 6, 1 << 20);
+BENCHMARK(lower_bound_checked)->Range(1 << 6, 1 << 20);
+BENCHMARK(lower_bound_is_sorted)->Range(1 << 6, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,58 @@
+# Compares the compile time of assertions with <libassert/assert.hpp> and <libassert/assert-fwd.hpp>. Usage:
+#   compile_time.py generate <sites> <header> <output.cpp>
+#   compile_time.py measure <runs> <compiler> <assert.hpp source> <assert-fwd.hpp source> [compiler flags...]
+# generate writes a source file which includes the header and has one function per site, each function has an ASSERT
+# on ints with a message and an extra diagnostic. measure prints a json object with the median front end time
+# (-fsyntax-only) and the number of preprocessed lines of each source. GCC and Clang only.
+
+import json
+import statistics
+import subprocess
+import sys
+import time
+
+def generate(sites, header, path):
+    with open(path, "w") as f:
+        f.write("// Generated by compile_time.py, do not edit\n")
+        f.write("#include <{}>\n\n".format(header))
+        for i in range(sites):
+            f.write("void site_{0}(int x, int y) {{\n".format(i))
+            f.write("    ASSERT(x + {0} < y, \"site {0} failed\", x * {0});\n".format(i))
+            f.write("}\n")
+
+def compile_time(compiler, flags, source, runs):
+    times = []
+    for _ in range(runs):
+        start = time.perf_counter()
+        subprocess.run([compiler, *flags, "-fsyntax-only", source], check=True)
+        times.append(time.perf_counter() - start)
+    return statistics.median(times)
+
+def preprocessed_lines(compiler, flags, source):
+    output = subprocess.run([compiler, *flags, "-E", source], check=True, capture_output=True, text=True).stdout
+    return output.count("\n")
+
+def measure(runs, compiler, sources, flags):
+    results = {}
+    for name, source in zip(("assert.hpp", "assert-fwd.hpp"), sources):
+        results[name] = {
+            "compile_ms": compile_time(compiler, flags, source, runs) * 1e3,
+            "preprocessed_lines": preprocessed_lines(compiler, flags, source),
+        }
+    json.dump(results, sys.stdout, indent=2)
+    print()
+
+def main():
+    if len(sys.argv) == 5 and sys.argv[1] == "generate":
+        generate(int(sys.argv[2]), sys.argv[3], sys.argv[4])
+    elif len(sys.argv) >= 6 and sys.argv[1] == "measure":
+        measure(int(sys.argv[2]), sys.argv[3], sys.argv[4:6], sys.argv[6:])
+    else:
+        print(
+            "Usage: compile_time.py generate <sites> <header> <output.cpp>\n"
+            "       compile_time.py measure <runs> <compiler> <assert.hpp source> <assert-fwd.hpp source> [flags...]",
+            file=sys.stderr
+        )
+        sys.exit(2)
+
+main()
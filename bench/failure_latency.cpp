@@ -0,0 +1,165 @@
+// Latency of the failure path broken down by phase, for the first failure in a process (cold) and for repeated failures
+// (warm). Each benchmark reports the p50 and p99 of every phase in microseconds as counters, the iteration time is the
+// total time of a failure. Cold samples are taken in forked children and aren't available on Windows.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+ #include <sys/wait.h>
+ #include <unistd.h>
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include <libassert/assert.hpp>
+
+namespace {
+    constexpr std::size_t n_samples = 50;
+
+    // one sample per phase plus the total
+    using sample = std::array<std::int64_t, libassert::failure_phase_count + 1>;
+
+    std::FILE* null_output() {
+        #ifdef _WIN32
+        static std::FILE* file = std::fopen("NUL", "w");
+        #else
+        static std::FILE* file = std::fopen("/dev/null", "w");
+        #endif
+        return file;
+    }
+
+    // what default_failure_handler does, without aborting and without the terminal
+    void rendering_handler(const libassert::assertion_info& info) {
+        std::string message = info.to_string(120, libassert::color_scheme::ansi_rgb);
+        libassert::detail::phase_timer timer(libassert::failure_phase::output);
+        (void)std::fwrite(message.data(), 1, message.size(), null_output());
+        (void)std::fflush(null_output());
+    }
+
+    struct point {
+        int x;
+        int y;
+        bool operator==(const point& other) const {
+            return x == other.x && y == other.y;
+        }
+    };
+
+    LIBASSERT_ATTR_NOINLINE void fail_once(const std::map<std::string, std::vector<point>>& points) {
+        const std::vector<point> expected{{1, 2}};
+        ASSERT(points.at("origin") == expected, "points should have been moved", points.size());
+    }
+
+    sample take_sample() {
+        static const std::map<std::string, std::vector<point>> points{{"origin", {{0, 0}, {0, 1}}}, {"other", {}}};
+        libassert::reset_phase_timings();
+        auto start = std::chrono::steady_clock::now();
+        fail_once(points);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        const auto timings = libassert::phase_timings();
+        sample result{};
+        for(std::size_t i = 0; i < timings.size(); i++) {
+            result[i] = timings[i].time.count();
+        }
+        result.back() = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        return result;
+    }
+
+    double percentile(std::vector<std::int64_t> values, double p) {
+        std::sort(values.begin(), values.end());
+        auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(values.size())));
+        return static_cast<double>(values[std::max<std::size_t>(rank, 1) - 1]) / 1e3;
+    }
+
+    void report(benchmark::State& state, const std::vector<sample>& samples) {
+        for(std::size_t i = 0; i <= libassert::failure_phase_count; i++) {
+            std::string name = "total";
+            if(i < libassert::failure_phase_count) {
+                name = std::string(libassert::phase_name(static_cast<libassert::failure_phase>(i)));
+                std::replace(name.begin(), name.end(), ' ', '_');
+            }
+            std::vector<std::int64_t> values;
+            for(const auto& s : samples) {
+                values.push_back(s[i]);
+            }
+            state.counters[name + "_p50_us"] = percentile(values, 0.5);
+            state.counters[name + "_p99_us"] = percentile(values, 0.99);
+        }
+    }
+
+    void setup() {
+        libassert::set_failure_handler(rendering_handler);
+        libassert::enable_phase_timing(false);
+    }
+
+    // must run before anything fails in this process so that children start cold
+    void failure_latency_cold(benchmark::State& state) {
+        #ifdef _WIN32
+        state.SkipWithError("cold samples need fork");
+        #else
+        setup();
+        std::vector<sample> samples;
+        for(auto _ : state) {
+            int fds[2];
+            if(pipe(fds) != 0) {
+                state.SkipWithError("pipe failed");
+                break;
+            }
+            pid_t pid = fork();
+            if(pid < 0) {
+                close(fds[0]);
+                close(fds[1]);
+                state.SkipWithError("fork failed");
+                break;
+            }
+            if(pid == 0) {
+                close(fds[0]);
+                sample s = take_sample();
+                auto written = write(fds[1], s.data(), sizeof(s));
+                _exit(written == sizeof(s) ? 0 : 1);
+            }
+            close(fds[1]);
+            sample s{};
+            auto n_read = read(fds[0], s.data(), sizeof(s));
+            close(fds[0]);
+            int status = 0;
+            waitpid(pid, &status, 0);
+            if(n_read != sizeof(s) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                state.SkipWithError("failed to take a sample in a child process");
+                break;
+            }
+            state.SetIterationTime(static_cast<double>(s.back()) / 1e9);
+            samples.push_back(s);
+        }
+        if(!samples.empty()) {
+            report(state, samples);
+        }
+        #endif
+    }
+
+    void failure_latency_warm(benchmark::State& state) {
+        setup();
+        // warm up symbolization, the analysis tables, and the type name caches
+        (void)take_sample();
+        std::vector<sample> samples;
+        for(auto _ : state) {
+            sample s = take_sample();
+            state.SetIterationTime(static_cast<double>(s.back()) / 1e9);
+            samples.push_back(s);
+        }
+        report(state, samples);
+    }
+}
+
+BENCHMARK(failure_latency_cold)->Iterations(n_samples)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(failure_latency_warm)->Iterations(n_samples * 10)->UseManualTime()->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,75 @@
+// Passing cost of the assertion macros compared to a raw if and <cassert>
+#undef NDEBUG
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <libassert/assert.hpp>
+
+#include "bench.hpp"
+
+namespace {
+    std::vector<int> make_ints() {
+        std::vector<int> values(libassert_bench::n_values);
+        for(std::size_t i = 0; i < values.size(); i++) {
+            values[i] = static_cast<int>(i);
+        }
+        return values;
+    }
+    volatile int int_limit_storage = 1 << 20;
+    const int int_limit = int_limit_storage;
+
+    std::vector<std::string> make_strings() {
+        std::vector<std::string> values;
+        for(std::size_t i = 0; i < libassert_bench::n_values; i++) {
+            values.push_back("value " + std::to_string(i));
+        }
+        return values;
+    }
+    const std::string forbidden_string = "forbidden";
+
+    std::vector<const int*> make_pointers() {
+        static const std::vector<int> ints = make_ints();
+        std::vector<const int*> values;
+        for(const auto& i : ints) {
+            values.push_back(&i);
+        }
+        return values;
+    }
+    const int* const null_pointer = nullptr;
+
+    // Operands which are prvalues are stored by value in the expression decomposer, lvalues by reference. The
+    // assertion macros pass the decomposer to the failure path differently depending on whether it's larger than 32
+    // bytes: make_small(v) != small_sentinel decomposes to 16 bytes and make_large(v) != large_sentinel to 48.
+    struct small_value {
+        std::uint64_t a;
+        bool operator!=(const small_value& other) const {
+            return a != other.a;
+        }
+    };
+    struct large_value {
+        std::uint64_t a, b, c, d, e;
+        bool operator!=(const large_value& other) const {
+            return a != other.a || b != other.b || c != other.c || d != other.d || e != other.e;
+        }
+    };
+    const small_value small_sentinel{~std::uint64_t(0)};
+    const large_value large_sentinel{~std::uint64_t(0), 0, 0, 0, 0};
+    small_value make_small(int v) {
+        return {static_cast<std::uint64_t>(v)};
+    }
+    large_value make_large(int v) {
+        return {static_cast<std::uint64_t>(v), 0, 0, 0, 0};
+    }
+}
+
+LIBASSERT_BENCH_CHECKS(int_less, make_ints, v < int_limit);
+LIBASSERT_BENCH_CHECKS(string_not_equal, make_strings, v != forbidden_string);
+LIBASSERT_BENCH_CHECKS(pointer_not_null, make_pointers, v != null_pointer);
+LIBASSERT_BENCH_CHECKS(decomposer_small, make_ints, make_small(v) != small_sentinel);
+LIBASSERT_BENCH_CHECKS(decomposer_large, make_ints, make_large(v) != large_sentinel);
+
+BENCHMARK_MAIN();
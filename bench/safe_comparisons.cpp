@@ -0,0 +1,54 @@
+// Passing cost of mixed-sign comparisons with LIBASSERT_SAFE_COMPARISONS. This is a separate executable because the
+// macro changes the definitions of libassert's comparison operators.
+#undef NDEBUG
+#define LIBASSERT_SAFE_COMPARISONS
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <libassert/assert.hpp>
+
+#include "bench.hpp"
+
+namespace {
+    std::vector<int> make_ints() {
+        std::vector<int> values(libassert_bench::n_values);
+        for(std::size_t i = 0; i < values.size(); i++) {
+            values[i] = static_cast<int>(i) - static_cast<int>(values.size() / 2);
+        }
+        return values;
+    }
+    volatile unsigned limit_storage = 1u << 20;
+    const unsigned unsigned_limit = limit_storage;
+}
+
+// the raw if and <cassert> variants are the equivalent hand-written safe comparison
+LIBASSERT_BENCH_CHECKS(mixed_sign_less, make_ints, v < 0 || static_cast<unsigned>(v) < unsigned_limit);
+
+static void mixed_sign_less_safe_ASSERT(benchmark::State& state) {
+    libassert_bench::run_checks(state, make_ints(), [] (int v) { ASSERT(v < unsigned_limit); });
+}
+static void mixed_sign_less_safe_DEBUG_ASSERT(benchmark::State& state) {
+    libassert_bench::run_checks(state, make_ints(), [] (int v) { DEBUG_ASSERT(v < unsigned_limit); });
+}
+static void mixed_sign_less_safe_ASSUME(benchmark::State& state) {
+    libassert_bench::run_checks(state, make_ints(), [] (int v) { ASSUME(v < unsigned_limit); });
+}
+static void mixed_sign_less_safe_ASSERT_VAL(benchmark::State& state) {
+    libassert_bench::run_checks(state, make_ints(), [] (int v) {
+        benchmark::DoNotOptimize(ASSERT_VAL(v < unsigned_limit));
+    });
+}
+static void mixed_sign_less_safe_DEBUG_ASSERT_VAL(benchmark::State& state) {
+    libassert_bench::run_checks(state, make_ints(), [] (int v) {
+        benchmark::DoNotOptimize(DEBUG_ASSERT_VAL(v < unsigned_limit));
+    });
+}
+BENCHMARK(mixed_sign_less_safe_ASSERT);
+BENCHMARK(mixed_sign_less_safe_DEBUG_ASSERT);
+BENCHMARK(mixed_sign_less_safe_ASSUME);
+BENCHMARK(mixed_sign_less_safe_ASSERT_VAL);
+BENCHMARK(mixed_sign_less_safe_DEBUG_ASSERT_VAL);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,76 @@
+# Compares the default static data of assertion sites with LIBASSERT_COMPACT_STATIC_DATA. Usage:
+#   static_data.py generate <sites> <output.cpp>
+#   static_data.py measure <readelf> <runs> <default executable> <compact executable>
+# generate writes a source file with one function per site, each function has an ASSERT with a message and an extra
+# diagnostic and is never called. measure prints a json object with the number of dynamic relocations, the size of the
+# relocated data, and the median startup time of each executable. Both executables have to be position independent for
+# the comparison to mean anything. ELF only.
+
+import json
+import re
+import statistics
+import subprocess
+import sys
+import time
+
+def generate(sites, path):
+    with open(path, "w") as f:
+        f.write("// Generated by static_data.py, do not edit\n")
+        f.write("#include <libassert/assert.hpp>\n\n")
+        for i in range(sites):
+            f.write("void site_{0}(int x, int y) {{\n".format(i))
+            f.write("    ASSERT(x + {0} < y, \"site {0} failed\", x * {0});\n".format(i))
+            f.write("}\n")
+        f.write("\nint main() {}\n")
+
+def count_relocations(readelf, path):
+    output = subprocess.run([readelf, "-rW", path], check=True, capture_output=True, text=True).stdout
+    count = 0
+    for line in output.splitlines():
+        m = re.match(r"^Relocation section '([^']+)' at offset \S+ contains (\d+) entr", line)
+        if m:
+            count += int(m.group(2))
+    return count
+
+def relocated_data_size(readelf, path):
+    output = subprocess.run([readelf, "-SW", path], check=True, capture_output=True, text=True).stdout
+    size = 0
+    for line in output.splitlines():
+        m = re.match(r"^\s*\[\s*\d+\]\s+(\S+)\s+\S+\s+[0-9a-f]+\s+[0-9a-f]+\s+([0-9a-f]+)", line)
+        if m and m.group(1) == ".data.rel.ro":
+            size += int(m.group(2), 16)
+    return size
+
+def startup_time(path, runs):
+    times = []
+    for _ in range(runs):
+        start = time.perf_counter()
+        subprocess.run([path], check=True)
+        times.append(time.perf_counter() - start)
+    return statistics.median(times)
+
+def measure(readelf, runs, executables):
+    results = {}
+    for name, path in zip(("default", "compact"), executables):
+        results[name] = {
+            "relocations": count_relocations(readelf, path),
+            "data_rel_ro_bytes": relocated_data_size(readelf, path),
+            "startup_us": startup_time(path, runs) * 1e6,
+        }
+    json.dump(results, sys.stdout, indent=2)
+    print()
+
+def main():
+    if len(sys.argv) == 4 and sys.argv[1] == "generate":
+        generate(int(sys.argv[2]), sys.argv[3])
+    elif len(sys.argv) == 6 and sys.argv[1] == "measure":
+        measure(sys.argv[2], int(sys.argv[3]), sys.argv[4:])
+    else:
+        print(
+            "Usage: static_data.py generate <sites> <output.cpp>\n"
+            "       static_data.py measure <readelf> <runs> <default executable> <compact executable>",
+            file=sys.stderr
+        )
+        sys.exit(2)
+
+main()
@@ -93,6 +93,11 @@ mark_as_advanced(LIBASSERT_INSTALL_CMAKEDIR)
 # obtain it from the official GitHub repo
 option(LIBASSERT_USE_EXTERNAL_CPPTRACE "Obtain cpptrace via find_package instead of FetchContent" OFF)
 
+# Where stack traces come from: cpptrace, the C++23 <stacktrace> library (stdlib), or nowhere (none). With none,
+# libassert doesn't depend on cpptrace and failure reports don't have stack traces.
+set(LIBASSERT_STACKTRACE_BACKEND "cpptrace" CACHE STRING "Stack trace backend: cpptrace, stdlib, or none")
+set_property(CACHE LIBASSERT_STACKTRACE_BACKEND PROPERTY STRINGS cpptrace stdlib none)
+
 # Enables the use of the magic_enum library in order to provide better
 # diagnostic messages for enum class types.
 # Because magic_enum is used in the our public header file, magic_enum is
@@ -106,6 +111,14 @@ option(LIBASSERT_USE_EXTERNAL_MAGIC_ENUM "Obtain magic_enum via find_package ins
 
 option(LIBASSERT_WERROR_BUILD "" OFF)
 
+# Builds command line utilities such as libassert-ring-dump
+option(LIBASSERT_BUILD_TOOLS "Build ${package_name} command line tools" OFF)
+
+# Builds the google benchmark based microbenchmarks in bench/, the run-benchmarks target runs them and writes json
+# results to bench-results/ in the build directory
+option(LIBASSERT_BUILD_BENCHMARKS "Build ${package_name} benchmarks" OFF)
+option(LIBASSERT_USE_EXTERNAL_BENCHMARK "Obtain google benchmark via find_package instead of FetchContent" OFF)
+
 option(LIBASSERT_PROVIDE_EXPORT_SET "" ON)
 mark_as_advanced(
   LIBASSERT_PROVIDE_EXPORT_SET
@@ -1,6 +1,10 @@
 #ifndef LIBASSERT_CATCH2_HPP
 #define LIBASSERT_CATCH2_HPP
 
+#include <cstdlib>
+#include <string>
+#include <utility>
+
 #define LIBASSERT_PREFIX_ASSERTIONS
 #include <libassert/assert.hpp>
 
@@ -10,8 +14,31 @@
 #if defined(_MSVC_TRADITIONAL) && _MSVC_TRADITIONAL != 0
  #error "Libassert integration does not work with MSVC's non-conformant preprocessor. /Zc:preprocessor must be used."
 #endif
+
+namespace libassert::detail {
+    // set by the ASSERT wrapper on its failure path, tells the failure handler the wrapper will leave the test body
+    inline thread_local bool catch2_in_wrapper = false;
+}
+
 // TODO: CHECK/REQUIRE?
-#define ASSERT(...) do { try { LIBASSERT_ASSERT(__VA_ARGS__); SUCCEED(); } catch(std::exception& e) { FAIL(e.what()); } } while(false)
+// The failure is reported to catch by the failure handler, no exceptions involved. ASSERT then returns from the test
+// body. Passing checks aren't recorded with catch, the passing path is just the condition branch.
+#define ASSERT(expr, ...) \
+    do { \
+        bool libassert_catch2_failed = false; \
+        LIBASSERT_INVOKE( \
+            expr, \
+            "ASSERT", \
+            assertion, \
+            libassert_catch2_failed = true; \
+            libassert::detail::catch2_in_wrapper = true;, \
+            __VA_ARGS__ \
+        ); \
+        if(libassert_catch2_failed) { \
+            libassert::detail::catch2_in_wrapper = false; \
+            return; \
+        } \
+    } while(false)
 
 namespace libassert::detail {
     // catch line wrapping can't handle ansi sequences before 3.6 https://github.com/catchorg/Catch2/issues/2833
@@ -30,7 +57,27 @@ namespace libassert::detail {
         message += info.statement(scheme)
                 + info.print_binary_diagnostics(CATCH_CONFIG_CONSOLE_WIDTH, scheme)
                 + info.print_extra_diagnostics(CATCH_CONFIG_CONSOLE_WIDTH, scheme);
-        throw std::runtime_error(std::move(message));
+        const bool in_wrapper = catch2_in_wrapper;
+        // Failures from outside the wrapper, e.g. in code under test, have no test body to return from here so they
+        // unwind to catch with the normal disposition if exceptions are available.
+        #ifdef CATCH_CONFIG_DISABLE_EXCEPTIONS
+         const auto disposition = Catch::ResultDisposition::ContinueOnFailure;
+        #else
+         const auto disposition = in_wrapper ? Catch::ResultDisposition::ContinueOnFailure
+                                             : Catch::ResultDisposition::Normal;
+        #endif
+        // catch keeps these strings around, they all point to static storage
+        Catch::AssertionHandler handler(
+            Catch::StringRef(info.macro_name.data(), info.macro_name.size()),
+            Catch::SourceLineInfo(info.file_name.data(), info.line),
+            Catch::StringRef(info.expression_string.data(), info.expression_string.size()),
+            disposition
+        );
+        handler.handleMessage(Catch::ResultWas::ExplicitFailure, std::move(message));
+        handler.complete();
+        if(!in_wrapper && (info.type == assert_type::panic || info.type == assert_type::unreachable)) {
+            std::abort();
+        }
     }
 
     inline auto pre_main = [] () {
@@ -0,0 +1,427 @@
+#ifndef LIBASSERT_FWD_HPP
+#define LIBASSERT_FWD_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <libassert/platform.hpp>
+#include <libassert/utilities.hpp>
+#include <libassert/expression-decomposition.hpp>
+
+// =====================================================================================================================
+// || Minimal-include assertions                                                                                      ||
+// =====================================================================================================================
+
+// This header is the part of libassert that the assertion macros and expression decomposition need, it doesn't pull
+// in the standard library beyond <string_view> and <type_traits>, cpptrace, or the stringification templates.
+// <libassert/assert.hpp> builds on it. Included on its own it provides DEBUG_ASSERT, ASSERT, ASSUME, PANIC, and
+// UNREACHABLE which fail through an out-of-line path: operands and extra diagnostics of builtin types (bool,
+// characters, integers, floating point numbers, enums, pointers, C strings, and anything convertible to
+// std::string_view) are stringified inside the library, other types are only shown by their type name. The _VAL
+// variants, custom stringifiers, and the site counter / site policy / stripped site string features need
+// <libassert/assert.hpp>, which can be included after this header and then takes over the macros.
+
+namespace libassert {
+    enum class assert_type {
+        debug_assertion,
+        assertion,
+        assumption,
+        panic,
+        unreachable
+    };
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT bool is_debugger_present() noexcept;
+
+    inline void ERROR_ASSERTION_FAILURE_IN_CONSTEXPR_CONTEXT() {
+        // This non-constexpr method is called from an assertion in a constexpr context if a failure occurs. It is
+        // intentionally a no-op.
+    }
+}
+
+namespace libassert::detail {
+    // "expr\0arg1\0arg2" as emitted by sites with LIBASSERT_STRINGIFY_SITE_ARG
+    template<std::size_t N>
+    constexpr std::string_view site_strings(const char (&strings)[N]) { // NOLINT(*-avoid-c-arrays)
+        return {strings, N - 1};
+    }
+
+    // everything the out-of-line failure path needs to know about a site, built on the failure path
+    struct fwd_site {
+        const char* macro_name;
+        assert_type type;
+        std::string_view strings; // see site_strings
+        source_location location;
+    };
+
+    // an operand or extra diagnostic value passed to the out-of-line failure path
+    struct fwd_value {
+        enum class kind : unsigned char {
+            boolean,
+            character,
+            signed_integer,
+            unsigned_integer,
+            signed_enum,
+            unsigned_enum,
+            floating_point,
+            null_pointer,
+            pointer,
+            c_string,
+            string,
+            other // only the type is known
+        };
+        kind value_kind;
+        unsigned char size; // sizeof the original integer or floating point type
+        union {
+            bool boolean;
+            char character;
+            long long signed_integer;
+            unsigned long long unsigned_integer;
+            long double floating_point;
+            const void* pointer;
+            const char* c_string;
+        };
+        std::string_view string;
+        std::string_view type;
+    };
+
+    // fills in value rather than returning it, returning a union with a long double by value makes gcc note an old
+    // ABI change at every site
+    template<typename T>
+    LIBASSERT_ATTR_COLD
+    void make_fwd_value(fwd_value& value, const T& t) {
+        using U = strip<T>;
+        using kind = fwd_value::kind;
+        value.size = sizeof(U);
+        value.type = type_name<U>();
+        if constexpr(std::is_same_v<U, bool>) {
+            value.value_kind = kind::boolean;
+            value.boolean = t;
+        } else if constexpr(std::is_same_v<U, char>) {
+            value.value_kind = kind::character;
+            value.character = t;
+        } else if constexpr(std::is_integral_v<U> && std::is_signed_v<U>) {
+            value.value_kind = kind::signed_integer;
+            value.signed_integer = t;
+        } else if constexpr(std::is_integral_v<U>) {
+            value.value_kind = kind::unsigned_integer;
+            value.unsigned_integer = t;
+        } else if constexpr(std::is_enum_v<U>) {
+            using E = std::underlying_type_t<U>;
+            if constexpr(std::is_signed_v<E>) {
+                value.value_kind = kind::signed_enum;
+                value.signed_integer = static_cast<E>(t);
+            } else {
+                value.value_kind = kind::unsigned_enum;
+                value.unsigned_integer = static_cast<E>(t);
+            }
+        } else if constexpr(std::is_floating_point_v<U>) {
+            value.value_kind = kind::floating_point;
+            value.floating_point = t;
+        } else if constexpr(std::is_same_v<U, std::nullptr_t>) {
+            value.value_kind = kind::null_pointer;
+        } else if constexpr(is_c_string<U>) {
+            value.value_kind = kind::c_string;
+            value.c_string = t;
+        } else if constexpr(std::is_convertible_v<const U&, std::string_view>) {
+            value.value_kind = kind::string;
+            value.string = t;
+        } else if constexpr(
+            std::is_pointer_v<U>
+            && (std::is_object_v<std::remove_pointer_t<U>> || std::is_void_v<std::remove_pointer_t<U>>)
+            && !std::is_volatile_v<std::remove_pointer_t<U>>
+        ) {
+            value.value_kind = kind::pointer;
+            value.pointer = t;
+        } else {
+            value.value_kind = kind::other;
+        }
+    }
+
+    // op is empty if the expression wasn't a binary operation, then there is one operand
+    LIBASSERT_EXPORT void fwd_assert_fail(
+        const fwd_site& site,
+        const fwd_value* operands,
+        std::string_view op,
+        const fwd_value* args,
+        std::size_t n_args,
+        const char* pretty_function
+    );
+
+    [[noreturn]] LIBASSERT_EXPORT void fwd_panic(
+        const fwd_site& site,
+        const fwd_value* args,
+        std::size_t n_args,
+        const char* pretty_function
+    );
+
+    template<typename A, typename B, typename C, typename... Args>
+    LIBASSERT_ATTR_COLD LIBASSERT_ATTR_NOINLINE
+    void fwd_process_assert_fail(
+        const expression_decomposer<A, B, C>& decomposer,
+        const fwd_site& site,
+        const char* pretty_function,
+        const Args&... args
+    ) {
+        fwd_value values[sizeof...(args) + 1]{}; // NOLINT(*-avoid-c-arrays)
+        std::size_t i = 0;
+        (make_fwd_value(values[i++], args), ...);
+        (void)i;
+        fwd_value operands[2]{}; // NOLINT(*-avoid-c-arrays)
+        make_fwd_value(operands[0], decomposer.a);
+        if constexpr(is_nothing<C>) {
+            fwd_assert_fail(site, operands, {}, values, sizeof...(args), pretty_function);
+        } else {
+            make_fwd_value(operands[1], decomposer.b);
+            fwd_assert_fail(site, operands, C::op_string, values, sizeof...(args), pretty_function);
+        }
+    }
+
+    template<typename... Args>
+    LIBASSERT_ATTR_COLD [[noreturn]] LIBASSERT_ATTR_NOINLINE
+    void fwd_process_panic(const fwd_site& site, const char* pretty_function, const Args&... args) {
+        fwd_value values[sizeof...(args) + 1]{}; // NOLINT(*-avoid-c-arrays)
+        std::size_t i = 0;
+        (make_fwd_value(values[i++], args), ...);
+        (void)i;
+        fwd_panic(site, values, sizeof...(args), pretty_function);
+    }
+}
+
+#if LIBASSERT_IS_CLANG || LIBASSERT_IS_GCC || !LIBASSERT_NON_CONFORMANT_MSVC_PREPROCESSOR
+ // Macro mapping utility by William Swanson https://github.com/swansontec/map-macro/blob/master/map.h
+ #define LIBASSERT_EVAL0(...) __VA_ARGS__
+ #define LIBASSERT_EVAL1(...) LIBASSERT_EVAL0(LIBASSERT_EVAL0(LIBASSERT_EVAL0(__VA_ARGS__)))
+ #define LIBASSERT_EVAL2(...) LIBASSERT_EVAL1(LIBASSERT_EVAL1(LIBASSERT_EVAL1(__VA_ARGS__)))
+ #define LIBASSERT_EVAL3(...) LIBASSERT_EVAL2(LIBASSERT_EVAL2(LIBASSERT_EVAL2(__VA_ARGS__)))
+ #define LIBASSERT_EVAL4(...) LIBASSERT_EVAL3(LIBASSERT_EVAL3(LIBASSERT_EVAL3(__VA_ARGS__)))
+ #define LIBASSERT_EVAL(...)  LIBASSERT_EVAL4(LIBASSERT_EVAL4(LIBASSERT_EVAL4(__VA_ARGS__)))
+ #define LIBASSERT_MAP_END(...)
+ #define LIBASSERT_MAP_OUT
+ #define LIBASSERT_MAP_COMMA ,
+ #define LIBASSERT_MAP_GET_END2() 0, LIBASSERT_MAP_END
+ #define LIBASSERT_MAP_GET_END1(...) LIBASSERT_MAP_GET_END2
+ #define LIBASSERT_MAP_GET_END(...) LIBASSERT_MAP_GET_END1
+ #define LIBASSERT_MAP_NEXT0(test, next, ...) next LIBASSERT_MAP_OUT
+ #define LIBASSERT_MAP_NEXT1(test, next) LIBASSERT_MAP_NEXT0(test, next, 0)
+ #define LIBASSERT_MAP_NEXT(test, next)  LIBASSERT_MAP_NEXT1(LIBASSERT_MAP_GET_END test, next)
+ #define LIBASSERT_MAP0(f, x, peek, ...) f(x) LIBASSERT_MAP_NEXT(peek, LIBASSERT_MAP1)(f, peek, __VA_ARGS__)
+ #define LIBASSERT_MAP1(f, x, peek, ...) f(x) LIBASSERT_MAP_NEXT(peek, LIBASSERT_MAP0)(f, peek, __VA_ARGS__)
+ #define LIBASSERT_MAP_LIST_NEXT1(test, next) LIBASSERT_MAP_NEXT0(test, LIBASSERT_MAP_COMMA next, 0)
+ #define LIBASSERT_MAP_LIST_NEXT(test, next)  LIBASSERT_MAP_LIST_NEXT1(LIBASSERT_MAP_GET_END test, next)
+ #define LIBASSERT_MAP_LIST0(f, x, peek, ...) \
+                                   f(x) LIBASSERT_MAP_LIST_NEXT(peek, LIBASSERT_MAP_LIST1)(f, peek, __VA_ARGS__)
+ #define LIBASSERT_MAP_LIST1(f, x, peek, ...) \
+                                   f(x) LIBASSERT_MAP_LIST_NEXT(peek, LIBASSERT_MAP_LIST0)(f, peek, __VA_ARGS__)
+ #define LIBASSERT_MAP(f, ...) LIBASSERT_EVAL(LIBASSERT_MAP1(f, __VA_ARGS__, ()()(), ()()(), ()()(), 0))
+#else
+ // https://stackoverflow.com/a/29474124/15675011
+ #define LIBASSERT_PLUS_TEXT_(x,y) x ## y
+ #define LIBASSERT_PLUS_TEXT(x, y) LIBASSERT_PLUS_TEXT_(x, y)
+ #define LIBASSERT_ARG_1(_1, ...) _1
+ #define LIBASSERT_ARG_2(_1, _2, ...) _2
+ #define LIBASSERT_ARG_3(_1, _2, _3, ...) _3
+ #define LIBASSERT_ARG_40( _0, _1, _2, _3, _4, _5, _6, _7, _8, _9, \
+                 _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, \
+                 _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, \
+                 _30, _31, _32, _33, _34, _35, _36, _37, _38, _39, \
+                 ...) _39
+ #define LIBASSERT_OTHER_1(_1, ...) __VA_ARGS__
+ #define LIBASSERT_OTHER_3(_1, _2, _3, ...) __VA_ARGS__
+ #define LIBASSERT_EVAL0(...) __VA_ARGS__
+ #define LIBASSERT_EVAL1(...) LIBASSERT_EVAL0(LIBASSERT_EVAL0(LIBASSERT_EVAL0(__VA_ARGS__)))
+ #define LIBASSERT_EVAL2(...) LIBASSERT_EVAL1(LIBASSERT_EVAL1(LIBASSERT_EVAL1(__VA_ARGS__)))
+ #define LIBASSERT_EVAL3(...) LIBASSERT_EVAL2(LIBASSERT_EVAL2(LIBASSERT_EVAL2(__VA_ARGS__)))
+ #define LIBASSERT_EVAL4(...) LIBASSERT_EVAL3(LIBASSERT_EVAL3(LIBASSERT_EVAL3(__VA_ARGS__)))
+ #define LIBASSERT_EVAL(...) LIBASSERT_EVAL4(LIBASSERT_EVAL4(LIBASSERT_EVAL4(__VA_ARGS__)))
+ #define LIBASSERT_EXPAND(x) x
+ #define LIBASSERT_MAP_SWITCH(...)\
+     LIBASSERT_EXPAND(LIBASSERT_ARG_40(__VA_ARGS__, 2, 2, 2, 2, 2, 2, 2, 2, 2,\
+             2, 2, 2, 2, 2, 2, 2, 2, 2, 2,\
+             2, 2, 2, 2, 2, 2, 2, 2, 2,\
+             2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0))
+ #define LIBASSERT_MAP_A(...) LIBASSERT_PLUS_TEXT(LIBASSERT_MAP_NEXT_, \
+                                            LIBASSERT_MAP_SWITCH(0, __VA_ARGS__)) (LIBASSERT_MAP_B, __VA_ARGS__)
+ #define LIBASSERT_MAP_B(...) LIBASSERT_PLUS_TEXT(LIBASSERT_MAP_NEXT_, \
+                                            LIBASSERT_MAP_SWITCH(0, __VA_ARGS__)) (LIBASSERT_MAP_A, __VA_ARGS__)
+ #define LIBASSERT_MAP_CALL(fn, Value) LIBASSERT_EXPAND(fn(Value))
+ #define LIBASSERT_MAP_OUT
+ #define LIBASSERT_MAP_NEXT_2(...)\
+     LIBASSERT_MAP_CALL(LIBASSERT_EXPAND(LIBASSERT_ARG_2(__VA_ARGS__)), \
+     LIBASSERT_EXPAND(LIBASSERT_ARG_3(__VA_ARGS__))) \
+     LIBASSERT_EXPAND(LIBASSERT_ARG_1(__VA_ARGS__)) \
+     LIBASSERT_MAP_OUT \
+     (LIBASSERT_EXPAND(LIBASSERT_ARG_2(__VA_ARGS__)), LIBASSERT_EXPAND(LIBASSERT_OTHER_3(__VA_ARGS__)))
+ #define LIBASSERT_MAP_NEXT_0(...)
+ #define LIBASSERT_MAP(...)    LIBASSERT_EVAL(LIBASSERT_MAP_A(__VA_ARGS__))
+#endif
+
+#define LIBASSERT_STRINGIFY(x) #x,
+#define LIBASSERT_COMMA ,
+
+// Church boolean
+#define LIBASSERT_IF(b) LIBASSERT_IF_##b
+#define LIBASSERT_IF_true(t,...) t
+#define LIBASSERT_IF_false(t,f,...) f
+
+#if LIBASSERT_IS_CLANG || LIBASSERT_IS_GCC
+ #if LIBASSERT_IS_GCC
+  #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_GCC \
+     _Pragma("GCC diagnostic ignored \"-Wparentheses\"") \
+     _Pragma("GCC diagnostic ignored \"-Wuseless-cast\"") // #49
+  #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_CLANG
+  #define LIBASSERT_WARNING_PRAGMA_PUSH_GCC _Pragma("GCC diagnostic push")
+  #define LIBASSERT_WARNING_PRAGMA_POP_GCC _Pragma("GCC diagnostic pop")
+  #define LIBASSERT_WARNING_PRAGMA_PUSH_CLANG
+  #define LIBASSERT_WARNING_PRAGMA_POP_CLANG
+ #else
+  #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_CLANG \
+     _Pragma("GCC diagnostic ignored \"-Wparentheses\"") \
+     _Pragma("GCC diagnostic ignored \"-Woverloaded-shift-op-parentheses\"")
+  #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_GCC
+  #define LIBASSERT_WARNING_PRAGMA_PUSH_GCC
+  #define LIBASSERT_WARNING_PRAGMA_POP_GCC
+  #define LIBASSERT_WARNING_PRAGMA_PUSH_CLANG _Pragma("GCC diagnostic push")
+  #define LIBASSERT_WARNING_PRAGMA_POP_CLANG _Pragma("GCC diagnostic pop")
+ #endif
+#else
+ #define LIBASSERT_WARNING_PRAGMA_PUSH_CLANG
+ #define LIBASSERT_WARNING_PRAGMA_POP_CLANG
+ #define LIBASSERT_WARNING_PRAGMA_PUSH_GCC
+ #define LIBASSERT_WARNING_PRAGMA_POP_GCC
+ #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_GCC
+ #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_CLANG
+#endif
+
+// The leading "\0" separates each arg string from the expression and the previous arg string
+#define LIBASSERT_STRINGIFY_SITE_ARG(x) "\0" #x
+
+// With LIBASSERT_FUNCTION_FROM_TRACE sites don't embed their signature, the function is looked up in the trace when an
+// assertion fails
+#if defined(LIBASSERT_FUNCTION_FROM_TRACE) || defined(LIBASSERT_STRIP_SITE_STRINGS)
+ #define LIBASSERT_SITE_PFUNC nullptr
+#else
+ #define LIBASSERT_SITE_PFUNC LIBASSERT_PFUNC
+#endif
+
+#if LIBASSERT_IS_CLANG // -Wall in clang
+ #define LIBASSERT_IGNORE_UNUSED_VALUE _Pragma("GCC diagnostic ignored \"-Wunused-value\"")
+#else
+ #define LIBASSERT_IGNORE_UNUSED_VALUE
+#endif
+
+#define LIBASSERT_BREAKPOINT_IF_DEBUGGING() \
+    do \
+        if(libassert::is_debugger_present()) { \
+            LIBASSERT_BREAKPOINT(); \
+        } \
+    while(0)
+
+#ifdef LIBASSERT_BREAK_ON_FAIL
+ #define LIBASSERT_BREAKPOINT_IF_DEBUGGING_ON_FAIL() LIBASSERT_BREAKPOINT_IF_DEBUGGING()
+#else
+ #define LIBASSERT_BREAKPOINT_IF_DEBUGGING_ON_FAIL()
+#endif
+
+#ifdef NDEBUG
+ #define LIBASSERT_ASSUME_ACTION LIBASSERT_UNREACHABLE_CALL;
+#else
+ #define LIBASSERT_ASSUME_ACTION
+#endif
+
+// Same decomposition as LIBASSERT_INVOKE, the failure path only gets the site's strings as one literal
+#define LIBASSERT_FWD_INVOKE(expr, name, type, failaction, ...) \
+    do { \
+        LIBASSERT_WARNING_PRAGMA_PUSH_CLANG \
+        LIBASSERT_IGNORE_UNUSED_VALUE \
+        LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_CLANG \
+        LIBASSERT_WARNING_PRAGMA_PUSH_GCC \
+        LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_GCC \
+        auto libassert_decomposer = libassert::detail::expression_decomposer( \
+            libassert::detail::expression_decomposer{} << expr \
+        ); \
+        LIBASSERT_WARNING_PRAGMA_POP_GCC \
+        if(LIBASSERT_STRONG_EXPECT(!static_cast<bool>(libassert_decomposer.get_value()), 0)) { \
+            libassert::ERROR_ASSERTION_FAILURE_IN_CONSTEXPR_CONTEXT(); \
+            LIBASSERT_BREAKPOINT_IF_DEBUGGING_ON_FAIL(); \
+            failaction \
+            libassert::detail::fwd_process_assert_fail( \
+                libassert_decomposer, \
+                libassert::detail::fwd_site{ \
+                    name, \
+                    libassert::assert_type::type, \
+                    libassert::detail::site_strings( \
+                        #expr LIBASSERT_MAP(LIBASSERT_STRINGIFY_SITE_ARG LIBASSERT_VA_ARGS(__VA_ARGS__)) \
+                    ), \
+                    libassert::source_location{} \
+                }, \
+                LIBASSERT_SITE_PFUNC \
+                LIBASSERT_VA_ARGS(__VA_ARGS__) \
+            ); \
+        } \
+        LIBASSERT_WARNING_PRAGMA_POP_CLANG \
+    } while(false)
+
+#define LIBASSERT_FWD_INVOKE_PANIC(name, type, ...) \
+    do { \
+        libassert::ERROR_ASSERTION_FAILURE_IN_CONSTEXPR_CONTEXT(); \
+        LIBASSERT_BREAKPOINT_IF_DEBUGGING_ON_FAIL(); \
+        libassert::detail::fwd_process_panic( \
+            libassert::detail::fwd_site{ \
+                name, \
+                libassert::assert_type::type, \
+                libassert::detail::site_strings("" LIBASSERT_MAP(LIBASSERT_STRINGIFY_SITE_ARG LIBASSERT_VA_ARGS(__VA_ARGS__))), \
+                libassert::source_location{} \
+            }, \
+            LIBASSERT_SITE_PFUNC \
+            LIBASSERT_VA_ARGS(__VA_ARGS__) \
+        ); \
+    } while(false)
+
+// The macros are only defined here if <libassert/assert.hpp> hasn't been included, it replaces them if it's included
+// later
+#ifndef LIBASSERT_HPP
+ #define LIBASSERT_FWD_MACROS
+
+ #ifndef NDEBUG
+  #define LIBASSERT_DEBUG_ASSERT(expr, ...) LIBASSERT_FWD_INVOKE(expr, "DEBUG_ASSERT", debug_assertion, , __VA_ARGS__)
+ #else
+  #define LIBASSERT_DEBUG_ASSERT(expr, ...) (void)0
+ #endif
+
+ #define LIBASSERT_ASSERT(expr, ...) LIBASSERT_FWD_INVOKE(expr, "ASSERT", assertion, , __VA_ARGS__)
+
+ #define LIBASSERT_ASSUME(expr, ...) \
+    LIBASSERT_FWD_INVOKE(expr, "ASSUME", assumption, LIBASSERT_ASSUME_ACTION, __VA_ARGS__)
+
+ #define LIBASSERT_PANIC(...) LIBASSERT_FWD_INVOKE_PANIC("PANIC", panic, __VA_ARGS__)
+
+ #ifndef NDEBUG
+  #define LIBASSERT_UNREACHABLE(...) LIBASSERT_FWD_INVOKE_PANIC("UNREACHABLE", unreachable, __VA_ARGS__)
+ #else
+  #define LIBASSERT_UNREACHABLE(...) LIBASSERT_UNREACHABLE_CALL
+ #endif
+
+ #ifndef LIBASSERT_PREFIX_ASSERTIONS
+  #if LIBASSERT_IS_CLANG || LIBASSERT_IS_GCC || !LIBASSERT_NON_CONFORMANT_MSVC_PREPROCESSOR
+   #define DEBUG_ASSERT(...) LIBASSERT_DEBUG_ASSERT(__VA_ARGS__)
+   #define ASSERT(...) LIBASSERT_ASSERT(__VA_ARGS__)
+   #define ASSUME(...) LIBASSERT_ASSUME(__VA_ARGS__)
+   #define PANIC(...) LIBASSERT_PANIC(__VA_ARGS__)
+   #define UNREACHABLE(...) LIBASSERT_UNREACHABLE(__VA_ARGS__)
+  #else
+   // because of course msvc
+   #define DEBUG_ASSERT LIBASSERT_DEBUG_ASSERT
+   #define ASSERT LIBASSERT_ASSERT
+   #define ASSUME LIBASSERT_ASSUME
+   #define PANIC LIBASSERT_PANIC
+   #define UNREACHABLE LIBASSERT_UNREACHABLE
+  #endif
+ #endif
+#endif
+
+#endif
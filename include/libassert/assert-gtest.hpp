@@ -1,6 +1,9 @@
 #ifndef LIBASSERT_GTEST_HPP
 #define LIBASSERT_GTEST_HPP
 
+#include <cstdlib>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #define LIBASSERT_PREFIX_ASSERTIONS
@@ -9,8 +12,35 @@
 #if defined(_MSVC_TRADITIONAL) && _MSVC_TRADITIONAL != 0
  #error "Libassert integration does not work with MSVC's non-conformant preprocessor. /Zc:preprocessor must be used."
 #endif
-#define ASSERT(...) do { try { LIBASSERT_ASSERT(__VA_ARGS__); SUCCEED(); } catch(std::exception& e) { FAIL() << e.what(); } } while(false)
-#define EXPECT(...) do { try { LIBASSERT_ASSERT(__VA_ARGS__); SUCCEED(); } catch(std::exception& e) { ADD_FAILURE() << e.what(); } } while(false)
+
+namespace libassert::detail {
+    enum class gtest_wrapper_kind { none, fatal, nonfatal };
+    // set by the ASSERT/EXPECT wrappers on their failure path, tells the failure handler how to report the failure
+    inline thread_local gtest_wrapper_kind gtest_current_wrapper = gtest_wrapper_kind::none;
+}
+
+// The failure is reported to gtest by the failure handler, no exceptions involved. ASSERT then returns from the test
+// body the same way gtest's ASSERT_* macros do. Passing checks aren't recorded with gtest, the passing path is just the
+// condition branch.
+#define LIBASSERT_GTEST_INVOKE(kind, name, onfail, expr, ...) \
+    do { \
+        bool libassert_gtest_failed = false; \
+        LIBASSERT_INVOKE( \
+            expr, \
+            name, \
+            assertion, \
+            libassert_gtest_failed = true; \
+            libassert::detail::gtest_current_wrapper = libassert::detail::gtest_wrapper_kind::kind;, \
+            __VA_ARGS__ \
+        ); \
+        if(libassert_gtest_failed) { \
+            libassert::detail::gtest_current_wrapper = libassert::detail::gtest_wrapper_kind::none; \
+            onfail \
+        } \
+    } while(false)
+
+#define ASSERT(expr, ...) LIBASSERT_GTEST_INVOKE(fatal, "ASSERT", return;, expr, __VA_ARGS__)
+#define EXPECT(expr, ...) LIBASSERT_GTEST_INVOKE(nonfatal, "EXPECT", , expr, __VA_ARGS__)
 
 namespace libassert::detail {
     inline void gtest_failure_handler(const assertion_info& info) {
@@ -22,10 +52,27 @@ namespace libassert::detail {
             message += " " + *info.message;
         }
         message += "\n";
-        message += info.statement()
+        message += info.statement(scheme)
                 + info.print_binary_diagnostics(width, scheme)
                 + info.print_extra_diagnostics(width, scheme);
-        throw std::runtime_error(std::move(message));
+        const auto wrapper = gtest_current_wrapper;
+        const auto type = wrapper == gtest_wrapper_kind::nonfatal
+            ? ::testing::TestPartResult::kNonFatalFailure
+            : ::testing::TestPartResult::kFatalFailure;
+        const std::string file(info.file_name);
+        const int line = static_cast<int>(info.line);
+        ::testing::internal::AssertHelper(type, file.c_str(), line, message.c_str()) = ::testing::Message();
+        if(wrapper == gtest_wrapper_kind::none) {
+            // Failure from outside the wrappers, e.g. in code under test. There's no test body to return from here so
+            // unwind to gtest if possible, gtest knows this failure was already reported.
+            #if GTEST_HAS_EXCEPTIONS
+             throw ::testing::AssertionException(::testing::TestPartResult(type, file.c_str(), line, message.c_str()));
+            #else
+             if(info.type == assert_type::panic || info.type == assert_type::unreachable) {
+                 std::abort();
+             }
+            #endif
+        }
     }
 
     inline auto pre_main = [] () {
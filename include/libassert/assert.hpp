@@ -4,7 +4,9 @@
 // Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
 // https://github.com/jeremy-rifkin/libassert
 
+#include <array>
 #include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -24,8 +26,37 @@
 #include <libassert/utilities.hpp>
 #include <libassert/stringification.hpp>
 #include <libassert/expression-decomposition.hpp>
+#include <libassert/assert-fwd.hpp>
 
-#if defined(__has_include) && __has_include(<cpptrace/basic.hpp>)
+#if defined(LIBASSERT_SITE_COUNTERS) || defined(LIBASSERT_SITE_COST_SAMPLING)
+ #include <libassert/site-counters.hpp>
+#else
+ #define LIBASSERT_COUNT_EVALUATION(check, name, expr_str)
+ #define LIBASSERT_COUNT_FAILURE()
+ #define LIBASSERT_BEGIN_COST_SAMPLE()
+ #define LIBASSERT_END_COST_SAMPLE(value) value
+#endif
+
+#ifdef LIBASSERT_SITE_POLICY_HEADER
+ #include <libassert/site-policy.hpp>
+#endif
+
+#ifdef LIBASSERT_STRIP_SITE_STRINGS
+ #include <libassert/site-map.hpp>
+ #if defined(LIBASSERT_SITE_COUNTERS) || defined(LIBASSERT_SITE_COST_SAMPLING)
+  #error "LIBASSERT_STRIP_SITE_STRINGS can't be combined with site counters, they keep every site's strings"
+ #endif
+#endif
+
+#if defined(LIBASSERT_STACKTRACE_BACKEND_NONE) && defined(LIBASSERT_STACKTRACE_BACKEND_STDLIB)
+ #error "Only one of LIBASSERT_STACKTRACE_BACKEND_NONE and LIBASSERT_STACKTRACE_BACKEND_STDLIB may be defined"
+#endif
+
+#if defined(LIBASSERT_STACKTRACE_BACKEND_NONE)
+ // no stack traces
+#elif defined(LIBASSERT_STACKTRACE_BACKEND_STDLIB)
+ #include <stacktrace>
+#elif defined(__has_include) && __has_include(<cpptrace/basic.hpp>)
  #include <cpptrace/basic.hpp>
 #else
  #include <cpptrace/cpptrace.hpp>
@@ -60,7 +91,6 @@ namespace libassert {
 
     LIBASSERT_ATTR_COLD LIBASSERT_EXPORT bool isatty(int fd);
 
-    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT bool is_debugger_present() noexcept;
     enum class debugger_check_mode {
         check_once,
         check_every_time,
@@ -113,7 +143,22 @@ namespace libassert {
     // note: not thread-safe
     LIBASSERT_EXPORT void set_separator(std::string_view separator);
 
-    // generates a stack trace, formats to the given width
+    // The stack trace backend is chosen with the LIBASSERT_STACKTRACE_BACKEND CMake option: cpptrace by default,
+    // C++23's <stacktrace>, or none
+    #if defined(LIBASSERT_STACKTRACE_BACKEND_NONE)
+    struct empty_trace {};
+    using raw_trace_type = empty_trace;
+    using stacktrace_type = empty_trace;
+    #elif defined(LIBASSERT_STACKTRACE_BACKEND_STDLIB)
+    // std::stacktrace only symbolizes entries when they're inspected so there is no separate raw trace
+    using raw_trace_type = std::stacktrace;
+    using stacktrace_type = std::stacktrace;
+    #else
+    using raw_trace_type = cpptrace::raw_trace;
+    using stacktrace_type = cpptrace::stacktrace;
+    #endif
+
+    // generates a stack trace, formats to the given width, empty without a stack trace backend
     [[nodiscard]] LIBASSERT_ATTR_NOINLINE LIBASSERT_EXPORT
     std::string stacktrace(int width = 0, const color_scheme& scheme = get_color_scheme(), std::size_t skip = 0);
 
@@ -159,20 +204,52 @@ namespace libassert {
     };
     LIBASSERT_EXPORT void set_path_mode(path_mode mode);
 
-    enum class assert_type {
-        debug_assertion,
-        assertion,
-        assumption,
-        panic,
-        unreachable
-    };
-
     struct assertion_info;
+    class assertion_failure;
 
     [[noreturn]] LIBASSERT_EXPORT void default_failure_handler(const assertion_info& info);
 
     LIBASSERT_EXPORT void set_failure_handler(void (*handler)(const assertion_info&));
 
+    // Opt-in aggregation of failures by assertion site, intended for long runs with a non-fatal failure handler. While
+    // enabled only the first failure of each assertion goes through the failure handler, later failures just update the
+    // site's counters. Panics and unreachables are always reported.
+    LIBASSERT_EXPORT void enable_failure_summary(bool print_at_exit = true);
+    LIBASSERT_EXPORT void disable_failure_summary();
+    LIBASSERT_EXPORT void reset_failure_summary();
+    // table of failing sites sorted by failure count followed by the first report of each site
+    [[nodiscard]] LIBASSERT_EXPORT std::string failure_summary(const color_scheme& scheme = color_scheme::blank);
+    LIBASSERT_EXPORT void print_failure_summary();
+
+    // stages of processing and reporting a failure, each phase's time excludes the phases nested inside of it
+    enum class failure_phase {
+        trace_capture, // generating the raw stack trace
+        stringification, // the message, extra diagnostics, and operands
+        decomposition, // splitting the expression string into operand expressions
+        symbolization, // resolving the stack trace
+        type_prettification,
+        highlighting,
+        layout, // building the report
+        output // writing the report in the default failure handler
+    };
+    inline constexpr std::size_t failure_phase_count = 8;
+
+    struct phase_timing {
+        std::uint64_t calls = 0;
+        std::chrono::nanoseconds time{0};
+    };
+
+    // Opt-in timing of the phases of the failure path. Can also be enabled by setting the LIBASSERT_PHASE_TIMING
+    // environment variable to anything other than 0, in which case the summary is printed at exit.
+    LIBASSERT_EXPORT void enable_phase_timing(bool print_at_exit = true);
+    LIBASSERT_EXPORT void disable_phase_timing();
+    LIBASSERT_EXPORT void reset_phase_timings();
+    // accumulated over all threads, indexed by failure_phase
+    [[nodiscard]] LIBASSERT_EXPORT std::array<phase_timing, failure_phase_count> phase_timings();
+    [[nodiscard]] LIBASSERT_EXPORT std::string_view phase_name(failure_phase phase);
+    [[nodiscard]] LIBASSERT_EXPORT std::string phase_timing_summary(const color_scheme& scheme = color_scheme::blank);
+    LIBASSERT_EXPORT void print_phase_timing_summary();
+
     struct LIBASSERT_EXPORT binary_diagnostics_descriptor {
         std::string left_expression;
         std::string right_expression;
@@ -209,6 +286,24 @@ namespace libassert {
             source_location location;
             sv_span args_strings;
         };
+
+        // With LIBASSERT_COMPACT_STATIC_DATA a site only emits the expression and arg strings as a single literal,
+        // "expr\0arg1\0arg2", see site_strings, and passes it along with the macro name and location from code.
+        // Nothing in static storage points anywhere so PIE executables and shared libraries don't need a relocation
+        // per string. The assert_static_parameters are built the first time a site fails and are stable from then on.
+        LIBASSERT_ATTR_COLD [[nodiscard]] LIBASSERT_EXPORT const assert_static_parameters* decode_static_parameters(
+            const char* macro_name,
+            assert_type type,
+            std::string_view strings,
+            source_location location
+        );
+
+        // With LIBASSERT_STRIP_SITE_STRINGS only the site ID is left, see <libassert/site-map.hpp>
+        LIBASSERT_ATTR_COLD [[nodiscard]] LIBASSERT_EXPORT const assert_static_parameters* stripped_static_parameters(
+            std::uint64_t site_id,
+            assert_type type,
+            std::size_t n_args
+        );
     }
 
     struct extra_diagnostic {
@@ -239,14 +334,19 @@ namespace libassert {
         std::vector<extra_diagnostic> extra_diagnostics;
         size_t n_args;
     private:
+        #if defined(LIBASSERT_STACKTRACE_BACKEND_STDLIB)
+        std::stacktrace trace;
+        #elif !defined(LIBASSERT_STACKTRACE_BACKEND_NONE)
         mutable std::variant<cpptrace::raw_trace, cpptrace::stacktrace> trace; // lazy, resolved when needed
+        #endif
         mutable std::unique_ptr<detail::path_handler> path_handler;
         detail::path_handler* get_path_handler() const; // will get and setup the path handler
+        friend class assertion_failure;
     public:
         assertion_info() = delete;
         assertion_info(
             const detail::assert_static_parameters* static_params,
-            cpptrace::raw_trace&& raw_trace,
+            raw_trace_type&& raw_trace,
             size_t n_args
         );
         ~assertion_info();
@@ -257,8 +357,9 @@ namespace libassert {
 
         std::string_view action() const;
 
-        const cpptrace::raw_trace& get_raw_trace() const;
-        const cpptrace::stacktrace& get_stacktrace() const;
+        // empty traces without a stack trace backend
+        const raw_trace_type& get_raw_trace() const;
+        const stacktrace_type& get_stacktrace() const;
 
         [[nodiscard]] std::string header(int width = 0, const color_scheme& scheme = get_color_scheme()) const;
         [[nodiscard]] std::string tagline(const color_scheme& scheme = get_color_scheme()) const;
@@ -347,16 +448,33 @@ namespace libassert::detail {
     #undef LIBASSERT_X
 
     struct pretty_function_name_wrapper {
-        const char* pretty_function;
+        const char* pretty_function; // null with LIBASSERT_FUNCTION_FROM_TRACE
     };
 
+    // the signature of the first frame outside of libassert, or "<unknown>", with static storage duration
+    [[nodiscard]] LIBASSERT_EXPORT std::string_view function_from_trace(const raw_trace_type& trace);
+
+    LIBASSERT_ATTR_ALWAYS_INLINE raw_trace_type generate_raw_trace() {
+        #if defined(LIBASSERT_STACKTRACE_BACKEND_NONE)
+        return {};
+        #elif defined(LIBASSERT_STACKTRACE_BACKEND_STDLIB)
+        return std::stacktrace::current();
+        #else
+        return cpptrace::generate_raw_trace();
+        #endif
+    }
+
     inline void process_arg( // TODO: Don't inline
         assertion_info& info,
         size_t,
         sv_span,
         const pretty_function_name_wrapper& t
     ) {
-        info.function = t.pretty_function;
+        if(t.pretty_function) {
+            info.function = t.pretty_function;
+        } else {
+            info.function = function_from_trace(info.get_raw_trace());
+        }
     }
 
     template<typename T>
@@ -384,6 +502,40 @@ namespace libassert::detail {
         info.extra_diagnostics.push_back({ args_strings.data[i], generate_stringification(t) });
     }
 
+    // string literals go through the const char* instantiation instead of one per length
+    template<size_t N>
+    LIBASSERT_ATTR_COLD
+    void process_arg(assertion_info& info, size_t i, sv_span args_strings, const char (&t)[N]) { // NOLINT(*-avoid-c-arrays)
+        process_arg<const char*>(info, i, args_strings, t);
+    }
+
+    // see LIBASSERT_FOR_EACH_PREBUILT_TYPE, comparisons against a size and unary assertions on integers are common too
+    #define LIBASSERT_FOR_EACH_PREBUILT_MIXED_PAIR(X) \
+        X(unsigned long, int) X(unsigned long long, int) \
+        X(int, bool) X(long, bool) X(long long, bool) X(unsigned, bool) X(unsigned long, bool) X(unsigned long long, bool)
+
+    #define LIBASSERT_PROCESS_ARG_INSTANTIATION(extern_, T) \
+        extern_ template LIBASSERT_EXPORT void process_arg<T>(assertion_info&, size_t, sv_span, T const&);
+    #define LIBASSERT_BINARY_DIAGNOSTIC_INSTANTIATION(extern_, A, B) \
+        extern_ template LIBASSERT_EXPORT binary_diagnostics_descriptor generate_binary_diagnostic<A, B>( \
+            A const&, \
+            B const&, \
+            std::string_view, \
+            std::string_view, \
+            std::string_view \
+        );
+
+    #ifdef LIBASSERT_PREBUILT_STRINGIFICATION
+     #define LIBASSERT_X(T) \
+        LIBASSERT_PROCESS_ARG_INSTANTIATION(extern, T) \
+        LIBASSERT_BINARY_DIAGNOSTIC_INSTANTIATION(extern, T, T)
+     #define LIBASSERT_Y(A, B) LIBASSERT_BINARY_DIAGNOSTIC_INSTANTIATION(extern, A, B)
+     LIBASSERT_FOR_EACH_PREBUILT_TYPE(LIBASSERT_X)
+     LIBASSERT_FOR_EACH_PREBUILT_MIXED_PAIR(LIBASSERT_Y)
+     #undef LIBASSERT_X
+     #undef LIBASSERT_Y
+    #endif
+
     template<typename... Args>
     LIBASSERT_ATTR_COLD
     void process_args(assertion_info& info, sv_span args_strings, Args&... args) {
@@ -398,33 +550,110 @@ namespace libassert::detail {
  */
 
 namespace libassert::detail {
-    LIBASSERT_EXPORT void fail(const assertion_info& info);
+    LIBASSERT_EXPORT void fail(assertion_info& info);
+
+    // times a phase of the failure path while in scope if phase timing is enabled, the enclosing phase is paused
+    class LIBASSERT_EXPORT phase_timer {
+        failure_phase phase;
+        bool active = false;
+        phase_timer* parent = nullptr;
+        std::chrono::steady_clock::time_point start;
+    public:
+        explicit phase_timer(failure_phase phase);
+        ~phase_timer();
+        phase_timer(const phase_timer&) = delete;
+        phase_timer(phase_timer&&) = delete;
+        phase_timer& operator=(const phase_timer&) = delete;
+        phase_timer& operator=(phase_timer&&) = delete;
+    };
 
-    template<typename A, typename B, typename C, typename... Args>
-    LIBASSERT_ATTR_COLD LIBASSERT_ATTR_NOINLINE
-    // TODO: Re-evaluate forwarding here.
-    void process_assert_fail(
-        expression_decomposer<A, B, C>& decomposer,
+    enum class failure_disposition {
+        report, // summary disabled
+        report_first, // first failure of the site, report and record it
+        sample, // repeated failure, only the values are recorded for the distinct value count
+        count // repeated failure, nothing more to record
+    };
+
+    // failure summary bookkeeping, see enable_failure_summary
+    [[nodiscard]] LIBASSERT_EXPORT failure_disposition record_failure(const assert_static_parameters* params);
+    LIBASSERT_EXPORT void record_failure_values(
+        const assert_static_parameters* params,
+        const std::optional<binary_diagnostics_descriptor>& binary_diagnostics
+    );
+    LIBASSERT_EXPORT void record_first_failure(const assert_static_parameters* params, const assertion_info& info);
+
+    enum class collection_mode {
+        none, // no failure_collector active on this thread
+        without_trace,
+        with_trace // first failure of the site in the collector's batch
+    };
+
+    // failure_collector hooks, see <libassert/failure-collector.hpp>
+    [[nodiscard]] LIBASSERT_EXPORT collection_mode get_collection_mode(const assert_static_parameters* params);
+    LIBASSERT_EXPORT void collect_failure(assertion_info& info, const assert_static_parameters* params);
+
+    // The failure path shared by every assertion: the failure summary and failure_collector bookkeeping, then the trace,
+    // the report, and the failure handler. The site's disposition is decided before anything expensive is done, a
+    // repeated failure only calls sample_values for the values the summary records. fill_info fills in the message and
+    // the diagnostics of a reported failure. Returns if the failure was only counted or collected or if the failure
+    // handler returns.
+    template<typename S, typename F>
+    LIBASSERT_ATTR_COLD
+    void process_failure(
         const assert_static_parameters* params,
+        size_t n_args,
         // NOLINTNEXTLINE(cppcoreguidelines-missing-std-forward)
-        Args&&... args
+        S&& sample_values,
+        // NOLINTNEXTLINE(cppcoreguidelines-missing-std-forward)
+        F&& fill_info
+    ) {
+        const auto collection = get_collection_mode(params);
+        auto disposition = failure_disposition::report;
+        if(collection == collection_mode::none) {
+            disposition = record_failure(params);
+            if(disposition == failure_disposition::count) {
+                return;
+            } else if(disposition == failure_disposition::sample) {
+                phase_timer timer(failure_phase::stringification);
+                record_failure_values(params, sample_values());
+                return;
+            }
+        }
+        raw_trace_type raw_trace;
+        if(collection != collection_mode::without_trace) {
+            phase_timer timer(failure_phase::trace_capture);
+            raw_trace = generate_raw_trace();
+        }
+        assertion_info info(params, std::move(raw_trace), n_args);
+        {
+            phase_timer timer(failure_phase::stringification);
+            fill_info(info);
+        }
+        if(collection != collection_mode::none) {
+            collect_failure(info, params);
+            return;
+        }
+        if(disposition == failure_disposition::report_first) {
+            record_first_failure(params, info);
+        }
+        // send off
+        fail(info);
+    }
+
+    template<typename A, typename B, typename C>
+    LIBASSERT_ATTR_COLD
+    std::optional<binary_diagnostics_descriptor> generate_binary_diagnostics(
+        expression_decomposer<A, B, C>& decomposer,
+        const assert_static_parameters* params
     ) {
-        const size_t sizeof_extra_diagnostics = sizeof...(args) - 1; // - 1 for pretty function signature
-        LIBASSERT_PRIMITIVE_DEBUG_ASSERT(sizeof...(args) <= params->args_strings.size);
-        assertion_info info(
-            params,
-            cpptrace::generate_raw_trace(),
-            sizeof_extra_diagnostics
-        );
-        // process_args fills in the message, extra_diagnostics, and pretty_function
-        process_args(info, params->args_strings, args...);
-        // generate binary diagnostics
         if constexpr(is_nothing<C>) {
             static_assert(is_nothing<B> && !is_nothing<A>);
             if constexpr(isa<A, bool>) {
                 (void)decomposer; // suppress warning in msvc
+                (void)params;
+                return std::nullopt;
             } else {
-                info.binary_diagnostics = generate_binary_diagnostic(
+                return generate_binary_diagnostic(
                     decomposer.a,
                     true,
                     params->expr_str,
@@ -434,7 +663,7 @@ namespace libassert::detail {
             }
         } else {
             auto [left_expression, right_expression] = decompose_expression(params->expr_str, C::op_string);
-            info.binary_diagnostics = generate_binary_diagnostic(
+            return generate_binary_diagnostic(
                 decomposer.a,
                 decomposer.b,
                 left_expression,
@@ -442,8 +671,30 @@ namespace libassert::detail {
                 C::op_string
             );
         }
-        // send off
-        fail(info);
+    }
+
+    template<typename A, typename B, typename C, typename... Args>
+    LIBASSERT_ATTR_COLD LIBASSERT_ATTR_NOINLINE
+    // TODO: Re-evaluate forwarding here.
+    void process_assert_fail(
+        expression_decomposer<A, B, C>& decomposer,
+        const assert_static_parameters* params,
+        // NOLINTNEXTLINE(cppcoreguidelines-missing-std-forward)
+        Args&&... args
+    ) {
+        const size_t sizeof_extra_diagnostics = sizeof...(args) - 1; // - 1 for pretty function signature
+        LIBASSERT_PRIMITIVE_DEBUG_ASSERT(sizeof...(args) <= params->args_strings.size);
+        process_failure(
+            params,
+            sizeof_extra_diagnostics,
+            [&] { return generate_binary_diagnostics(decomposer, params); },
+            [&] (assertion_info& info) {
+                // process_args fills in the message, extra_diagnostics, and pretty_function
+                process_args(info, params->args_strings, args...);
+                // generate binary diagnostics
+                info.binary_diagnostics = generate_binary_diagnostics(decomposer, params);
+            }
+        );
     }
 
     template<typename... Args>
@@ -456,13 +707,17 @@ namespace libassert::detail {
     ) {
         const size_t sizeof_extra_diagnostics = sizeof...(args) - 1; // - 1 for pretty function signature
         LIBASSERT_PRIMITIVE_DEBUG_ASSERT(sizeof...(args) <= params->args_strings.size);
-        assertion_info info(
-            params,
-            cpptrace::generate_raw_trace(),
-            sizeof_extra_diagnostics
-        );
-        // process_args fills in the message, extra_diagnostics, and pretty_function
-        process_args(info, params->args_strings, args...);
+        raw_trace_type raw_trace;
+        {
+            phase_timer timer(failure_phase::trace_capture);
+            raw_trace = generate_raw_trace();
+        }
+        assertion_info info(params, std::move(raw_trace), sizeof_extra_diagnostics);
+        {
+            phase_timer timer(failure_phase::stringification);
+            // process_args fills in the message, extra_diagnostics, and pretty_function
+            process_args(info, params->args_strings, args...);
+        }
         // send off
         fail(info);
         LIBASSERT_PRIMITIVE_PANIC("PANIC/UNREACHABLE failure handler returned");
@@ -490,6 +745,42 @@ namespace libassert::detail {
         process_assert_fail(decomposer, params, std::forward<Args>(args)...);
     }
 
+    // only decomposers which may have been moved out of and recreated on the failure path need to be laundered
+    template<typename A, typename B, typename C>
+    constexpr expression_decomposer<A, B, C>* launder_decomposer(expression_decomposer<A, B, C>* decomposer) {
+        if constexpr(has_trivial_operands<expression_decomposer<A, B, C>> || sizeof(*decomposer) > 32) {
+            return decomposer;
+        } else {
+            return std::launder(decomposer);
+        }
+    }
+
+    // extra diagnostics are passed on like the operands, small trivially copyable types by value and everything else by
+    // reference
+    template<typename T>
+    LIBASSERT_ATTR_ALWAYS_INLINE constexpr decltype(auto) pass_extra_diagnostic(T&& t) {
+        if constexpr(is_trivial_operand<T>) {
+            return std::remove_cv_t<std::remove_reference_t<T>>(t);
+        } else {
+            return std::forward<T>(t);
+        }
+    }
+
+    // inlined into the failure branch so the noinline failure path only receives copies of trivial operands
+    template<typename A, typename B, typename C, typename... Args>
+    LIBASSERT_ATTR_ALWAYS_INLINE
+    void process_assert_fail_trivial(
+        const expression_decomposer<A, B, C>& decomposer,
+        const assert_static_parameters* params,
+        Args&&... args
+    ) {
+        process_assert_fail_n(
+            copy_trivial_operands(decomposer),
+            params,
+            pass_extra_diagnostic(std::forward<Args>(args))...
+        );
+    }
+
     template<typename T>
     struct assert_value_wrapper {
         T value;
@@ -522,124 +813,40 @@ namespace libassert::detail {
  #pragma warning(pop)
 #endif
 
-#if LIBASSERT_IS_CLANG || LIBASSERT_IS_GCC || !LIBASSERT_NON_CONFORMANT_MSVC_PREPROCESSOR
- // Macro mapping utility by William Swanson https://github.com/swansontec/map-macro/blob/master/map.h
- #define LIBASSERT_EVAL0(...) __VA_ARGS__
- #define LIBASSERT_EVAL1(...) LIBASSERT_EVAL0(LIBASSERT_EVAL0(LIBASSERT_EVAL0(__VA_ARGS__)))
- #define LIBASSERT_EVAL2(...) LIBASSERT_EVAL1(LIBASSERT_EVAL1(LIBASSERT_EVAL1(__VA_ARGS__)))
- #define LIBASSERT_EVAL3(...) LIBASSERT_EVAL2(LIBASSERT_EVAL2(LIBASSERT_EVAL2(__VA_ARGS__)))
- #define LIBASSERT_EVAL4(...) LIBASSERT_EVAL3(LIBASSERT_EVAL3(LIBASSERT_EVAL3(__VA_ARGS__)))
- #define LIBASSERT_EVAL(...)  LIBASSERT_EVAL4(LIBASSERT_EVAL4(LIBASSERT_EVAL4(__VA_ARGS__)))
- #define LIBASSERT_MAP_END(...)
- #define LIBASSERT_MAP_OUT
- #define LIBASSERT_MAP_COMMA ,
- #define LIBASSERT_MAP_GET_END2() 0, LIBASSERT_MAP_END
- #define LIBASSERT_MAP_GET_END1(...) LIBASSERT_MAP_GET_END2
- #define LIBASSERT_MAP_GET_END(...) LIBASSERT_MAP_GET_END1
- #define LIBASSERT_MAP_NEXT0(test, next, ...) next LIBASSERT_MAP_OUT
- #define LIBASSERT_MAP_NEXT1(test, next) LIBASSERT_MAP_NEXT0(test, next, 0)
- #define LIBASSERT_MAP_NEXT(test, next)  LIBASSERT_MAP_NEXT1(LIBASSERT_MAP_GET_END test, next)
- #define LIBASSERT_MAP0(f, x, peek, ...) f(x) LIBASSERT_MAP_NEXT(peek, LIBASSERT_MAP1)(f, peek, __VA_ARGS__)
- #define LIBASSERT_MAP1(f, x, peek, ...) f(x) LIBASSERT_MAP_NEXT(peek, LIBASSERT_MAP0)(f, peek, __VA_ARGS__)
- #define LIBASSERT_MAP_LIST_NEXT1(test, next) LIBASSERT_MAP_NEXT0(test, LIBASSERT_MAP_COMMA next, 0)
- #define LIBASSERT_MAP_LIST_NEXT(test, next)  LIBASSERT_MAP_LIST_NEXT1(LIBASSERT_MAP_GET_END test, next)
- #define LIBASSERT_MAP_LIST0(f, x, peek, ...) \
-                                   f(x) LIBASSERT_MAP_LIST_NEXT(peek, LIBASSERT_MAP_LIST1)(f, peek, __VA_ARGS__)
- #define LIBASSERT_MAP_LIST1(f, x, peek, ...) \
-                                   f(x) LIBASSERT_MAP_LIST_NEXT(peek, LIBASSERT_MAP_LIST0)(f, peek, __VA_ARGS__)
- #define LIBASSERT_MAP(f, ...) LIBASSERT_EVAL(LIBASSERT_MAP1(f, __VA_ARGS__, ()()(), ()()(), ()()(), 0))
-#else
- // https://stackoverflow.com/a/29474124/15675011
- #define LIBASSERT_PLUS_TEXT_(x,y) x ## y
- #define LIBASSERT_PLUS_TEXT(x, y) LIBASSERT_PLUS_TEXT_(x, y)
- #define LIBASSERT_ARG_1(_1, ...) _1
- #define LIBASSERT_ARG_2(_1, _2, ...) _2
- #define LIBASSERT_ARG_3(_1, _2, _3, ...) _3
- #define LIBASSERT_ARG_40( _0, _1, _2, _3, _4, _5, _6, _7, _8, _9, \
-                 _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, \
-                 _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, \
-                 _30, _31, _32, _33, _34, _35, _36, _37, _38, _39, \
-                 ...) _39
- #define LIBASSERT_OTHER_1(_1, ...) __VA_ARGS__
- #define LIBASSERT_OTHER_3(_1, _2, _3, ...) __VA_ARGS__
- #define LIBASSERT_EVAL0(...) __VA_ARGS__
- #define LIBASSERT_EVAL1(...) LIBASSERT_EVAL0(LIBASSERT_EVAL0(LIBASSERT_EVAL0(__VA_ARGS__)))
- #define LIBASSERT_EVAL2(...) LIBASSERT_EVAL1(LIBASSERT_EVAL1(LIBASSERT_EVAL1(__VA_ARGS__)))
- #define LIBASSERT_EVAL3(...) LIBASSERT_EVAL2(LIBASSERT_EVAL2(LIBASSERT_EVAL2(__VA_ARGS__)))
- #define LIBASSERT_EVAL4(...) LIBASSERT_EVAL3(LIBASSERT_EVAL3(LIBASSERT_EVAL3(__VA_ARGS__)))
- #define LIBASSERT_EVAL(...) LIBASSERT_EVAL4(LIBASSERT_EVAL4(LIBASSERT_EVAL4(__VA_ARGS__)))
- #define LIBASSERT_EXPAND(x) x
- #define LIBASSERT_MAP_SWITCH(...)\
-     LIBASSERT_EXPAND(LIBASSERT_ARG_40(__VA_ARGS__, 2, 2, 2, 2, 2, 2, 2, 2, 2,\
-             2, 2, 2, 2, 2, 2, 2, 2, 2, 2,\
-             2, 2, 2, 2, 2, 2, 2, 2, 2,\
-             2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0))
- #define LIBASSERT_MAP_A(...) LIBASSERT_PLUS_TEXT(LIBASSERT_MAP_NEXT_, \
-                                            LIBASSERT_MAP_SWITCH(0, __VA_ARGS__)) (LIBASSERT_MAP_B, __VA_ARGS__)
- #define LIBASSERT_MAP_B(...) LIBASSERT_PLUS_TEXT(LIBASSERT_MAP_NEXT_, \
-                                            LIBASSERT_MAP_SWITCH(0, __VA_ARGS__)) (LIBASSERT_MAP_A, __VA_ARGS__)
- #define LIBASSERT_MAP_CALL(fn, Value) LIBASSERT_EXPAND(fn(Value))
- #define LIBASSERT_MAP_OUT
- #define LIBASSERT_MAP_NEXT_2(...)\
-     LIBASSERT_MAP_CALL(LIBASSERT_EXPAND(LIBASSERT_ARG_2(__VA_ARGS__)), \
-     LIBASSERT_EXPAND(LIBASSERT_ARG_3(__VA_ARGS__))) \
-     LIBASSERT_EXPAND(LIBASSERT_ARG_1(__VA_ARGS__)) \
-     LIBASSERT_MAP_OUT \
-     (LIBASSERT_EXPAND(LIBASSERT_ARG_2(__VA_ARGS__)), LIBASSERT_EXPAND(LIBASSERT_OTHER_3(__VA_ARGS__)))
- #define LIBASSERT_MAP_NEXT_0(...)
- #define LIBASSERT_MAP(...)    LIBASSERT_EVAL(LIBASSERT_MAP_A(__VA_ARGS__))
-#endif
-
-#define LIBASSERT_STRINGIFY(x) #x,
-#define LIBASSERT_COMMA ,
-
-// Church boolean
-#define LIBASSERT_IF(b) LIBASSERT_IF_##b
-#define LIBASSERT_IF_true(t,...) t
-#define LIBASSERT_IF_false(t,f,...) f
-
-#if LIBASSERT_IS_CLANG || LIBASSERT_IS_GCC
- #if LIBASSERT_IS_GCC
-  #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_GCC \
-     _Pragma("GCC diagnostic ignored \"-Wparentheses\"") \
-     _Pragma("GCC diagnostic ignored \"-Wuseless-cast\"") // #49
-  #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_CLANG
-  #define LIBASSERT_WARNING_PRAGMA_PUSH_GCC _Pragma("GCC diagnostic push")
-  #define LIBASSERT_WARNING_PRAGMA_POP_GCC _Pragma("GCC diagnostic pop")
-  #define LIBASSERT_WARNING_PRAGMA_PUSH_CLANG
-  #define LIBASSERT_WARNING_PRAGMA_POP_CLANG
- #else
-  #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_CLANG \
-     _Pragma("GCC diagnostic ignored \"-Wparentheses\"") \
-     _Pragma("GCC diagnostic ignored \"-Woverloaded-shift-op-parentheses\"")
-  #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_GCC
-  #define LIBASSERT_WARNING_PRAGMA_PUSH_GCC
-  #define LIBASSERT_WARNING_PRAGMA_POP_GCC
-  #define LIBASSERT_WARNING_PRAGMA_PUSH_CLANG _Pragma("GCC diagnostic push")
-  #define LIBASSERT_WARNING_PRAGMA_POP_CLANG _Pragma("GCC diagnostic pop")
- #endif
-#else
- #define LIBASSERT_WARNING_PRAGMA_PUSH_CLANG
- #define LIBASSERT_WARNING_PRAGMA_POP_CLANG
- #define LIBASSERT_WARNING_PRAGMA_PUSH_GCC
- #define LIBASSERT_WARNING_PRAGMA_POP_GCC
- #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_GCC
- #define LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_CLANG
-#endif
-
-namespace libassert {
-    inline void ERROR_ASSERTION_FAILURE_IN_CONSTEXPR_CONTEXT() {
-        // This non-constexpr method is called from an assertion in a constexpr context if a failure occurs. It is
-        // intentionally a no-op.
-    }
-}
-
 // __PRETTY_FUNCTION__ used because __builtin_FUNCTION() used in source_location (like __FUNCTION__) is just the method
 // name, not signature
 // The arg strings at the very least must be static constexpr. Unfortunately static constexpr variables are not allowed
 // in constexpr functions pre-C++23.
 // TODO: Try to do a hybrid in C++20 with std::is_constant_evaluated?
-#if defined(__cpp_constexpr) && __cpp_constexpr >= 202211L
+#ifdef LIBASSERT_STRIP_SITE_STRINGS
+// The record is only there to be extracted into the site map, the code just uses the ID computed from it
+#define LIBASSERT_STATIC_DATA(name, type, expr_str, ...) \
+    using libassert_params_t = libassert::detail::assert_static_parameters; \
+    const libassert_params_t* libassert_params = [] { \
+        [[gnu::used, gnu::section("libassert_sites")]] static constexpr auto libassert_site_record = \
+            libassert::detail::make_site_record( \
+                name "\0" __FILE__ "\0" LIBASSERT_STRIP_STRINGIFY_LINE(__LINE__) "\0" expr_str \
+                LIBASSERT_MAP(LIBASSERT_STRINGIFY_SITE_ARG LIBASSERT_VA_ARGS(__VA_ARGS__)) \
+            ); \
+        return libassert::detail::stripped_static_parameters( \
+            libassert::detail::site_id(libassert_site_record), \
+            type, \
+            libassert::detail::site_arg_count(libassert_site_record) \
+        ); \
+    }();
+#elif defined(LIBASSERT_COMPACT_STATIC_DATA)
+// No static variables at all, just string literals and a call on the failure path
+#define LIBASSERT_STATIC_DATA(name, type, expr_str, ...) \
+    using libassert_params_t = libassert::detail::assert_static_parameters; \
+    const libassert_params_t* libassert_params = libassert::detail::decode_static_parameters( \
+        name, \
+        type, \
+        libassert::detail::site_strings( \
+            expr_str LIBASSERT_MAP(LIBASSERT_STRINGIFY_SITE_ARG LIBASSERT_VA_ARGS(__VA_ARGS__)) \
+        ), \
+        libassert::source_location{} \
+    );
+#elif defined(__cpp_constexpr) && __cpp_constexpr >= 202211L
 // Can just use static constexpr everywhere
 #define LIBASSERT_STATIC_DATA(name, type, expr_str, ...) \
     /* extra string here because of extra comma from map, also serves as terminator */ \
@@ -693,28 +900,9 @@ namespace libassert {
 #if LIBASSERT_IS_MSVC
  #define LIBASSERT_INVOKE_VAL_PRETTY_FUNCTION_ARG ,libassert::detail::pretty_function_name_wrapper{libassert_msvc_pfunc}
 #else
- #define LIBASSERT_INVOKE_VAL_PRETTY_FUNCTION_ARG ,libassert::detail::pretty_function_name_wrapper{LIBASSERT_PFUNC}
-#endif
-#define LIBASSERT_PRETTY_FUNCTION_ARG ,libassert::detail::pretty_function_name_wrapper{LIBASSERT_PFUNC}
-#if LIBASSERT_IS_CLANG // -Wall in clang
- #define LIBASSERT_IGNORE_UNUSED_VALUE _Pragma("GCC diagnostic ignored \"-Wunused-value\"")
-#else
- #define LIBASSERT_IGNORE_UNUSED_VALUE
-#endif
-
-#define LIBASSERT_BREAKPOINT_IF_DEBUGGING() \
-    do \
-        if(libassert::is_debugger_present()) { \
-            LIBASSERT_BREAKPOINT(); \
-        } \
-    while(0)
-
-#ifdef LIBASSERT_BREAK_ON_FAIL
- #define LIBASSERT_BREAKPOINT_IF_DEBUGGING_ON_FAIL() LIBASSERT_BREAKPOINT_IF_DEBUGGING()
-#else
- #define LIBASSERT_BREAKPOINT_IF_DEBUGGING_ON_FAIL()
+ #define LIBASSERT_INVOKE_VAL_PRETTY_FUNCTION_ARG ,libassert::detail::pretty_function_name_wrapper{LIBASSERT_SITE_PFUNC}
 #endif
-
+#define LIBASSERT_PRETTY_FUNCTION_ARG ,libassert::detail::pretty_function_name_wrapper{LIBASSERT_SITE_PFUNC}
 #define LIBASSERT_INVOKE(expr, name, type, failaction, ...) \
     /* must push/pop out here due to nasty clang bug https://github.com/llvm/llvm-project/issues/63897 */ \
     /* must do awful stuff to workaround differences in where gcc and clang allow these directives to go */ \
@@ -722,18 +910,30 @@ namespace libassert {
         LIBASSERT_WARNING_PRAGMA_PUSH_CLANG \
         LIBASSERT_IGNORE_UNUSED_VALUE \
         LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_CLANG \
+        LIBASSERT_COUNT_EVALUATION(true, name, #expr) \
+        LIBASSERT_BEGIN_COST_SAMPLE() \
         LIBASSERT_WARNING_PRAGMA_PUSH_GCC \
         LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_GCC \
         auto libassert_decomposer = libassert::detail::expression_decomposer( \
             libassert::detail::expression_decomposer{} << expr \
         ); \
         LIBASSERT_WARNING_PRAGMA_POP_GCC \
-        if(LIBASSERT_STRONG_EXPECT(!static_cast<bool>(libassert_decomposer.get_value()), 0)) { \
+        if(LIBASSERT_STRONG_EXPECT( \
+            !LIBASSERT_END_COST_SAMPLE(static_cast<bool>(libassert_decomposer.get_value())), \
+            0 \
+        )) { \
             libassert::ERROR_ASSERTION_FAILURE_IN_CONSTEXPR_CONTEXT(); \
+            LIBASSERT_COUNT_FAILURE() \
             LIBASSERT_BREAKPOINT_IF_DEBUGGING_ON_FAIL(); \
             failaction \
             LIBASSERT_STATIC_DATA(name, libassert::assert_type::type, #expr, __VA_ARGS__) \
-            if constexpr(sizeof libassert_decomposer > 32) { \
+            if constexpr(libassert::detail::has_trivial_operands<decltype(libassert_decomposer)>) { \
+                libassert::detail::process_assert_fail_trivial( \
+                    libassert_decomposer, \
+                    libassert_params \
+                    LIBASSERT_VA_ARGS(__VA_ARGS__) LIBASSERT_PRETTY_FUNCTION_ARG \
+                ); \
+            } else if constexpr(sizeof libassert_decomposer > 32) { \
                 libassert::detail::process_assert_fail( \
                     libassert_decomposer, \
                     libassert_params \
@@ -781,7 +981,7 @@ namespace libassert {
  #define LIBASSERT_STMTEXPR(B, R) (__extension__ ({ B R }))
  #define LIBASSERT_STATIC_CAST_TO_BOOL(x) static_cast<bool>(x)
 #else
- #define LIBASSERT_STMTEXPR(B, R) [&](const char* libassert_msvc_pfunc) { B return R }(LIBASSERT_PFUNC)
+ #define LIBASSERT_STMTEXPR(B, R) [&](const char* libassert_msvc_pfunc) { B return R }(LIBASSERT_SITE_PFUNC)
  // Workaround for msvc bug
  #define LIBASSERT_STATIC_CAST_TO_BOOL(x) libassert::detail::static_cast_to_bool(x)
  namespace libassert::detail {
@@ -797,6 +997,8 @@ namespace libassert {
     LIBASSERT_IGNORE_UNUSED_VALUE \
     LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_CLANG \
     LIBASSERT_STMTEXPR( \
+        LIBASSERT_COUNT_EVALUATION(check_expression, name, #expr) \
+        LIBASSERT_BEGIN_COST_SAMPLE() \
         LIBASSERT_WARNING_PRAGMA_PUSH_GCC \
         LIBASSERT_EXPRESSION_DECOMP_WARNING_PRAGMA_GCC \
         auto libassert_decomposer = libassert::detail::expression_decomposer( \
@@ -809,12 +1011,20 @@ namespace libassert {
             /* For *some* godforsaken reason static_cast<bool> causes an ICE in MSVC here. Something very specific */ \
             /* about casting a decltype(auto) value inside a lambda. Workaround is to put it in a wrapper. */ \
             /* https://godbolt.org/z/Kq8Wb6q5j https://godbolt.org/z/nMnqnsMYx */ \
-            if(LIBASSERT_STRONG_EXPECT(!LIBASSERT_STATIC_CAST_TO_BOOL(libassert_value), 0)) { \
+            if(LIBASSERT_STRONG_EXPECT(!LIBASSERT_END_COST_SAMPLE(LIBASSERT_STATIC_CAST_TO_BOOL(libassert_value)), 0)) { \
                 libassert::ERROR_ASSERTION_FAILURE_IN_CONSTEXPR_CONTEXT(); \
+                LIBASSERT_COUNT_FAILURE() \
                 LIBASSERT_BREAKPOINT_IF_DEBUGGING_ON_FAIL(); \
                 failaction \
                 LIBASSERT_STATIC_DATA(name, libassert::assert_type::type, #expr, __VA_ARGS__) \
-                if constexpr(sizeof libassert_decomposer > 32) { \
+                if constexpr(libassert::detail::has_trivial_operands<decltype(libassert_decomposer)>) { \
+                    /* the decomposer is left untouched so nothing needs to be laundered */ \
+                    libassert::detail::process_assert_fail_trivial( \
+                        libassert_decomposer, \
+                        libassert_params \
+                        LIBASSERT_VA_ARGS(__VA_ARGS__) LIBASSERT_INVOKE_VAL_PRETTY_FUNCTION_ARG \
+                    ); \
+                } else if constexpr(sizeof libassert_decomposer > 32) { \
                     libassert::detail::process_assert_fail( \
                         libassert_decomposer, \
                         libassert_params \
@@ -840,18 +1050,29 @@ namespace libassert {
             doreturn LIBASSERT_COMMA \
             libassert_ret_lhs LIBASSERT_COMMA \
             std::is_lvalue_reference_v<decltype(libassert_value)> \
-        >(libassert_value, *std::launder(&libassert_decomposer)); \
+        >(libassert_value, *libassert::detail::launder_decomposer(&libassert_decomposer)); \
     ) LIBASSERT_IF(doreturn)(.value,) \
     LIBASSERT_WARNING_PRAGMA_POP_CLANG
 
-#ifdef NDEBUG
- #define LIBASSERT_ASSUME_ACTION LIBASSERT_UNREACHABLE_CALL;
-#else
- #define LIBASSERT_ASSUME_ACTION
-#endif
-
 // assertion macros
 
+// <libassert/assert-fwd.hpp>'s macros if it was included first
+#ifdef LIBASSERT_FWD_MACROS
+ #undef LIBASSERT_FWD_MACROS
+ #undef LIBASSERT_DEBUG_ASSERT
+ #undef LIBASSERT_ASSERT
+ #undef LIBASSERT_ASSUME
+ #undef LIBASSERT_PANIC
+ #undef LIBASSERT_UNREACHABLE
+ #ifndef LIBASSERT_PREFIX_ASSERTIONS
+  #undef DEBUG_ASSERT
+  #undef ASSERT
+  #undef ASSUME
+  #undef PANIC
+  #undef UNREACHABLE
+ #endif
+#endif
+
 // Debug assert
 #ifndef NDEBUG
  #define LIBASSERT_DEBUG_ASSERT(expr, ...) LIBASSERT_INVOKE(expr, "DEBUG_ASSERT", debug_assertion, , __VA_ARGS__)
@@ -860,7 +1081,11 @@ namespace libassert {
 #endif
 
 // Assert
-#define LIBASSERT_ASSERT(expr, ...) LIBASSERT_INVOKE(expr, "ASSERT", assertion, , __VA_ARGS__)
+#ifdef LIBASSERT_SITE_POLICY_HEADER
+ #define LIBASSERT_ASSERT(expr, ...) LIBASSERT_INVOKE_DEMOTABLE(expr, "ASSERT", assertion, , __VA_ARGS__)
+#else
+ #define LIBASSERT_ASSERT(expr, ...) LIBASSERT_INVOKE(expr, "ASSERT", assertion, , __VA_ARGS__)
+#endif
 // lowercase version intentionally done outside of the include guard here
 
 // Assume
@@ -0,0 +1,50 @@
+#ifndef LIBASSERT_ASSERTION_FAILURE_HPP
+#define LIBASSERT_ASSERTION_FAILURE_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <string>
+
+#include <libassert/assert.hpp>
+
+// =====================================================================================================================
+// || Assertion exception                                                                                             ||
+// =====================================================================================================================
+
+namespace libassert {
+    // Exception carrying a failed assertion's assertion_info. Nothing is rendered when it's thrown, what() renders the
+    // report on first call (without the stack trace) and caches it. what() is thread-safe, as are the structured
+    // accessors. Resolving the stack trace through info() isn't synchronized with other threads.
+    // Copies share the same assertion_info.
+    class LIBASSERT_EXPORT assertion_failure : public std::exception {
+        struct impl;
+        std::shared_ptr<impl> pimpl; // shared so copying the exception doesn't throw
+    public:
+        explicit assertion_failure(assertion_info&& info);
+        explicit assertion_failure(const assertion_info& info); // copies the trace and diagnostics
+
+        [[nodiscard]] const char* what() const noexcept override;
+
+        [[nodiscard]] const assertion_info& info() const noexcept;
+        [[nodiscard]] assert_type type() const noexcept;
+        [[nodiscard]] std::string_view macro_name() const noexcept;
+        [[nodiscard]] std::string_view expression() const noexcept;
+        [[nodiscard]] std::string_view file_name() const noexcept;
+        [[nodiscard]] std::uint32_t line() const noexcept;
+        [[nodiscard]] std::string_view function() const noexcept;
+        [[nodiscard]] const std::optional<std::string>& message() const noexcept;
+    };
+
+    // Failure handler throwing assertion_failure for all assertion types. When installed with set_failure_handler the
+    // assertion_info is moved into the exception, nothing is copied or stringified beyond what the assertion already
+    // captured. When called from another handler the info is copied.
+    [[noreturn]] LIBASSERT_EXPORT void throwing_failure_handler(const assertion_info& info);
+}
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef LIBASSERT_CHECKED_ALGORITHMS_HPP
+#define LIBASSERT_CHECKED_ALGORITHMS_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include <libassert/assert.hpp>
+#include <libassert/range-assertions.hpp>
+
+// =====================================================================================================================
+// || Checked binary search                                                                                          ||
+// =====================================================================================================================
+
+// libassert::checked::lower_bound, upper_bound, equal_range, and binary_search are std's algorithms which also check
+// that the range is sorted, without giving up O(log n): every element the search probes is compared with its successor
+// and with the probes bounding it, and LIBASSERT_CHECKED_SAMPLES random adjacent pairs are compared. An unsorted range
+// isn't always caught but when it is the failure is reported like an assertion at the call site, with the offending
+// pair. Sampling needs random access iterators, with forward iterators only the search path is checked. Unlike with
+// std's algorithms the comparator also has to compare two elements.
+
+#ifndef LIBASSERT_CHECKED_SAMPLES
+ #define LIBASSERT_CHECKED_SAMPLES 8
+#endif
+
+namespace libassert::detail {
+    // xorshift64, the pairs only need to differ from call to call
+    inline std::uint64_t next_checked_sample() {
+        thread_local std::uint64_t state = 0x9e3779b97f4a7c15;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    template<typename It>
+    struct iterator_range {
+        It first;
+        It last;
+        It begin() const {
+            return first;
+        }
+        It end() const {
+            return last;
+        }
+    };
+
+    template<typename It>
+    LIBASSERT_ATTR_COLD LIBASSERT_ATTR_NOINLINE
+    void report_unsorted(
+        const char* name,
+        It first,
+        It last,
+        std::size_t a,
+        std::size_t b,
+        source_location location
+    ) {
+        const auto* params = decode_static_parameters(
+            name,
+            assert_type::assertion,
+            site_strings("first, last, value\0message"),
+            location
+        );
+        process_range_assert_fail(
+            iterator_range<It>{first, last},
+            range_invariant_result<range_invariant::sorted>{false, a, b},
+            params,
+            "the range isn't sorted",
+            pretty_function_name_wrapper{nullptr}
+        );
+    }
+
+    // the precondition checks of one checked algorithm call, only the first violation found is kept
+    template<typename It, typename Compare>
+    class sorted_precondition {
+        It begin;
+        It end;
+        Compare& comp;
+        bool failed = false;
+        std::size_t first = 0;
+        std::size_t second = 0;
+
+        void check_pair(It a, It b) {
+            // b comes after a
+            if(LIBASSERT_STRONG_EXPECT(static_cast<bool>(comp(*b, *a)), 0) && !failed) {
+                failed = true;
+                first = static_cast<std::size_t>(std::distance(begin, a));
+                second = static_cast<std::size_t>(std::distance(begin, b));
+            }
+        }
+
+    public:
+        sorted_precondition(It begin_, It end_, Compare& comp_) : begin(begin_), end(end_), comp(comp_) {}
+
+        // std::partition_point over [first, last) which is a subrange of the checked range, pred is true before the
+        // partition point
+        template<typename Pred>
+        It partition_point(It first_, It last_, Pred pred) {
+            auto count = std::distance(first_, last_);
+            // the last probes which went right and left, all probes in between have to be sorted between them
+            It low = end;
+            It high = end;
+            while(count > 0) {
+                const auto half = count / 2;
+                const It mid = std::next(first_, half);
+                const It next = std::next(mid);
+                if(next != end) {
+                    check_pair(mid, next);
+                }
+                if(low != end) {
+                    check_pair(low, mid);
+                }
+                if(high != end) {
+                    check_pair(mid, high);
+                }
+                if(pred(*mid)) {
+                    low = mid;
+                    first_ = next;
+                    count -= half + 1;
+                } else {
+                    high = mid;
+                    count = half;
+                }
+            }
+            return first_;
+        }
+
+        void sample() {
+            if constexpr(is_random_access_range<iterator_range<It>>) {
+                const auto size = static_cast<std::uint64_t>(end - begin);
+                if(size < 2) {
+                    return;
+                }
+                for(int i = 0; i < LIBASSERT_CHECKED_SAMPLES; i++) {
+                    const It a = begin + static_cast<std::ptrdiff_t>(next_checked_sample() % (size - 1));
+                    check_pair(a, a + 1);
+                }
+            }
+        }
+
+        void report(const char* name, source_location location) const {
+            if(LIBASSERT_STRONG_EXPECT(failed, 0)) {
+                report_unsorted(name, begin, end, first, second, location);
+            }
+        }
+    };
+}
+
+namespace libassert::checked {
+    template<typename It, typename T, typename Compare>
+    It lower_bound(It first, It last, const T& value, Compare comp, source_location location = {}) {
+        detail::sorted_precondition<It, Compare> check(first, last, comp);
+        const It result = check.partition_point(
+            first,
+            last,
+            [&value, &comp] (const auto& element) { return static_cast<bool>(comp(element, value)); }
+        );
+        check.sample();
+        check.report("libassert::checked::lower_bound", location);
+        return result;
+    }
+
+    template<typename It, typename T>
+    It lower_bound(It first, It last, const T& value, source_location location = {}) {
+        return checked::lower_bound(first, last, value, std::less<>{}, location);
+    }
+
+    template<typename It, typename T, typename Compare>
+    It upper_bound(It first, It last, const T& value, Compare comp, source_location location = {}) {
+        detail::sorted_precondition<It, Compare> check(first, last, comp);
+        const It result = check.partition_point(
+            first,
+            last,
+            [&value, &comp] (const auto& element) { return !static_cast<bool>(comp(value, element)); }
+        );
+        check.sample();
+        check.report("libassert::checked::upper_bound", location);
+        return result;
+    }
+
+    template<typename It, typename T>
+    It upper_bound(It first, It last, const T& value, source_location location = {}) {
+        return checked::upper_bound(first, last, value, std::less<>{}, location);
+    }
+
+    template<typename It, typename T, typename Compare>
+    std::pair<It, It> equal_range(It first, It last, const T& value, Compare comp, source_location location = {}) {
+        detail::sorted_precondition<It, Compare> check(first, last, comp);
+        const It lower = check.partition_point(
+            first,
+            last,
+            [&value, &comp] (const auto& element) { return static_cast<bool>(comp(element, value)); }
+        );
+        const It upper = check.partition_point(
+            lower,
+            last,
+            [&value, &comp] (const auto& element) { return !static_cast<bool>(comp(value, element)); }
+        );
+        check.sample();
+        check.report("libassert::checked::equal_range", location);
+        return {lower, upper};
+    }
+
+    template<typename It, typename T>
+    std::pair<It, It> equal_range(It first, It last, const T& value, source_location location = {}) {
+        return checked::equal_range(first, last, value, std::less<>{}, location);
+    }
+
+    template<typename It, typename T, typename Compare>
+    bool binary_search(It first, It last, const T& value, Compare comp, source_location location = {}) {
+        detail::sorted_precondition<It, Compare> check(first, last, comp);
+        const It lower = check.partition_point(
+            first,
+            last,
+            [&value, &comp] (const auto& element) { return static_cast<bool>(comp(element, value)); }
+        );
+        check.sample();
+        check.report("libassert::checked::binary_search", location);
+        return lower != last && !static_cast<bool>(comp(value, *lower));
+    }
+
+    template<typename It, typename T>
+    bool binary_search(It first, It last, const T& value, source_location location = {}) {
+        return checked::binary_search(first, last, value, std::less<>{}, location);
+    }
+}
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef LIBASSERT_CHECKED_SPAN_HPP
+#define LIBASSERT_CHECKED_SPAN_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <libassert/assert.hpp>
+
+// =====================================================================================================================
+// || Checked span                                                                                                   ||
+// =====================================================================================================================
+
+// libassert::checked_span<T> is a view of contiguous elements, made from a pointer and a size or from anything with
+// std::data and std::size such as a std::vector, std::array, std::string_view, or C array. operator[], front, back, and
+// dereferencing its iterators check the index with one unsigned compare, a failure is reported like an assertion by a
+// shared out of line function with the index, the size, the element type, and a stack trace. The location is taken
+// from the trace since the operators can't take a source_location. A failed access never happens: the failure path
+// doesn't return.
+
+// LIBASSERT_BOUNDS_CHECKS: 2 checks always like ASSERT, 1 checks unless NDEBUG is defined like DEBUG_ASSERT, 0 never
+// checks
+#ifndef LIBASSERT_BOUNDS_CHECKS
+ #define LIBASSERT_BOUNDS_CHECKS 2
+#endif
+
+namespace libassert::detail {
+    #if LIBASSERT_BOUNDS_CHECKS == 2 || (LIBASSERT_BOUNDS_CHECKS == 1 && !defined(NDEBUG))
+    inline constexpr bool bounds_checks = true;
+    #else
+    inline constexpr bool bounds_checks = false;
+    #endif
+
+    enum class bounds_check_operation { index, front, back, dereference };
+
+    // see checked_span.cpp, the element type is the one type_name gives. Doesn't return, an exception thrown by the
+    // failure handler propagates and the program is aborted otherwise
+    LIBASSERT_ATTR_COLD [[noreturn]] LIBASSERT_ATTR_NOINLINE LIBASSERT_EXPORT
+    void bounds_check_fail(
+        bounds_check_operation operation,
+        std::size_t index,
+        std::size_t size,
+        std::string_view element_type
+    );
+
+    // the element type's name is only looked up here, off the passing path
+    template<typename T>
+    LIBASSERT_ATTR_COLD [[noreturn]] LIBASSERT_ATTR_NOINLINE
+    void checked_access_fail(bounds_check_operation operation, std::size_t index, std::size_t size) {
+        bounds_check_fail(operation, index, size, type_name<std::remove_cv_t<T>>());
+    }
+
+    template<typename T>
+    constexpr T& checked_access(bounds_check_operation operation, T* data, std::size_t index, std::size_t size) {
+        if constexpr(bounds_checks) {
+            if(LIBASSERT_STRONG_EXPECT(index >= size, 0)) {
+                checked_access_fail<T>(operation, index, size);
+            }
+        }
+        return data[index];
+    }
+
+    template<typename T>
+    class checked_span_iterator {
+        // the index instead of a pointer so an iterator before the beginning fails the same unsigned compare
+        T* data_ = nullptr;
+        std::size_t size_ = 0;
+        std::size_t index_ = 0;
+
+        template<typename U> friend class checked_span_iterator;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        constexpr checked_span_iterator() = default;
+        constexpr checked_span_iterator(T* data, std::size_t size, std::size_t index)
+            : data_(data), size_(size), index_(index) {}
+        // iterator to const_iterator
+        template<typename U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+        // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+        constexpr checked_span_iterator(const checked_span_iterator<U>& other)
+            : data_(other.data_), size_(other.size_), index_(other.index_) {}
+
+        constexpr reference operator*() const {
+            return checked_access(bounds_check_operation::dereference, data_, index_, size_);
+        }
+        constexpr pointer operator->() const {
+            return &**this;
+        }
+        constexpr reference operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        constexpr checked_span_iterator& operator++() {
+            index_++;
+            return *this;
+        }
+        constexpr checked_span_iterator operator++(int) {
+            auto copy = *this;
+            index_++;
+            return copy;
+        }
+        constexpr checked_span_iterator& operator--() {
+            index_--;
+            return *this;
+        }
+        constexpr checked_span_iterator operator--(int) {
+            auto copy = *this;
+            index_--;
+            return copy;
+        }
+        constexpr checked_span_iterator& operator+=(difference_type n) {
+            index_ += static_cast<std::size_t>(n);
+            return *this;
+        }
+        constexpr checked_span_iterator& operator-=(difference_type n) {
+            index_ -= static_cast<std::size_t>(n);
+            return *this;
+        }
+        friend constexpr checked_span_iterator operator+(checked_span_iterator it, difference_type n) {
+            return it += n;
+        }
+        friend constexpr checked_span_iterator operator+(difference_type n, checked_span_iterator it) {
+            return it += n;
+        }
+        friend constexpr checked_span_iterator operator-(checked_span_iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend constexpr difference_type operator-(const checked_span_iterator& a, const checked_span_iterator& b) {
+            return static_cast<difference_type>(a.index_ - b.index_);
+        }
+
+        friend constexpr bool operator==(const checked_span_iterator& a, const checked_span_iterator& b) {
+            return a.index_ == b.index_;
+        }
+        friend constexpr bool operator!=(const checked_span_iterator& a, const checked_span_iterator& b) {
+            return a.index_ != b.index_;
+        }
+        friend constexpr bool operator<(const checked_span_iterator& a, const checked_span_iterator& b) {
+            return a.index_ < b.index_;
+        }
+        friend constexpr bool operator>(const checked_span_iterator& a, const checked_span_iterator& b) {
+            return a.index_ > b.index_;
+        }
+        friend constexpr bool operator<=(const checked_span_iterator& a, const checked_span_iterator& b) {
+            return a.index_ <= b.index_;
+        }
+        friend constexpr bool operator>=(const checked_span_iterator& a, const checked_span_iterator& b) {
+            return a.index_ >= b.index_;
+        }
+    };
+}
+
+namespace libassert {
+    template<typename T>
+    class checked_span {
+        T* data_ = nullptr;
+        std::size_t size_ = 0;
+
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+        using iterator = detail::checked_span_iterator<T>;
+
+        constexpr checked_span() = default;
+        constexpr checked_span(T* data, std::size_t size) : data_(data), size_(size) {}
+        // any contiguous range of T, or of U if a U* converts to a T* without slicing
+        template<
+            typename R,
+            typename = std::enable_if_t<
+                !std::is_same_v<std::remove_cv_t<R>, checked_span>
+                && std::is_convertible_v<std::remove_pointer_t<decltype(std::data(std::declval<R&>()))>(*)[], T(*)[]>
+            >,
+            typename = decltype(std::size(std::declval<R&>()))
+        >
+        // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+        constexpr checked_span(R& range) : data_(std::data(range)), size_(std::size(range)) {}
+        // checked_span<T> to checked_span<const T>
+        template<typename U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+        // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+        constexpr checked_span(const checked_span<U>& other) : data_(other.data()), size_(other.size()) {}
+
+        [[nodiscard]] constexpr reference operator[](size_type index) const {
+            return detail::checked_access(detail::bounds_check_operation::index, data_, index, size_);
+        }
+        [[nodiscard]] constexpr reference front() const {
+            return detail::checked_access(detail::bounds_check_operation::front, data_, 0, size_);
+        }
+        [[nodiscard]] constexpr reference back() const {
+            // size_ - 1 >= size_ would be the same check but GCC drops the branch weights when it folds it
+            if constexpr(detail::bounds_checks) {
+                if(LIBASSERT_STRONG_EXPECT(size_ == 0, 0)) {
+                    detail::checked_access_fail<T>(detail::bounds_check_operation::back, size_ - 1, size_);
+                }
+            }
+            return data_[size_ - 1];
+        }
+
+        [[nodiscard]] constexpr iterator begin() const {
+            return {data_, size_, 0};
+        }
+        [[nodiscard]] constexpr iterator end() const {
+            return {data_, size_, size_};
+        }
+
+        [[nodiscard]] constexpr pointer data() const {
+            return data_;
+        }
+        [[nodiscard]] constexpr size_type size() const {
+            return size_;
+        }
+        [[nodiscard]] constexpr bool empty() const {
+            return size_ == 0;
+        }
+    };
+
+    template<typename R>
+    checked_span(R&) -> checked_span<std::remove_pointer_t<decltype(std::data(std::declval<R&>()))>>;
+}
+
+#endif
@@ -325,6 +325,36 @@ namespace libassert::detail {
     expression_decomposer(U&&) -> expression_decomposer<
         std::conditional_t<std::is_rvalue_reference_v<U>, std::remove_reference_t<U>, U>
     >;
+
+    // Decomposers whose operands are all small trivially copyable types such as ints, pointers, and string_views hand
+    // the failure path a copy holding the operands by value. Passing references would take the operands' addresses,
+    // which forces them out of registers on the passing path too.
+    template<typename T, typename U = std::remove_reference_t<T>>
+    constexpr bool is_trivial_operand = is_nothing<T> || (
+        std::is_trivially_copyable_v<U>
+        && std::is_copy_constructible_v<U>
+        && !std::is_volatile_v<U>
+        && sizeof(U) <= 2 * sizeof(void*)
+    );
+
+    template<typename T>
+    constexpr bool has_trivial_operands = false;
+    template<typename A, typename B, typename C>
+    constexpr bool has_trivial_operands<expression_decomposer<A, B, C>> = is_trivial_operand<A> && is_trivial_operand<B>;
+
+    template<typename A, typename B, typename C>
+    [[nodiscard]] LIBASSERT_ATTR_ALWAYS_INLINE constexpr auto copy_trivial_operands(const expression_decomposer<A, B, C>& decomposer) {
+        using copy_type = expression_decomposer<
+            std::remove_cv_t<std::remove_reference_t<A>>,
+            std::remove_cv_t<std::remove_reference_t<B>>,
+            C
+        >;
+        if constexpr(is_nothing<B>) {
+            return copy_type(decomposer.a);
+        } else {
+            return copy_type(decomposer.a, decomposer.b);
+        }
+    }
 }
 
 #endif
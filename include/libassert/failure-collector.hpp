@@ -0,0 +1,96 @@
+#ifndef LIBASSERT_FAILURE_COLLECTOR_HPP
+#define LIBASSERT_FAILURE_COLLECTOR_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <libassert/assert.hpp>
+
+// =====================================================================================================================
+// || Scoped failure collection                                                                                       ||
+// =====================================================================================================================
+
+namespace libassert {
+    // an assertion site that failed at least once in a batch
+    struct failure_site {
+        std::string_view macro_name;
+        assert_type type;
+        std::string_view expression_string;
+        std::string_view file_name;
+        std::uint32_t line;
+        std::string_view function;
+        std::size_t n_args;
+        std::string left_expression; // empty if the assertion isn't a binary expression
+        std::string right_expression;
+        bool multiple_formats;
+        std::uint64_t count;
+        std::optional<raw_trace_type> trace; // trace of the first failure, if traces are captured
+    };
+
+    struct collected_failure {
+        std::uint32_t site; // index into failure_batch::sites
+        std::optional<std::string> message;
+        std::string left_stringification; // empty if the assertion isn't a binary expression
+        std::string right_stringification;
+        std::vector<extra_diagnostic> extra_diagnostics;
+    };
+
+    struct LIBASSERT_EXPORT failure_batch {
+        std::vector<failure_site> sites; // in order of first failure
+        std::vector<collected_failure> failures; // in order of occurrence
+
+        [[nodiscard]] bool empty() const noexcept;
+        [[nodiscard]] std::size_t size() const noexcept;
+        // one report per site for its first failure, followed by the values of up to max_values_per_site later failures
+        [[nodiscard]] std::string to_string(
+            int width = 0,
+            const color_scheme& scheme = get_color_scheme(),
+            std::size_t max_values_per_site = 10
+        ) const;
+    };
+
+    // While a failure_collector is alive, assertion failures on the thread that created it are appended to its batch
+    // instead of going through the failure handler. Only the operands, message, and extra diagnostics are stringified,
+    // the stack trace is only captured for the first failure of each site and is never resolved during collection.
+    // When the collector is destroyed the batch is passed to the callback, or if there's no callback and the batch
+    // isn't empty it's rendered to stderr.
+    // Collectors nest: the most recently created collector on a thread receives that thread's failures and once it's
+    // destroyed the previous one receives them again, including failures from the callback. Collectors must be
+    // destroyed in reverse order of construction on the thread that created them. Other threads are unaffected.
+    // Panics and unreachables are never collected.
+    class LIBASSERT_EXPORT failure_collector {
+    public:
+        using callback_type = std::function<void(failure_batch&)>;
+    private:
+        failure_collector* previous;
+        callback_type callback;
+        bool capture_traces;
+        failure_batch failures;
+        std::unordered_map<const detail::assert_static_parameters*, std::uint32_t> site_indices;
+        friend detail::collection_mode detail::get_collection_mode(const detail::assert_static_parameters*);
+        friend void detail::collect_failure(assertion_info&, const detail::assert_static_parameters*);
+    public:
+        // pass nullptr as the callback to render the batch to stderr, capture_traces has no effect without a stack trace
+        // backend
+        explicit failure_collector(callback_type callback = nullptr, bool capture_traces = true);
+        ~failure_collector();
+        failure_collector(const failure_collector&) = delete;
+        failure_collector(failure_collector&&) = delete;
+        failure_collector& operator=(const failure_collector&) = delete;
+        failure_collector& operator=(failure_collector&&) = delete;
+
+        // failures collected so far
+        [[nodiscard]] const failure_batch& batch() const noexcept;
+    };
+}
+
+#endif
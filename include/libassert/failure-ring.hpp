@@ -0,0 +1,65 @@
+#ifndef LIBASSERT_FAILURE_RING_HPP
+#define LIBASSERT_FAILURE_RING_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <string>
+#include <vector>
+
+#include <libassert/assert.hpp>
+
+// =====================================================================================================================
+// || Crash-surviving failure log                                                                                     ||
+// =====================================================================================================================
+
+namespace libassert {
+    // A fixed-size ring of failure records backed by a memory-mapped file. A slot is reserved with a single atomic
+    // increment and the record is memcpy'd into it, so appends are lock-free and safe from any number of threads.
+    // Because the file is mapped shared the records end up in the page cache as they are written and survive the
+    // process being killed. Each slot carries sequence numbers written before and after the payload plus a checksum so
+    // partially written records are detected and skipped when reading.
+    // If the file already contains a ring its geometry is reused and new records continue the existing sequence.
+    class LIBASSERT_EXPORT failure_ring {
+        unsigned char* base = nullptr;
+        std::size_t mapping_size = 0;
+        std::uint32_t slot_count = 0;
+        std::uint32_t slot_size = 0;
+    public:
+        // throws std::system_error if the file can't be opened or mapped
+        explicit failure_ring(std::string_view path, std::uint32_t slot_count = 256, std::uint32_t slot_size = 4096);
+        ~failure_ring();
+        failure_ring(const failure_ring&) = delete;
+        failure_ring(failure_ring&&) = delete;
+        failure_ring& operator=(const failure_ring&) = delete;
+        failure_ring& operator=(failure_ring&&) = delete;
+
+        // appends a record, records larger than a slot are truncated
+        void append(std::string_view record) noexcept;
+        // renders the assertion (without color) and appends it
+        void append(const assertion_info& info);
+
+        [[nodiscard]] std::uint32_t capacity() const noexcept; // max payload size of a record
+        [[nodiscard]] std::uint32_t size() const noexcept; // number of slots
+    };
+
+    struct failure_ring_record {
+        std::uint64_t sequence;
+        bool truncated;
+        std::string text;
+    };
+
+    // Reads up to n of the most recent intact records from a ring file, oldest first. Torn slots are skipped. Can be
+    // used on the file of a live process or after the fact.
+    // throws std::system_error if the file can't be read, std::runtime_error if it isn't a failure ring
+    [[nodiscard]] LIBASSERT_EXPORT std::vector<failure_ring_record> read_failure_ring(
+        std::string_view path,
+        std::size_t n = std::numeric_limits<std::size_t>::max()
+    );
+}
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef LIBASSERT_NEAR_ASSERTIONS_HPP
+#define LIBASSERT_NEAR_ASSERTIONS_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+#include <libassert/assert.hpp>
+#include <libassert/range-assertions.hpp>
+
+// =====================================================================================================================
+// || Floating point comparisons                                                                                      ||
+// =====================================================================================================================
+
+// ASSERT_NEAR(a, b, tolerance, ...) checks that two numbers are within a tolerance of each other, a plain number is an
+// absolute tolerance, libassert::relative_tolerance(r) is relative to the larger magnitude, and
+// libassert::ulp_tolerance(n) is a number of representable values apart. Equal values, including infinities, are always
+// near and NaN is never near anything. Integers are compared as doubles, long doubles are converted to double to count
+// ULPs. On failure both values, their difference, and the ULP distance are shown.
+// ASSERT_ALL_NEAR(a, b, tolerance, ...) compares two contiguous ranges of the same floating point type element-wise in
+// one vectorizable loop. On failure it shows the number of mismatches, the worst one, and the largest and mean
+// differences instead of the ranges' contents.
+
+namespace libassert {
+    enum class tolerance_kind { absolute, relative, ulps };
+
+    struct tolerance {
+        tolerance_kind kind;
+        double value; // for absolute and relative tolerances
+        std::uint64_t ulps;
+        // NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
+        constexpr tolerance(double absolute) : kind(tolerance_kind::absolute), value(absolute), ulps(0) {}
+        constexpr tolerance(tolerance_kind kind_, double value_, std::uint64_t ulps_)
+            : kind(kind_), value(value_), ulps(ulps_) {}
+    };
+
+    [[nodiscard]] constexpr tolerance absolute_tolerance(double value) {
+        return {tolerance_kind::absolute, value, 0};
+    }
+
+    [[nodiscard]] constexpr tolerance relative_tolerance(double value) {
+        return {tolerance_kind::relative, value, 0};
+    }
+
+    [[nodiscard]] constexpr tolerance ulp_tolerance(std::uint64_t ulps) {
+        return {tolerance_kind::ulps, 0, ulps};
+    }
+}
+
+namespace libassert::detail {
+    // float and double are compared as themselves, everything else is compared as a double except long doubles
+    template<typename A, typename B>
+    using near_type = std::conditional_t<
+        std::is_same_v<A, float> && std::is_same_v<B, float>,
+        float,
+        std::conditional_t<std::is_same_v<A, long double> || std::is_same_v<B, long double>, long double, double>
+    >;
+
+    // the type whose bits ULPs are counted in
+    template<typename T>
+    using ulp_type = std::conditional_t<std::is_same_v<T, float>, float, double>;
+
+    // position of x in the order of all values of its type, +0 and -0 are both 0, not meaningful for NaNs
+    template<typename T>
+    std::int64_t ulp_position(T x) {
+        using bits_type = std::conditional_t<sizeof(T) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+        static_assert(sizeof(T) == sizeof(bits_type));
+        constexpr bits_type sign = bits_type(1) << (sizeof(bits_type) * 8 - 1);
+        bits_type bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        const auto magnitude = static_cast<std::int64_t>(bits & ~sign);
+        return bits & sign ? -magnitude : magnitude;
+    }
+
+    template<typename T>
+    std::uint64_t ulp_distance(T a, T b) {
+        const auto x = static_cast<std::uint64_t>(ulp_position(static_cast<ulp_type<T>>(a)));
+        const auto y = static_cast<std::uint64_t>(ulp_position(static_cast<ulp_type<T>>(b)));
+        return a < b ? y - x : x - y;
+    }
+
+    // | instead of || so the range form's loops don't branch
+    template<typename T>
+    bool is_near(T a, T b, const tolerance& tol) {
+        const bool equal = a == b;
+        const T difference = std::abs(a - b);
+        bool within = false;
+        switch(tol.kind) {
+            // an infinite difference is never within a tolerance, inf <= inf would make an infinity near any value
+            case tolerance_kind::absolute:
+                within = std::isfinite(difference) & (difference <= static_cast<T>(tol.value));
+                break;
+            case tolerance_kind::relative:
+                within = std::isfinite(difference)
+                    & (difference <= static_cast<T>(tol.value) * std::max(std::abs(a), std::abs(b)));
+                break;
+            case tolerance_kind::ulps:
+            default:
+                // NaNs aren't ordered
+                within = (difference == difference) & (ulp_distance(a, b) <= tol.ulps);
+                break;
+        }
+        return equal | within;
+    }
+
+    template<typename T>
+    struct near_operands {
+        T a;
+        T b;
+        std::string_view a_str;
+        std::string_view b_str;
+    };
+
+    template<typename T>
+    struct near_range_operands {
+        const T* a;
+        std::size_t a_size;
+        const T* b;
+        std::size_t b_size;
+    };
+
+    struct near_result {
+        bool passed;
+        tolerance tol;
+    };
+
+    template<typename A, typename B>
+    constexpr auto make_near_scalars(const A& a, const B& b, std::string_view a_str, std::string_view b_str) {
+        static_assert(std::is_arithmetic_v<A> && std::is_arithmetic_v<B>, "ASSERT_NEAR compares numbers");
+        using T = near_type<A, B>;
+        return near_operands<T>{static_cast<T>(a), static_cast<T>(b), a_str, b_str};
+    }
+
+    template<typename A, typename B>
+    constexpr auto make_near_ranges(const A& a, const B& b, std::string_view, std::string_view) {
+        using T = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(a))>>;
+        static_assert(
+            std::is_same_v<T, std::remove_cv_t<std::remove_pointer_t<decltype(std::data(b))>>>,
+            "ASSERT_ALL_NEAR compares ranges with the same element type"
+        );
+        static_assert(std::is_floating_point_v<T>, "ASSERT_ALL_NEAR compares ranges of floating point numbers");
+        return near_range_operands<T>{std::data(a), std::size(a), std::data(b), std::size(b)};
+    }
+
+    template<typename T>
+    near_result check_near(const near_operands<T>& operands, const tolerance& tol) {
+        return {is_near(operands.a, operands.b, tol), tol};
+    }
+
+    template<typename T>
+    near_result check_near(const near_range_operands<T>& operands, const tolerance& tol) {
+        if(operands.a_size != operands.b_size) {
+            return {false, tol};
+        }
+        // counted rather than searched so the loop can be vectorized, the failure path finds the mismatches
+        std::size_t mismatches = 0;
+        const T* a = operands.a;
+        const T* b = operands.b;
+        switch(tol.kind) {
+            case tolerance_kind::absolute:
+                for(std::size_t i = 0; i < operands.a_size; i++) {
+                    mismatches += static_cast<std::size_t>(!is_near(a[i], b[i], absolute_tolerance(tol.value)));
+                }
+                break;
+            case tolerance_kind::relative:
+                for(std::size_t i = 0; i < operands.a_size; i++) {
+                    mismatches += static_cast<std::size_t>(!is_near(a[i], b[i], relative_tolerance(tol.value)));
+                }
+                break;
+            case tolerance_kind::ulps:
+            default:
+                for(std::size_t i = 0; i < operands.a_size; i++) {
+                    mismatches += static_cast<std::size_t>(!is_near(a[i], b[i], ulp_tolerance(tol.ulps)));
+                }
+                break;
+        }
+        return {mismatches == 0, tol};
+    }
+
+    // the values, difference, and ULP distance, see near_assertions.cpp
+    LIBASSERT_EXPORT void add_near_diagnostics(assertion_info& info, const near_operands<float>&, const tolerance&);
+    LIBASSERT_EXPORT void add_near_diagnostics(assertion_info& info, const near_operands<double>&, const tolerance&);
+    LIBASSERT_EXPORT void add_near_diagnostics(
+        assertion_info& info,
+        const near_operands<long double>&,
+        const tolerance&
+    );
+    // the mismatches and error statistics
+    LIBASSERT_EXPORT void add_near_diagnostics(
+        assertion_info& info,
+        const near_range_operands<float>&,
+        const tolerance&
+    );
+    LIBASSERT_EXPORT void add_near_diagnostics(
+        assertion_info& info,
+        const near_range_operands<double>&,
+        const tolerance&
+    );
+    LIBASSERT_EXPORT void add_near_diagnostics(
+        assertion_info& info,
+        const near_range_operands<long double>&,
+        const tolerance&
+    );
+
+    // called by process_range_assert_fail
+    template<typename Operands>
+    LIBASSERT_ATTR_COLD
+    void add_range_diagnostics(assertion_info& info, const Operands& operands, near_result result) {
+        add_near_diagnostics(info, operands, result.tol);
+    }
+}
+
+// make is make_near_scalars or make_near_ranges
+#define LIBASSERT_INVOKE_NEAR(make, a, b, tol, name, type, failaction, ...) \
+    do { \
+        LIBASSERT_COUNT_EVALUATION(true, name, #a ", " #b ", " #tol) \
+        const auto& libassert_near_a = a; \
+        const auto& libassert_near_b = b; \
+        LIBASSERT_BEGIN_COST_SAMPLE() \
+        const auto libassert_near_operands = libassert::detail::make( \
+            libassert_near_a, \
+            libassert_near_b, \
+            #a, \
+            #b \
+        ); \
+        const libassert::detail::near_result libassert_near_result = libassert::detail::check_near( \
+            libassert_near_operands, \
+            tol \
+        ); \
+        if(LIBASSERT_STRONG_EXPECT(!LIBASSERT_END_COST_SAMPLE(libassert_near_result.passed), 0)) { \
+            libassert::ERROR_ASSERTION_FAILURE_IN_CONSTEXPR_CONTEXT(); \
+            LIBASSERT_COUNT_FAILURE() \
+            LIBASSERT_BREAKPOINT_IF_DEBUGGING_ON_FAIL(); \
+            failaction \
+            LIBASSERT_STATIC_DATA(name, libassert::assert_type::type, #a ", " #b ", " #tol, __VA_ARGS__) \
+            libassert::detail::process_range_assert_fail( \
+                libassert_near_operands, \
+                libassert_near_result, \
+                libassert_params \
+                LIBASSERT_VA_ARGS(__VA_ARGS__) LIBASSERT_PRETTY_FUNCTION_ARG \
+            ); \
+        } \
+    } while(false)
+
+#define LIBASSERT_ASSERT_NEAR(a, b, tol, ...) \
+    LIBASSERT_INVOKE_NEAR(make_near_scalars, a, b, tol, "ASSERT_NEAR", assertion, , __VA_ARGS__)
+#define LIBASSERT_ASSERT_ALL_NEAR(a, b, tol, ...) \
+    LIBASSERT_INVOKE_NEAR(make_near_ranges, a, b, tol, "ASSERT_ALL_NEAR", assertion, , __VA_ARGS__)
+
+// GoogleTest has an ASSERT_NEAR too, if it was included first only LIBASSERT_ASSERT_NEAR is defined
+#ifndef LIBASSERT_PREFIX_ASSERTIONS
+ #if LIBASSERT_IS_CLANG || LIBASSERT_IS_GCC || !LIBASSERT_NON_CONFORMANT_MSVC_PREPROCESSOR
+  #ifndef ASSERT_NEAR
+   #define ASSERT_NEAR(...) LIBASSERT_ASSERT_NEAR(__VA_ARGS__)
+  #endif
+  #define ASSERT_ALL_NEAR(...) LIBASSERT_ASSERT_ALL_NEAR(__VA_ARGS__)
+ #else
+  #ifndef ASSERT_NEAR
+   #define ASSERT_NEAR LIBASSERT_ASSERT_NEAR
+  #endif
+  #define ASSERT_ALL_NEAR LIBASSERT_ASSERT_ALL_NEAR
+ #endif
+#endif
+
+#endif
@@ -144,11 +144,13 @@
  #define LIBASSERT_PFUNC __extension__ __PRETTY_FUNCTION__
  #define LIBASSERT_ATTR_COLD     [[gnu::cold]]
  #define LIBASSERT_ATTR_NOINLINE [[gnu::noinline]]
+ #define LIBASSERT_ATTR_ALWAYS_INLINE [[gnu::always_inline]] inline
  #define LIBASSERT_UNREACHABLE_CALL __builtin_unreachable()
 #else
  #define LIBASSERT_PFUNC __FUNCSIG__
  #define LIBASSERT_ATTR_COLD
  #define LIBASSERT_ATTR_NOINLINE __declspec(noinline)
+ #define LIBASSERT_ATTR_ALWAYS_INLINE __forceinline
  #define LIBASSERT_UNREACHABLE_CALL __assume(false)
 #endif
 
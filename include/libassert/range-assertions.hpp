@@ -0,0 +1,381 @@
+#ifndef LIBASSERT_RANGE_ASSERTIONS_HPP
+#define LIBASSERT_RANGE_ASSERTIONS_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <libassert/assert.hpp>
+
+// =====================================================================================================================
+// || Range assertions                                                                                                ||
+// =====================================================================================================================
+
+// ASSERT_ALL(range, predicate, ...), ASSERT_ANY(range, predicate, ...), and ASSERT_NONE(range, predicate, ...) check
+// predicate(element) over a forward range in one loop instead of an assertion per element. Ranges with std::data and
+// std::size are checked in fixed size blocks without an early exit so the loop can be vectorized, the predicate may be
+// called on elements after the first offending one and shouldn't have side effects. The trailing arguments are a
+// message and extra diagnostics like any other assertion's. On failure the first offending element's index and value
+// and the range's size are added to the extra diagnostics.
+// The _EXEC forms take an execution policy first, e.g. ASSERT_ALL_EXEC(std::execution::par, v, is_valid), and search
+// the range with std::find_if under the policy. <execution> has to be included by the caller.
+// ASSERT_SORTED(range, ...), ASSERT_UNIQUE_SORTED(range, ...), and ASSERT_HEAP(range, ...) check the range with
+// std::less<>, the _BY forms take a comparator after the range. ASSERT_PARTITIONED(range, predicate, ...) checks that
+// every element the predicate is true for comes before every element it's false for. These are one pass over the
+// range, random access ranges in the same blocks as above, and on failure show the first offending pair, a window of the
+// elements around it, and the range's size. ASSERT_HEAP requires a random access range.
+
+namespace libassert::detail {
+    enum class range_quantifier { all, any, none };
+
+    enum class range_invariant { sorted, unique_sorted, partitioned, heap };
+
+    struct range_check_result {
+        bool passed;
+        std::size_t index; // of the first offending element, there isn't one when ASSERT_ANY fails
+    };
+
+    template<range_invariant I>
+    struct range_invariant_result {
+        bool passed;
+        // the violating pair, adjacent elements except for ASSERT_HEAP where it's a parent and its child
+        std::size_t first;
+        std::size_t second;
+    };
+
+    struct no_execution_policy {};
+
+    template<typename R, typename = void>
+    struct is_contiguous_sized_range : std::false_type {};
+    template<typename R>
+    struct is_contiguous_sized_range<
+        R,
+        std::void_t<decltype(std::data(std::declval<const R&>())), decltype(std::size(std::declval<const R&>()))>
+    > : std::true_type {};
+
+    template<typename R>
+    inline constexpr bool is_random_access_range = std::is_base_of_v<
+        std::random_access_iterator_tag,
+        typename std::iterator_traits<decltype(std::begin(std::declval<const R&>()))>::iterator_category
+    >;
+
+    inline constexpr std::size_t range_check_block_size = 64;
+    inline constexpr std::size_t range_window_radius = 4;
+
+    // index of the first i < count where violates(i) is true, or count
+    // checked in blocks without an early exit so the loop can be vectorized, then the block with the match is rescanned
+    template<typename F>
+    constexpr std::size_t find_first_index(std::size_t count, const F& violates) {
+        std::size_t block = 0;
+        for(; block + range_check_block_size <= count; block += range_check_block_size) {
+            unsigned found = 0;
+            for(std::size_t i = block; i < block + range_check_block_size; i++) {
+                found |= static_cast<unsigned>(static_cast<bool>(violates(i)));
+            }
+            if(found != 0) {
+                break;
+            }
+        }
+        // the rest of the range or the block with the match
+        for(std::size_t i = block; i < count; i++) {
+            if(violates(i)) {
+                return i;
+            }
+        }
+        return count;
+    }
+
+    // index of the first element where static_cast<bool>(pred(element)) == Value, or the range's size
+    template<bool Value, typename R, typename P>
+    constexpr std::size_t find_first_in_range(no_execution_policy, const R& range, P& pred) {
+        if constexpr(is_contiguous_sized_range<R>::value) {
+            const auto* data = std::data(range);
+            return find_first_index(
+                std::size(range),
+                [data, &pred] (std::size_t i) { return static_cast<bool>(pred(data[i])) == Value; }
+            );
+        } else {
+            std::size_t i = 0;
+            for(const auto& element : range) {
+                if(static_cast<bool>(pred(element)) == Value) {
+                    return i;
+                }
+                i++;
+            }
+            return i;
+        }
+    }
+
+    template<bool Value, typename Policy, typename R, typename P>
+    std::size_t find_first_in_range(Policy&& policy, const R& range, P& pred) {
+        const auto begin = std::begin(range);
+        const auto it = std::find_if(
+            std::forward<Policy>(policy),
+            begin,
+            std::end(range),
+            [&pred] (const auto& element) { return static_cast<bool>(pred(element)) == Value; }
+        );
+        return static_cast<std::size_t>(std::distance(begin, it));
+    }
+
+    template<typename R>
+    constexpr std::size_t range_size(const R& range) {
+        if constexpr(is_contiguous_sized_range<R>::value) {
+            return std::size(range);
+        } else {
+            return static_cast<std::size_t>(std::distance(std::begin(range), std::end(range)));
+        }
+    }
+
+    template<range_quantifier Q, typename Policy, typename R, typename P>
+    // NOLINTNEXTLINE(cppcoreguidelines-missing-std-forward)
+    constexpr range_check_result check_range(Policy&& policy, const R& range, P&& pred) {
+        if constexpr(Q == range_quantifier::all) {
+            const auto index = find_first_in_range<false>(std::forward<Policy>(policy), range, pred);
+            return {index == range_size(range), index};
+        } else if constexpr(Q == range_quantifier::any) {
+            const auto index = find_first_in_range<true>(std::forward<Policy>(policy), range, pred);
+            return {index != range_size(range), index};
+        } else {
+            const auto index = find_first_in_range<true>(std::forward<Policy>(policy), range, pred);
+            return {index == range_size(range), index};
+        }
+    }
+
+    // whether the pair a, b violates the invariant, f is the comparator or for partitioned the predicate
+    // & instead of && for partitioned so there's no branch
+    template<range_invariant I, typename F, typename A, typename B>
+    constexpr bool violates_invariant(F& f, const A& a, const B& b) {
+        if constexpr(I == range_invariant::sorted) {
+            return static_cast<bool>(f(b, a));
+        } else if constexpr(I == range_invariant::unique_sorted) {
+            return !static_cast<bool>(f(a, b));
+        } else if constexpr(I == range_invariant::partitioned) {
+            return !static_cast<bool>(f(a)) & static_cast<bool>(f(b));
+        } else {
+            // a is b's parent in a max heap
+            return static_cast<bool>(f(a, b));
+        }
+    }
+
+    template<range_invariant I, typename R, typename F>
+    // NOLINTNEXTLINE(cppcoreguidelines-missing-std-forward)
+    constexpr range_invariant_result<I> check_range_invariant(const R& range, F&& f) {
+        if constexpr(I == range_invariant::heap) {
+            static_assert(is_random_access_range<R>, "ASSERT_HEAP requires a random access range");
+            const auto begin = std::begin(range);
+            const std::size_t size = range_size(range);
+            const std::size_t children = size == 0 ? 0 : size - 1;
+            // child i + 1's parent is i / 2
+            const std::size_t i = find_first_index(
+                children,
+                [begin, &f] (std::size_t i) { return violates_invariant<I>(f, begin[i / 2], begin[i + 1]); }
+            );
+            return {i == children, i / 2, i + 1};
+        } else if constexpr(is_random_access_range<R>) {
+            const auto begin = std::begin(range);
+            const std::size_t size = range_size(range);
+            const std::size_t pairs = size == 0 ? 0 : size - 1;
+            const std::size_t i = find_first_index(
+                pairs,
+                [begin, &f] (std::size_t i) { return violates_invariant<I>(f, begin[i], begin[i + 1]); }
+            );
+            return {i == pairs, i, i + 1};
+        } else {
+            auto it = std::begin(range);
+            const auto end = std::end(range);
+            std::size_t i = 0;
+            if(it != end) {
+                for(auto next = std::next(it); next != end; ++it, ++next, ++i) {
+                    if(violates_invariant<I>(f, *it, *next)) {
+                        return {false, i, i + 1};
+                    }
+                }
+            }
+            return {true, i, i + 1};
+        }
+    }
+
+    template<typename R>
+    LIBASSERT_ATTR_COLD
+    std::string stringify_range_element(const R& range, std::size_t index) {
+        return "[" + std::to_string(index) + "] "
+            + generate_stringification(*std::next(std::begin(range), static_cast<std::ptrdiff_t>(index)));
+    }
+
+    template<typename R>
+    LIBASSERT_ATTR_COLD
+    void add_range_diagnostics(assertion_info& info, const R& range, range_check_result result) {
+        const std::size_t size = range_size(range);
+        if(result.index < size) {
+            info.extra_diagnostics.push_back({ "index", generate_stringification(result.index) });
+            info.extra_diagnostics.push_back({
+                "value",
+                generate_stringification(*std::next(std::begin(range), static_cast<std::ptrdiff_t>(result.index)))
+            });
+        }
+        info.extra_diagnostics.push_back({ "size", generate_stringification(size) });
+    }
+
+    template<typename R, range_invariant I>
+    LIBASSERT_ATTR_COLD
+    void add_range_diagnostics(assertion_info& info, const R& range, range_invariant_result<I> result) {
+        const std::size_t size = range_size(range);
+        const bool is_heap = I == range_invariant::heap;
+        info.extra_diagnostics.push_back({ is_heap ? "parent" : "first", stringify_range_element(range, result.first) });
+        info.extra_diagnostics.push_back({ is_heap ? "child" : "second", stringify_range_element(range, result.second) });
+        // a few elements on either side of the (second) offending element
+        const std::size_t low = result.second > range_window_radius ? result.second - range_window_radius : 0;
+        const std::size_t high = std::min(size, result.second + range_window_radius + 1);
+        std::string window = "[" + std::to_string(low) + ".." + std::to_string(high - 1) + "]";
+        auto it = std::next(std::begin(range), static_cast<std::ptrdiff_t>(low));
+        for(std::size_t i = low; i < high; i++, ++it) {
+            window += i == low ? " " : ", ";
+            window += generate_stringification(*it);
+        }
+        info.extra_diagnostics.push_back({ "window", std::move(window) });
+        info.extra_diagnostics.push_back({ "size", generate_stringification(size) });
+    }
+
+    // process_assert_fail for range assertions, there are no binary diagnostics
+    template<typename R, typename Result, typename... Args>
+    LIBASSERT_ATTR_COLD LIBASSERT_ATTR_NOINLINE
+    void process_range_assert_fail(
+        const R& range,
+        Result result,
+        const assert_static_parameters* params,
+        // NOLINTNEXTLINE(cppcoreguidelines-missing-std-forward)
+        Args&&... args
+    ) {
+        const size_t sizeof_extra_diagnostics = sizeof...(args) - 1; // - 1 for pretty function signature
+        LIBASSERT_PRIMITIVE_DEBUG_ASSERT(sizeof...(args) <= params->args_strings.size);
+        process_failure(
+            params,
+            sizeof_extra_diagnostics,
+            [] { return std::optional<binary_diagnostics_descriptor>{}; },
+            [&] (assertion_info& info) {
+                // process_args fills in the message, extra_diagnostics, and pretty_function
+                process_args(info, params->args_strings, args...);
+                add_range_diagnostics(info, range, result);
+            }
+        );
+    }
+}
+
+// check is evaluated with the range bound to libassert_range and gives a range_check_result or range_invariant_result
+#define LIBASSERT_INVOKE_RANGE(check, range, expr_str, name, type, failaction, ...) \
+    do { \
+        LIBASSERT_COUNT_EVALUATION(true, name, expr_str) \
+        const auto& libassert_range = range; \
+        LIBASSERT_BEGIN_COST_SAMPLE() \
+        const auto libassert_range_result = check; \
+        if(LIBASSERT_STRONG_EXPECT(!LIBASSERT_END_COST_SAMPLE(libassert_range_result.passed), 0)) { \
+            libassert::ERROR_ASSERTION_FAILURE_IN_CONSTEXPR_CONTEXT(); \
+            LIBASSERT_COUNT_FAILURE() \
+            LIBASSERT_BREAKPOINT_IF_DEBUGGING_ON_FAIL(); \
+            failaction \
+            LIBASSERT_STATIC_DATA(name, libassert::assert_type::type, expr_str, __VA_ARGS__) \
+            libassert::detail::process_range_assert_fail( \
+                libassert_range, \
+                libassert_range_result, \
+                libassert_params \
+                LIBASSERT_VA_ARGS(__VA_ARGS__) LIBASSERT_PRETTY_FUNCTION_ARG \
+            ); \
+        } \
+    } while(false)
+
+#define LIBASSERT_INVOKE_RANGE_QUANTIFIER(quantifier, policy, range, pred, name, ...) \
+    LIBASSERT_INVOKE_RANGE( \
+        libassert::detail::check_range<libassert::detail::range_quantifier::quantifier>(policy, libassert_range, pred), \
+        range, \
+        #range ", " #pred, \
+        name, \
+        assertion, \
+        , \
+        __VA_ARGS__ \
+    )
+
+#define LIBASSERT_INVOKE_RANGE_INVARIANT(invariant, range, f, expr_str, name, ...) \
+    LIBASSERT_INVOKE_RANGE( \
+        libassert::detail::check_range_invariant<libassert::detail::range_invariant::invariant>(libassert_range, f), \
+        range, \
+        expr_str, \
+        name, \
+        assertion, \
+        , \
+        __VA_ARGS__ \
+    )
+
+#define LIBASSERT_NO_EXECUTION_POLICY libassert::detail::no_execution_policy{}
+
+#define LIBASSERT_ASSERT_ALL(range, pred, ...) \
+    LIBASSERT_INVOKE_RANGE_QUANTIFIER(all, LIBASSERT_NO_EXECUTION_POLICY, range, pred, "ASSERT_ALL", __VA_ARGS__)
+#define LIBASSERT_ASSERT_ANY(range, pred, ...) \
+    LIBASSERT_INVOKE_RANGE_QUANTIFIER(any, LIBASSERT_NO_EXECUTION_POLICY, range, pred, "ASSERT_ANY", __VA_ARGS__)
+#define LIBASSERT_ASSERT_NONE(range, pred, ...) \
+    LIBASSERT_INVOKE_RANGE_QUANTIFIER(none, LIBASSERT_NO_EXECUTION_POLICY, range, pred, "ASSERT_NONE", __VA_ARGS__)
+
+#define LIBASSERT_ASSERT_ALL_EXEC(policy, range, pred, ...) \
+    LIBASSERT_INVOKE_RANGE_QUANTIFIER(all, policy, range, pred, "ASSERT_ALL_EXEC", __VA_ARGS__)
+#define LIBASSERT_ASSERT_ANY_EXEC(policy, range, pred, ...) \
+    LIBASSERT_INVOKE_RANGE_QUANTIFIER(any, policy, range, pred, "ASSERT_ANY_EXEC", __VA_ARGS__)
+#define LIBASSERT_ASSERT_NONE_EXEC(policy, range, pred, ...) \
+    LIBASSERT_INVOKE_RANGE_QUANTIFIER(none, policy, range, pred, "ASSERT_NONE_EXEC", __VA_ARGS__)
+
+#define LIBASSERT_ASSERT_SORTED(range, ...) \
+    LIBASSERT_INVOKE_RANGE_INVARIANT(sorted, range, std::less<>{}, #range, "ASSERT_SORTED", __VA_ARGS__)
+#define LIBASSERT_ASSERT_SORTED_BY(range, comp, ...) \
+    LIBASSERT_INVOKE_RANGE_INVARIANT(sorted, range, comp, #range ", " #comp, "ASSERT_SORTED_BY", __VA_ARGS__)
+#define LIBASSERT_ASSERT_UNIQUE_SORTED(range, ...) \
+    LIBASSERT_INVOKE_RANGE_INVARIANT(unique_sorted, range, std::less<>{}, #range, "ASSERT_UNIQUE_SORTED", __VA_ARGS__)
+#define LIBASSERT_ASSERT_UNIQUE_SORTED_BY(range, comp, ...) \
+    LIBASSERT_INVOKE_RANGE_INVARIANT( \
+        unique_sorted, range, comp, #range ", " #comp, "ASSERT_UNIQUE_SORTED_BY", __VA_ARGS__ \
+    )
+#define LIBASSERT_ASSERT_PARTITIONED(range, pred, ...) \
+    LIBASSERT_INVOKE_RANGE_INVARIANT(partitioned, range, pred, #range ", " #pred, "ASSERT_PARTITIONED", __VA_ARGS__)
+#define LIBASSERT_ASSERT_HEAP(range, ...) \
+    LIBASSERT_INVOKE_RANGE_INVARIANT(heap, range, std::less<>{}, #range, "ASSERT_HEAP", __VA_ARGS__)
+#define LIBASSERT_ASSERT_HEAP_BY(range, comp, ...) \
+    LIBASSERT_INVOKE_RANGE_INVARIANT(heap, range, comp, #range ", " #comp, "ASSERT_HEAP_BY", __VA_ARGS__)
+
+#ifndef LIBASSERT_PREFIX_ASSERTIONS
+ #if LIBASSERT_IS_CLANG || LIBASSERT_IS_GCC || !LIBASSERT_NON_CONFORMANT_MSVC_PREPROCESSOR
+  #define ASSERT_ALL(...) LIBASSERT_ASSERT_ALL(__VA_ARGS__)
+  #define ASSERT_ANY(...) LIBASSERT_ASSERT_ANY(__VA_ARGS__)
+  #define ASSERT_NONE(...) LIBASSERT_ASSERT_NONE(__VA_ARGS__)
+  #define ASSERT_ALL_EXEC(...) LIBASSERT_ASSERT_ALL_EXEC(__VA_ARGS__)
+  #define ASSERT_ANY_EXEC(...) LIBASSERT_ASSERT_ANY_EXEC(__VA_ARGS__)
+  #define ASSERT_NONE_EXEC(...) LIBASSERT_ASSERT_NONE_EXEC(__VA_ARGS__)
+  #define ASSERT_SORTED(...) LIBASSERT_ASSERT_SORTED(__VA_ARGS__)
+  #define ASSERT_SORTED_BY(...) LIBASSERT_ASSERT_SORTED_BY(__VA_ARGS__)
+  #define ASSERT_UNIQUE_SORTED(...) LIBASSERT_ASSERT_UNIQUE_SORTED(__VA_ARGS__)
+  #define ASSERT_UNIQUE_SORTED_BY(...) LIBASSERT_ASSERT_UNIQUE_SORTED_BY(__VA_ARGS__)
+  #define ASSERT_PARTITIONED(...) LIBASSERT_ASSERT_PARTITIONED(__VA_ARGS__)
+  #define ASSERT_HEAP(...) LIBASSERT_ASSERT_HEAP(__VA_ARGS__)
+  #define ASSERT_HEAP_BY(...) LIBASSERT_ASSERT_HEAP_BY(__VA_ARGS__)
+ #else
+  #define ASSERT_ALL LIBASSERT_ASSERT_ALL
+  #define ASSERT_ANY LIBASSERT_ASSERT_ANY
+  #define ASSERT_NONE LIBASSERT_ASSERT_NONE
+  #define ASSERT_ALL_EXEC LIBASSERT_ASSERT_ALL_EXEC
+  #define ASSERT_ANY_EXEC LIBASSERT_ASSERT_ANY_EXEC
+  #define ASSERT_NONE_EXEC LIBASSERT_ASSERT_NONE_EXEC
+  #define ASSERT_SORTED LIBASSERT_ASSERT_SORTED
+  #define ASSERT_SORTED_BY LIBASSERT_ASSERT_SORTED_BY
+  #define ASSERT_UNIQUE_SORTED LIBASSERT_ASSERT_UNIQUE_SORTED
+  #define ASSERT_UNIQUE_SORTED_BY LIBASSERT_ASSERT_UNIQUE_SORTED_BY
+  #define ASSERT_PARTITIONED LIBASSERT_ASSERT_PARTITIONED
+  #define ASSERT_HEAP LIBASSERT_ASSERT_HEAP
+  #define ASSERT_HEAP_BY LIBASSERT_ASSERT_HEAP_BY
+ #endif
+#endif
+
+#endif
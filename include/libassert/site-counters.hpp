@@ -0,0 +1,242 @@
+#ifndef LIBASSERT_SITE_COUNTERS_HPP
+#define LIBASSERT_SITE_COUNTERS_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <libassert/platform.hpp>
+#include <libassert/utilities.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #define LIBASSERT_COST_CLOCK_RDTSC
+ #ifdef _MSC_VER
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+// =====================================================================================================================
+// || Per-site evaluation and failure counters                                                                        ||
+// =====================================================================================================================
+
+// When LIBASSERT_SITE_COUNTERS is defined before including <libassert/assert.hpp> every ASSERT, DEBUG_ASSERT, ASSUME,
+// and their _VAL forms count how often they are evaluated and how often they fail. Every site has a shard per thread
+// in thread-local storage so an evaluation only increments a thread-local counter, shards are only summed up when the
+// counters are read. Sites are registered with the calling thread on their first evaluation in that thread, counters of
+// exited threads are folded into the totals. Assertions in constexpr functions aren't counted when constant evaluated.
+//
+// LIBASSERT_SITE_COST_SAMPLING additionally times a random sample of evaluations per site, from before the expression is
+// evaluated until its result has been converted to bool. The sampling period of a site adapts to its measured cost so
+// that the time spent reading the clock stays below the fraction set by set_site_cost_budget. It implies
+// LIBASSERT_SITE_COUNTERS.
+
+namespace libassert::detail {
+    struct site_key {
+        std::string_view macro_name;
+        std::string_view expr_str;
+        source_location location;
+    };
+
+    // the counters of one site in one thread, only the owning thread writes to them
+    struct alignas(64) site_counter_shard {
+        std::atomic<std::uint64_t> evaluations = 0;
+        std::atomic<std::uint64_t> failures = 0;
+        const site_key* key = nullptr; // set once registered with the thread's shard list
+        // only used with LIBASSERT_SITE_COST_SAMPLING, the evaluation with this count is sampled
+        std::uint64_t next_cost_sample = 1;
+        std::atomic<std::uint64_t> sampled_evaluations = 0;
+        std::atomic<std::uint64_t> sampled_ticks = 0;
+    };
+
+    LIBASSERT_EXPORT void register_site_counter_shard(site_counter_shard& shard, const site_key* key);
+
+    // not an atomic increment, no other thread writes to the shard
+    LIBASSERT_ATTR_ALWAYS_INLINE void bump_site_counter(std::atomic<std::uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    LIBASSERT_ATTR_ALWAYS_INLINE
+    site_counter_shard* count_evaluation(site_counter_shard& shard, const site_key* key) {
+        if(LIBASSERT_STRONG_EXPECT(shard.key == nullptr, 0)) {
+            register_site_counter_shard(shard, key);
+        }
+        bump_site_counter(shard.evaluations);
+        return &shard;
+    }
+
+    LIBASSERT_ATTR_ALWAYS_INLINE void count_failure(site_counter_shard* shard) {
+        if(shard) {
+            bump_site_counter(shard->failures);
+        }
+    }
+
+    // rdtsc where available, otherwise the steady clock in nanoseconds
+    LIBASSERT_ATTR_ALWAYS_INLINE std::uint64_t cost_clock_now() {
+        #ifdef LIBASSERT_COST_CLOCK_RDTSC
+        return __rdtsc();
+        #else
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()
+            ).count()
+        );
+        #endif
+    }
+
+    // adds the sample and draws the next one
+    LIBASSERT_EXPORT void record_cost_sample(site_counter_shard& shard, std::uint64_t start, std::uint64_t end);
+
+    // returns 0 if this evaluation isn't sampled, comparing against the evaluation count avoids a store per evaluation
+    LIBASSERT_ATTR_ALWAYS_INLINE std::uint64_t begin_cost_sample(site_counter_shard* shard) {
+        if(
+            shard == nullptr
+            || LIBASSERT_STRONG_EXPECT(shard->evaluations.load(std::memory_order_relaxed) != shard->next_cost_sample, 1)
+        ) {
+            return 0;
+        }
+        // keep the expression from being moved out of the timed region
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        return cost_clock_now();
+    }
+
+    LIBASSERT_ATTR_ALWAYS_INLINE bool end_cost_sample(site_counter_shard* shard, std::uint64_t start, bool value) {
+        if(LIBASSERT_STRONG_EXPECT(start != 0, 0)) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+            const std::uint64_t end = cost_clock_now();
+            record_cost_sample(*shard, start, end);
+        }
+        return value;
+    }
+}
+
+// LIBASSERT_COMMA because these may end up in LIBASSERT_STMTEXPR's arguments
+// The statics live in a lambda since static and thread_local variables aren't allowed in constexpr functions pre-C++23
+// LIBASSERT_COUNT_EVALUATION goes before the expression is evaluated, check is false for _VAL forms which only evaluate
+#if defined(LIBASSERT_SITE_COUNTERS) || defined(LIBASSERT_SITE_COST_SAMPLING)
+ #define LIBASSERT_COUNT_EVALUATION(check, name, expr_str) \
+    [[maybe_unused]] libassert::detail::site_counter_shard* libassert_site_shard = nullptr; \
+    if constexpr(check) { \
+        if(!libassert::detail::is_constant_evaluated()) { \
+            libassert_site_shard = []() -> libassert::detail::site_counter_shard* { \
+                static constexpr libassert::detail::site_key libassert_site_key = { \
+                    name LIBASSERT_COMMA expr_str LIBASSERT_COMMA {} \
+                }; \
+                static thread_local libassert::detail::site_counter_shard libassert_shard; \
+                return libassert::detail::count_evaluation(libassert_shard LIBASSERT_COMMA &libassert_site_key); \
+            }(); \
+        } \
+    }
+ #define LIBASSERT_COUNT_FAILURE() libassert::detail::count_failure(libassert_site_shard);
+#else
+ #define LIBASSERT_COUNT_EVALUATION(check, name, expr_str)
+ #define LIBASSERT_COUNT_FAILURE()
+#endif
+
+#ifdef LIBASSERT_SITE_COST_SAMPLING
+ #define LIBASSERT_BEGIN_COST_SAMPLE() \
+    [[maybe_unused]] const std::uint64_t libassert_cost_sample_start = \
+        libassert::detail::begin_cost_sample(libassert_site_shard);
+ #define LIBASSERT_END_COST_SAMPLE(value) \
+    libassert::detail::end_cost_sample(libassert_site_shard LIBASSERT_COMMA libassert_cost_sample_start LIBASSERT_COMMA value)
+#else
+ #define LIBASSERT_BEGIN_COST_SAMPLE()
+ #define LIBASSERT_END_COST_SAMPLE(value) value
+#endif
+
+namespace libassert {
+    struct site_counter_snapshot {
+        std::string macro_name;
+        std::string expression;
+        std::string file_name;
+        std::uint32_t line;
+        std::uint64_t evaluations;
+        std::uint64_t failures;
+        // only with LIBASSERT_SITE_COST_SAMPLING, the cost of all evaluations estimated from the sampled ones
+        std::uint64_t sampled_evaluations = 0;
+        std::chrono::nanoseconds estimated_cost{0};
+    };
+
+    // sums up the shards of all threads, sites are in the order they were first evaluated
+    [[nodiscard]] LIBASSERT_EXPORT std::vector<site_counter_snapshot> site_counters();
+
+    // The fraction of a site's own evaluation time which may be spent on timing samples, 0.01 by default. Takes effect
+    // as each site draws its next sample.
+    LIBASSERT_EXPORT void set_site_cost_budget(double fraction);
+    [[nodiscard]] LIBASSERT_EXPORT double site_cost_budget();
+    // site_counters() sorted by estimated cost, most expensive first
+    [[nodiscard]] LIBASSERT_EXPORT std::vector<site_counter_snapshot> site_cost_ranking();
+    // a table of the rows most expensive sites
+    [[nodiscard]] LIBASSERT_EXPORT std::string site_cost_report(std::size_t rows = 20);
+
+    // Periodically publishes site_counters() into a file under /dev/shm which read_site_counters can sample from
+    // another process without stopping this one. Each publication is guarded by a sequence lock. The file is removed
+    // when the publisher is destroyed. Only supported on Linux.
+    class LIBASSERT_EXPORT site_counter_publisher {
+        std::string file_path;
+        int fd = -1;
+        unsigned char* base = nullptr;
+        std::size_t mapping_size = 0;
+        std::chrono::milliseconds interval;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stopping = false;
+        std::thread thread;
+        void publish_locked();
+    public:
+        // the default path is /dev/shm/libassert-<pid>.counters
+        // throws std::system_error if the file can't be created or mapped
+        explicit site_counter_publisher(
+            std::chrono::milliseconds interval = std::chrono::seconds(1),
+            std::string_view path = ""
+        );
+        ~site_counter_publisher();
+        site_counter_publisher(const site_counter_publisher&) = delete;
+        site_counter_publisher(site_counter_publisher&&) = delete;
+        site_counter_publisher& operator=(const site_counter_publisher&) = delete;
+        site_counter_publisher& operator=(site_counter_publisher&&) = delete;
+
+        void publish_now();
+        [[nodiscard]] const std::string& path() const noexcept;
+    };
+
+    [[nodiscard]] LIBASSERT_EXPORT std::string default_site_counter_path(std::uint64_t pid);
+
+    struct site_counter_sample {
+        std::uint64_t pid;
+        std::chrono::nanoseconds timestamp; // steady clock of the publishing process
+        std::uint64_t publications;
+        std::vector<site_counter_snapshot> sites;
+    };
+
+    // Reads the latest consistent publication from a site counter file
+    // throws std::system_error if the file can't be read, std::runtime_error if it isn't a site counter file or no
+    // consistent publication could be read
+    [[nodiscard]] LIBASSERT_EXPORT site_counter_sample read_site_counters(std::string_view path);
+
+    // A profile of a representative run, libassert-demote turns it into a site policy header. The duration is the time
+    // since the first site was evaluated. If LIBASSERT_SITE_PROFILE is set in the environment when the first site is
+    // evaluated the profile is written to that path at exit.
+    struct site_profile {
+        std::chrono::nanoseconds duration;
+        std::vector<site_counter_snapshot> sites;
+    };
+
+    // throws std::system_error if the file can't be written
+    LIBASSERT_EXPORT void write_site_profile(std::string_view path);
+    // throws std::system_error if the file can't be read, std::runtime_error if it isn't a site profile
+    [[nodiscard]] LIBASSERT_EXPORT site_profile read_site_profile(std::string_view path);
+}
+
+#endif
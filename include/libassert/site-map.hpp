@@ -0,0 +1,109 @@
+#ifndef LIBASSERT_SITE_MAP_HPP
+#define LIBASSERT_SITE_MAP_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <string>
+#include <vector>
+
+#include <libassert/platform.hpp>
+
+// =====================================================================================================================
+// || Site strings stripped into a sidecar map                                                                        ||
+// =====================================================================================================================
+
+// When LIBASSERT_STRIP_SITE_STRINGS is defined a site's code only holds a 64-bit site ID. Its macro name, file, line,
+// expression, and argument strings go into a record in the libassert_sites section which nothing references. After
+// linking, libassert-sites extract (or the libassert_strip_site_strings CMake function) turns the section into a site
+// map file and removes it from the binary. A failure is reported at "site#<id>:0" with the arguments named $1, $2, ...
+// and libassert-sites expand rewrites reports back using the site map. Requires GCC or Clang and an ELF target.
+
+namespace libassert::detail {
+    constexpr std::uint32_t site_record_magic = 0x3153414c; // "LAS1"
+
+    // Layout of a record in the libassert_sites section: the strings are the macro name, file, line, expression, and one
+    // per argument, separated by null characters and null terminated. Records are 4-byte aligned and may be padded
+    // with zeros.
+    template<std::size_t N>
+    struct site_record {
+        std::uint32_t magic;
+        std::uint32_t size;
+        char strings[N]; // NOLINT(*-avoid-c-arrays)
+    };
+
+    template<std::size_t N>
+    constexpr site_record<N> make_site_record(const char (&strings)[N]) { // NOLINT(*-avoid-c-arrays)
+        site_record<N> record{site_record_magic, static_cast<std::uint32_t>(N), {}};
+        for(std::size_t i = 0; i < N; i++) {
+            record.strings[i] = strings[i];
+        }
+        return record;
+    }
+
+    // FNV-1a over the strings without the final terminator
+    constexpr std::uint64_t site_id(const char* strings, std::size_t size) {
+        std::uint64_t hash = 0xcbf29ce484222325;
+        for(std::size_t i = 0; i + 1 < size; i++) {
+            hash ^= static_cast<unsigned char>(strings[i]);
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+    template<std::size_t N>
+    constexpr std::uint64_t site_id(const site_record<N>& record) {
+        return site_id(record.strings, N);
+    }
+
+    // the macro name, file, and line are followed by a terminator, each argument is preceded by one, and there's the
+    // final terminator. LIBASSERT_MAP leaves an empty argument at the end so this is one more than the number of
+    // arguments, which is fine for naming them.
+    template<std::size_t N>
+    constexpr std::size_t site_arg_count(const site_record<N>& record) {
+        std::size_t terminators = 0;
+        for(std::size_t i = 0; i < N; i++) {
+            if(record.strings[i] == '\0') {
+                terminators++;
+            }
+        }
+        return terminators - 4;
+    }
+}
+
+namespace libassert {
+    struct site_map_entry {
+        std::uint64_t id;
+        std::string macro_name;
+        std::string file_name;
+        std::uint32_t line;
+        std::string expression;
+        std::vector<std::string> args; // the message, if any, is the first
+    };
+
+    // Parses the contents of a libassert_sites section, sites that appear more than once (e.g. from inline functions
+    // in different objects that weren't merged) are only returned once. Throws std::runtime_error on malformed records.
+    [[nodiscard]] LIBASSERT_EXPORT std::vector<site_map_entry> parse_site_records(std::string_view section);
+    // One site per line, tab separated: id, macro name, file, line, expression, then the arguments. Tabs, newlines, and
+    // backslashes in strings are escaped. Throw std::system_error / std::runtime_error.
+    LIBASSERT_EXPORT void write_site_map(const std::string& path, const std::vector<site_map_entry>& sites);
+    [[nodiscard]] LIBASSERT_EXPORT std::vector<site_map_entry> read_site_map(const std::string& path);
+    // Rewrites failure reports in text: "site#<id>:0" becomes the file and line, the statement following it gets its
+    // expression back, and $n names in its extra diagnostics become the argument strings. Unknown IDs are left as is.
+    [[nodiscard]] LIBASSERT_EXPORT std::string expand_site_ids(
+        std::string_view text,
+        const std::vector<site_map_entry>& sites
+    );
+}
+
+#if defined(LIBASSERT_STRIP_SITE_STRINGS) && !(defined(__GNUC__) && defined(__ELF__))
+ #error "LIBASSERT_STRIP_SITE_STRINGS requires GCC or Clang and an ELF target"
+#endif
+
+#define LIBASSERT_STRIP_STRINGIFY_LINE_(x) #x
+#define LIBASSERT_STRIP_STRINGIFY_LINE(x) LIBASSERT_STRIP_STRINGIFY_LINE_(x)
+
+#endif
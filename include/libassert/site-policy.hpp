@@ -0,0 +1,112 @@
+#ifndef LIBASSERT_SITE_POLICY_HPP
+#define LIBASSERT_SITE_POLICY_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <cstddef>
+#include <cstdint>
+
+#include <libassert/platform.hpp>
+#include <libassert/utilities.hpp>
+
+// =====================================================================================================================
+// || Profile-guided demotion of hot assertions                                                                       ||
+// =====================================================================================================================
+
+// When LIBASSERT_SITE_POLICY_HEADER names a header generated by libassert-demote, ASSERT sites listed in it are demoted
+// where they are expanded: a debug_only site is checked like DEBUG_ASSERT and a sampled site only checks one in every
+// sample_period evaluations per thread. The lookup is done at compile time by the site's file and line, every other site
+// stays fully checked.
+
+namespace libassert::detail {
+    enum class site_policy : unsigned char {
+        checked,
+        debug_only,
+        sampled
+    };
+
+    struct demoted_site {
+        const char* file; // matched against the end of the site's file name at a path separator
+        int line;
+        site_policy policy;
+        std::uint32_t sample_period;
+    };
+
+    constexpr bool site_file_matches(const char* site_file, const char* file) {
+        std::size_t site_length = 0;
+        while(site_file[site_length] != '\0') {
+            site_length++;
+        }
+        std::size_t length = 0;
+        while(file[length] != '\0') {
+            length++;
+        }
+        if(length > site_length) {
+            return false;
+        }
+        const std::size_t offset = site_length - length;
+        for(std::size_t i = 0; i < length; i++) {
+            if(site_file[offset + i] != file[i]) {
+                return false;
+            }
+        }
+        return offset == 0 || site_file[offset - 1] == '/' || site_file[offset - 1] == '\\';
+    }
+}
+
+#include LIBASSERT_SITE_POLICY_HEADER
+
+namespace libassert::detail {
+    // demoted_sites is defined by the generated header and terminated by an entry with a null file
+    constexpr demoted_site find_site_policy(source_location location) {
+        for(const demoted_site* site = demoted_sites; site->file != nullptr; site++) {
+            if(site->line == location.line && site_file_matches(location.file, site->file)) {
+                return *site;
+            }
+        }
+        return {nullptr, location.line, site_policy::checked, 1};
+    }
+
+    // one in every period evaluations, starting with the first
+    LIBASSERT_ATTR_ALWAYS_INLINE bool sample_site(std::uint32_t& countdown, std::uint32_t period) {
+        if(countdown == 0) {
+            countdown = period - 1;
+            return true;
+        }
+        countdown--;
+        return false;
+    }
+}
+
+// The countdown lives in a lambda since thread_local variables aren't allowed in constexpr functions pre-C++23, sampled
+// sites are always checked during constant evaluation
+#define LIBASSERT_SAMPLE_SITE(period) \
+    (libassert::detail::is_constant_evaluated() || [] { \
+        static thread_local std::uint32_t libassert_countdown = 0; \
+        return libassert::detail::sample_site(libassert_countdown, period); \
+    }())
+
+#ifdef NDEBUG
+ #define LIBASSERT_INVOKE_DEBUG_ONLY(expr, name, type, failaction, ...)
+#else
+ #define LIBASSERT_INVOKE_DEBUG_ONLY(expr, name, type, failaction, ...) \
+    LIBASSERT_INVOKE(expr, name, type, failaction, __VA_ARGS__);
+#endif
+
+#define LIBASSERT_INVOKE_DEMOTABLE(expr, name, type, failaction, ...) \
+    do { \
+        constexpr libassert::detail::demoted_site libassert_site_policy = \
+            libassert::detail::find_site_policy(libassert::source_location{}); \
+        if constexpr(libassert_site_policy.policy == libassert::detail::site_policy::debug_only) { \
+            LIBASSERT_INVOKE_DEBUG_ONLY(expr, name, type, failaction, __VA_ARGS__) \
+        } else if constexpr(libassert_site_policy.policy == libassert::detail::site_policy::sampled) { \
+            if(LIBASSERT_SAMPLE_SITE(libassert_site_policy.sample_period)) { \
+                LIBASSERT_INVOKE(expr, name, type, failaction, __VA_ARGS__); \
+            } \
+        } else { \
+            LIBASSERT_INVOKE(expr, name, type, failaction, __VA_ARGS__); \
+        } \
+    } while(0)
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef LIBASSERT_SOCKET_SINK_HPP
+#define LIBASSERT_SOCKET_SINK_HPP
+
+// Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
+// https://github.com/jeremy-rifkin/libassert
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <string>
+
+#include <libassert/assert.hpp>
+
+#ifndef _WIN32
+
+// =====================================================================================================================
+// || Unix domain socket sink                                                                                         ||
+// =====================================================================================================================
+
+namespace libassert {
+    struct unix_socket_sink_options {
+        // path of the collector's SOCK_STREAM socket
+        std::string path;
+        // max number of records waiting to be sent, rounded up to a power of two
+        std::size_t queue_capacity = 1024;
+        // failure records larger than this have their report truncated, other payloads larger than this are dropped
+        std::size_t max_record_size = 64 * 1024;
+        // max number of bytes handed to the socket in one batch
+        std::size_t max_batch_size = 256 * 1024;
+        // how often the background thread flushes the queue
+        std::chrono::milliseconds flush_interval{50};
+    };
+
+    // Ships failure records to a local collector over a unix domain socket.
+    // Records are serialized on the failing thread and pushed onto a bounded lock-free queue, a background thread
+    // drains the queue in batches with non-blocking sends. When the queue is full or the collector isn't reachable
+    // records are dropped and counted rather than blocking the failing thread.
+    // Wire format: each record is a little-endian u32 byte count followed by that many bytes. Records made from an
+    // assertion_info contain the fields action, file, line, function, expression, message, and report (the full
+    // uncolored report), each itself a little-endian u32 byte count followed by the bytes.
+    class LIBASSERT_EXPORT unix_socket_sink {
+    public:
+        // defined in socket_sink.cpp, the installed failure handler keeps it alive while it flushes
+        class impl;
+    private:
+        std::shared_ptr<impl> pimpl;
+    public:
+        explicit unix_socket_sink(unix_socket_sink_options options);
+        // flushes for at most flush_interval and stops the background thread
+        ~unix_socket_sink();
+        unix_socket_sink(const unix_socket_sink&) = delete;
+        unix_socket_sink(unix_socket_sink&&) = delete;
+        unix_socket_sink& operator=(const unix_socket_sink&) = delete;
+        unix_socket_sink& operator=(unix_socket_sink&&) = delete;
+
+        // returns false if the record was dropped
+        bool submit(const assertion_info& info);
+        // submits a record with an arbitrary payload
+        bool submit(std::string_view payload);
+
+        // Synchronously sends everything queued so far, blocking for at most timeout. Returns true if everything was
+        // delivered. Called by the installed failure handler before a fatal abort.
+        bool flush(std::chrono::milliseconds timeout = std::chrono::seconds(1));
+
+        [[nodiscard]] std::uint64_t sent() const noexcept;
+        [[nodiscard]] std::uint64_t dropped() const noexcept;
+
+        // Sets a failure handler that submits to this sink, flushes, and then calls default_failure_handler. When the
+        // sink is destroyed the previous handler is restored unless another one was set since. Records still queued
+        // then are counted as dropped.
+        void install_failure_handler();
+    };
+
+    // serializes an assertion failure as a record payload, see unix_socket_sink
+    [[nodiscard]] LIBASSERT_EXPORT std::string serialize_failure_record(const assertion_info& info);
+}
+
+#endif
+
+#endif
@@ -2,8 +2,10 @@
 #define LIBASSERT_STRINGIFICATION_HPP
 
 #include <optional>
+#include <string_view>
 #include <string>
 #include <system_error>
+#include <vector>
 
 #include <libassert/platform.hpp>
 #include <libassert/utilities.hpp>
@@ -42,6 +44,16 @@ namespace libassert {
 }
 
 namespace libassert::detail {
+    [[nodiscard]] LIBASSERT_EXPORT std::string bstringf(const char* format, ...);
+
+    [[nodiscard]] LIBASSERT_EXPORT std::string prettify_type(std::string type);
+
+    template<typename T>
+    inline constexpr bool is_string_type =
+           isa<T, std::string>
+            || isa<T, std::string_view>
+            || is_c_string<T>;
+
     // What can be stringified
     // Base types:
     //  - anything string-like
@@ -444,4 +456,26 @@ namespace libassert::detail {
     }
 }
 
+// The failure path templates are explicitly instantiated in the library for common operand types. With
+// LIBASSERT_PREBUILT_STRINGIFICATION other translation units only get instantiation declarations for them and use the
+// library's copies. It's opt-in since a libassert::stringifier specialization for one of these types would then be
+// ignored without a diagnostic. Types are written as T const& so that const char* works.
+#define LIBASSERT_FOR_EACH_PREBUILT_TYPE(X) \
+    X(bool) X(char) X(int) X(long) X(long long) X(unsigned) X(unsigned long) X(unsigned long long) X(float) X(double) \
+    X(const char*) X(std::string) X(std::string_view) \
+    X(std::vector<int>) X(std::vector<double>) X(std::vector<std::string>)
+
+// extern_ is either extern or empty
+#define LIBASSERT_STRINGIFICATION_INSTANTIATIONS(extern_, T) \
+    extern_ template LIBASSERT_EXPORT std::string do_stringify<T>(T const&); \
+    extern_ template LIBASSERT_EXPORT std::string generate_stringification<T>(T const&);
+
+#ifdef LIBASSERT_PREBUILT_STRINGIFICATION
+namespace libassert::detail {
+    #define LIBASSERT_X(T) LIBASSERT_STRINGIFICATION_INSTANTIATIONS(extern, T)
+    LIBASSERT_FOR_EACH_PREBUILT_TYPE(LIBASSERT_X)
+    #undef LIBASSERT_X
+}
+#endif
+
 #endif
@@ -2,7 +2,6 @@
 #define LIBASSERT_UTILITIES_HPP
 
 #include <type_traits>
-#include <string>
 #include <string_view>
 
 #include <libassert/platform.hpp>
@@ -62,8 +61,6 @@ namespace libassert::detail {
 // =====================================================================================================================
 
 namespace libassert::detail {
-    [[nodiscard]] LIBASSERT_EXPORT std::string bstringf(const char* format, ...);
-
     LIBASSERT_ATTR_COLD [[nodiscard]]
     constexpr inline std::string_view substring_bounded_by(
         std::string_view sig,
@@ -91,8 +88,6 @@ namespace libassert::detail {
          return LIBASSERT_PFUNC;
         #endif
     }
-
-    [[nodiscard]] LIBASSERT_EXPORT std::string prettify_type(std::string type);
 }
 
 // =====================================================================================================================
@@ -125,12 +120,6 @@ namespace libassert::detail {
            isa<std::decay_t<strip<T>>, char*> // <- covers literals (i.e. const char(&)[N]) too
             || isa<std::decay_t<strip<T>>, const char*>;
 
-    template<typename T>
-    inline constexpr bool is_string_type =
-           isa<T, std::string>
-            || isa<T, std::string_view>
-            || is_c_string<T>;
-
     // char(&)[20], const char(&)[20], const char(&)[]
     template<typename T> inline constexpr bool is_string_literal =
            std::is_lvalue_reference_v<T>
@@ -3,8 +3,6 @@
 #include <cctype>
 #include <initializer_list>
 #include <iterator>
-#include <memory>
-#include <mutex>
 #include <regex>
 #include <set>
 #include <stdexcept>
@@ -42,6 +40,7 @@ namespace libassert::detail {
 
     LIBASSERT_ATTR_COLD
     std::string prettify_type(std::string type) {
+        phase_timer timer(failure_phase::type_prettification);
         // > > -> >> replacement
         // could put in analysis:: but the replacement is basic and this is more convenient for
         // using in the stringifier too
@@ -83,15 +82,10 @@ namespace libassert::detail {
     class analysis {
     public:
         // Analysis singleton, lazy-initialize all the regex nonsense
-        // 8 BSS bytes and <512 bytes heap bytes not a problem
-        static std::unique_ptr<analysis> analysis_singleton;
-        static std::mutex singleton_mutex;
+        // A function-local static so that there's no global constructor or destructor registered at startup
         static analysis& get() {
-            const std::unique_lock lock(singleton_mutex);
-            if(analysis_singleton == nullptr) {
-                analysis_singleton = std::unique_ptr<analysis>(new analysis);
-            }
-            return *analysis_singleton;
+            static analysis analysis_singleton;
+            return analysis_singleton;
         }
 
         std::regex escapes_re;
@@ -648,11 +642,9 @@ namespace libassert::detail {
         }
     };
 
-    std::unique_ptr<analysis> analysis::analysis_singleton;
-    std::mutex analysis::singleton_mutex;
-
     LIBASSERT_ATTR_COLD
     std::string highlight(std::string_view expression, const color_scheme& scheme) {
+        phase_timer timer(failure_phase::highlighting);
         if(scheme == libassert::color_scheme::blank) {
             return std::string(expression);
         } else {
@@ -672,6 +664,7 @@ namespace libassert::detail {
     LIBASSERT_ATTR_COLD
     std::vector<highlight_block> highlight_blocks(std::string_view expression, const color_scheme& scheme) {
         // TODO: Maybe check scheme == libassert::color_scheme::blank here? Have to consult ramifications.
+        phase_timer timer(failure_phase::highlighting);
         return analysis::get().highlight(expression, scheme);
     }
 
@@ -692,6 +685,7 @@ namespace libassert::detail {
         std::string_view expression,
         std::string_view target_op
     ) {
+        phase_timer timer(failure_phase::decomposition);
         return analysis::get().decompose_expression(expression, target_op);
     }
 }
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include <libassert/assert.hpp>
@@ -22,6 +23,9 @@ namespace libassert::detail {
 
     LIBASSERT_ATTR_COLD literal_format get_literal_format(std::string_view expression);
 
+    // the literal format mode and the fixed formats, see stringification.cpp
+    std::pair<literal_format_mode, literal_format> get_literal_format_config();
+
     LIBASSERT_ATTR_COLD std::string_view trim_suffix(std::string_view expression);
 
     LIBASSERT_ATTR_COLD bool is_bitwise(std::string_view op);
@@ -1,4 +1,5 @@
 #include <libassert/assert.hpp>
+#include <libassert/assertion-failure.hpp>
 
 // Copyright (c) 2021-2024 Jeremy Rifkin under the MIT license
 // https://github.com/jeremy-rifkin/libassert
@@ -10,9 +11,10 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <regex>
 #include <string_view>
 #include <string>
@@ -20,16 +22,10 @@
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
-#if defined(__has_include) && __has_include(<cpptrace/basic.hpp>)
- #include <cpptrace/basic.hpp>
- #include <cpptrace/exceptions.hpp>
-#else
- #include <cpptrace/cpptrace.hpp>
-#endif
-
 #include "common.hpp"
 #include "utils.hpp"
 #include "microfmt.hpp"
@@ -37,6 +33,7 @@
 #include "platform.hpp"
 #include "paths.hpp"
 #include "printing.hpp"
+#include "stacktrace.hpp"
 
 #if LIBASSERT_IS_MSVC
  // wchar -> char string warning
@@ -52,23 +49,79 @@ namespace libassert::detail {
      */
 
     LIBASSERT_ATTR_COLD
-    auto get_trace_window(const cpptrace::stacktrace& trace) {
+    auto get_trace_window(const std::vector<trace_frame>& trace) {
         // Two boundaries: assert_detail and main
         // Both are found here, nothing is filtered currently at stack trace generation
         // (inlining and platform idiosyncrasies interfere)
         size_t start = 0;
-        size_t end = trace.frames.size() - 1;
-        for(size_t i = 0; i < trace.frames.size(); i++) {
-            if(trace.frames[i].symbol.find("libassert::detail::") != std::string::npos) {
+        size_t end = trace.size() - 1;
+        for(size_t i = 0; i < trace.size(); i++) {
+            if(trace[i].symbol.find("libassert::detail::") != std::string::npos) {
                 start = i + 1;
             }
-            if(trace.frames[i].symbol == "main" || trace.frames[i].symbol.find("main(") == 0) {
+            if(trace[i].symbol == "main" || trace[i].symbol.find("main(") == 0) {
                 end = i;
             }
         }
         return std::pair(start, end);
     }
 
+    // Signatures and file names recovered from traces are interned so they outlive the trace and the assertion_info
+    // like a __PRETTY_FUNCTION__ or __FILE__ would
+    LIBASSERT_ATTR_COLD std::string_view intern_trace_string(const std::string& name) {
+        static std::mutex mutex;
+        static std::unordered_set<std::string> names;
+        std::unique_lock lock(mutex);
+        return *names.insert(name).first;
+    }
+
+    // Only a prefix of the trace is resolved, the trace itself is left raw for the failure handler. The first frame
+    // outside of libassert::detail is the one the assertion is in.
+    LIBASSERT_ATTR_COLD std::optional<trace_frame> caller_frame(const raw_trace_type& trace) {
+        constexpr std::size_t max_library_frames = 16;
+        auto prefix = resolve_trace_prefix(trace, max_library_frames);
+        std::optional<std::size_t> last_library_frame;
+        for(std::size_t i = 0; i < prefix.size(); i++) {
+            // libassert::checked's algorithms and libassert::checked_span report failures from inside the library as
+            // well
+            if(
+                prefix[i].symbol.find("libassert::detail::") != std::string::npos
+                || prefix[i].symbol.find("libassert::checked") != std::string::npos
+            ) {
+                last_library_frame = i;
+            }
+        }
+        if(!last_library_frame || *last_library_frame + 1 >= prefix.size()) {
+            return std::nullopt;
+        }
+        return std::move(prefix[*last_library_frame + 1]);
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::string_view function_from_trace(const raw_trace_type& trace) {
+        const auto frame = caller_frame(trace);
+        if(!frame) {
+            return "<unknown>";
+        }
+        std::string symbol = frame->symbol;
+        // the failure path is often split into a "f() [clone .cold]" fragment
+        const auto clone = symbol.find(" [clone ");
+        if(clone != std::string::npos) {
+            symbol.erase(clone);
+        }
+        if(symbol.empty() || symbol == "??") {
+            return "<unknown>";
+        }
+        return intern_trace_string(symbol);
+    }
+
+    LIBASSERT_ATTR_COLD source_location location_from_trace(const raw_trace_type& trace) {
+        const auto frame = caller_frame(trace);
+        if(!frame || frame->filename.empty() || !frame->line) {
+            return {"<unknown>", 0};
+        }
+        return {intern_trace_string(frame->filename).data(), static_cast<int>(*frame->line)};
+    }
+
     struct stacktrace_result {
         std::string printed;
     };
@@ -77,7 +130,7 @@ namespace libassert::detail {
     // TODO
     // NOLINTNEXTLINE(readability-function-cognitive-complexity)
     std::string print_stacktrace(
-        const cpptrace::stacktrace& trace,
+        const std::vector<trace_frame>& trace,
         int term_width,
         const color_scheme& scheme,
         path_handler* path_handler
@@ -92,7 +145,7 @@ namespace libassert::detail {
         size_t max_file_length = 0;
         for(std::size_t i = start; i <= end; i++) {
             max_file_length = std::max(
-                path_handler->resolve_path(trace.frames[i].filename).size(),
+                path_handler->resolve_path(trace[i].filename).size(),
                 max_file_length
             );
         }
@@ -104,7 +157,7 @@ namespace libassert::detail {
                 trace.begin() + start,
                 // NOLINTNEXTLINE(bugprone-narrowing-conversions,cppcoreguidelines-narrowing-conversions)
                 trace.begin() + end + 1,
-                [](const cpptrace::stacktrace_frame& a, const cpptrace::stacktrace_frame& b) {
+                [](const trace_frame& a, const trace_frame& b) {
                     return a.line.value_or(0) < b.line.value_or(0);
                 }
             )->line;
@@ -113,14 +166,14 @@ namespace libassert::detail {
         // do the actual trace printing
         std::string stacktrace;
         for(size_t i = start; i <= end; i++) {
-            const auto& [raw_address, obj_address, line, col, source_path, signature_, is_inline] = trace.frames[i];
+            const auto& [address, line, source_path, signature_] = trace[i];
             const std::string line_number = line.has_value() ? std::to_string(line.value()) : "?";
             // look for repeats, i.e. recursion we can fold
             size_t recursion_folded = 0;
             if(end - i >= 4) {
                 size_t j = 1;
                 for( ; i + j <= end; j++) {
-                    if(trace.frames[i + j] != trace.frames[i] || trace.frames[i + j].symbol == "??") {
+                    if(trace[i + j] != trace[i] || trace[i + j].symbol == "??") {
                         break;
                     }
                 }
@@ -224,7 +277,8 @@ namespace libassert::detail {
 
     constexpr int min_term_width = 50;
     constexpr size_t where_indent = 8;
-    std::string arrow = "=>";
+    // points to a string literal or to set_separator's copy, either way there's nothing to construct at startup
+    std::string_view arrow = "=>";
 
     LIBASSERT_ATTR_COLD [[nodiscard]]
     std::string print_binary_diagnostics(
@@ -350,6 +404,46 @@ namespace libassert::detail {
         }
         return output;
     }
+
+    struct decoded_static_parameters {
+        std::vector<std::string_view> args_strings;
+        assert_static_parameters params;
+    };
+
+    // Identical string literals from different sites can be merged by the linker so a site is identified by its
+    // location and macro name as well
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT const assert_static_parameters* decode_static_parameters(
+        const char* macro_name,
+        assert_type type,
+        std::string_view strings,
+        source_location location
+    ) {
+        using site_key = std::tuple<const char*, const char*, const char*, int>;
+        static std::mutex mutex;
+        static std::map<site_key, std::unique_ptr<decoded_static_parameters>> sites;
+        std::unique_lock lock(mutex);
+        auto& decoded = sites[{strings.data(), macro_name, location.file, location.line}];
+        if(!decoded) {
+            decoded = std::make_unique<decoded_static_parameters>();
+            auto separator = strings.find('\0');
+            const std::string_view expr_str = strings.substr(0, separator);
+            while(separator != std::string_view::npos) {
+                const auto next = strings.find('\0', separator + 1);
+                decoded->args_strings.push_back(strings.substr(separator + 1, next - (separator + 1)));
+                separator = next;
+            }
+            // trailing terminator, as in the arrays LIBASSERT_STATIC_DATA emits otherwise
+            decoded->args_strings.emplace_back("");
+            decoded->params = {
+                macro_name,
+                type,
+                expr_str,
+                location,
+                {decoded->args_strings.data(), decoded->args_strings.size()}
+            };
+        }
+        return &decoded->params;
+    }
 }
 
 namespace libassert {
@@ -388,7 +482,8 @@ namespace libassert {
     LIBASSERT_EXPORT const color_scheme color_scheme::blank;
 
     std::mutex color_scheme_mutex;
-    color_scheme current_color_scheme = color_scheme::ansi_rgb;
+    // empty until set_color_scheme is called, copying ansi_rgb here would need a dynamic initializer
+    std::optional<color_scheme> current_color_scheme;
 
     LIBASSERT_EXPORT void set_color_scheme(const color_scheme& scheme) {
         std::unique_lock lock(color_scheme_mutex);
@@ -397,11 +492,13 @@ namespace libassert {
 
     LIBASSERT_EXPORT const color_scheme& get_color_scheme() {
         std::unique_lock lock(color_scheme_mutex);
-        return current_color_scheme;
+        return current_color_scheme ? *current_color_scheme : color_scheme::ansi_rgb;
     }
 
     LIBASSERT_EXPORT void set_separator(std::string_view separator) {
-        detail::arrow = separator;
+        static std::string custom_separator;
+        custom_separator = separator;
+        detail::arrow = custom_separator;
     }
 
     std::atomic<path_mode> current_path_mode = path_mode::disambiguated;
@@ -434,7 +531,12 @@ namespace libassert {
             terminal_width(STDERR_FILENO),
             isatty(STDERR_FILENO) ? get_color_scheme() : color_scheme::blank
         );
-        std::cerr << message << std::endl;
+        {
+            detail::phase_timer timer(failure_phase::output);
+            message += '\n';
+            (void)std::fwrite(message.data(), 1, message.size(), stderr);
+            (void)std::fflush(stderr);
+        }
         switch(info.type) {
             case assert_type::assertion:
             case assert_type::debug_assertion:
@@ -464,11 +566,55 @@ namespace libassert {
     }
 
     namespace detail {
-        LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void fail(const assertion_info& info) {
+        LIBASSERT_ATTR_COLD
+        failure_handler_type exchange_failure_handler(failure_handler_type handler) {
+            return get_failure_handler().exchange(handler);
+        }
+
+        LIBASSERT_ATTR_COLD
+        bool replace_failure_handler(failure_handler_type expected, failure_handler_type desired) {
+            return get_failure_handler().compare_exchange_strong(expected, desired);
+        }
+    }
+
+    namespace detail {
+        // the assertion_info currently being passed to the failure handler, which throwing_failure_handler may take
+        // ownership of instead of copying
+        thread_local assertion_info* failing_info = nullptr;
+
+        class failing_info_scope {
+            assertion_info* previous;
+        public:
+            explicit failing_info_scope(assertion_info& info) : previous(failing_info) {
+                failing_info = &info;
+            }
+            ~failing_info_scope() {
+                failing_info = previous;
+            }
+            failing_info_scope(const failing_info_scope&) = delete;
+            failing_info_scope(failing_info_scope&&) = delete;
+            failing_info_scope& operator=(const failing_info_scope&) = delete;
+            failing_info_scope& operator=(failing_info_scope&&) = delete;
+        };
+
+        LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void fail(assertion_info& info) {
+            failing_info_scope scope(info);
             detail::get_failure_handler().load()(info);
         }
     }
 
+    [[noreturn]] LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void throwing_failure_handler(const assertion_info& info) {
+        if(&info == detail::failing_info) {
+            // nothing reads the info once the handler exits
+            assertion_info& owned = *detail::failing_info;
+            detail::failing_info = nullptr;
+            throw assertion_failure(std::move(owned));
+        } else {
+            throw assertion_failure(info);
+        }
+    }
+
     LIBASSERT_ATTR_COLD binary_diagnostics_descriptor::binary_diagnostics_descriptor() = default;
     LIBASSERT_ATTR_COLD binary_diagnostics_descriptor::binary_diagnostics_descriptor(
         std::string_view _left_expression,
@@ -494,7 +640,7 @@ namespace libassert {
 
     LIBASSERT_ATTR_COLD assertion_info::assertion_info(
         const assert_static_parameters* static_params,
-        cpptrace::raw_trace&& _raw_trace,
+        raw_trace_type&& _raw_trace,
         size_t _n_args
     ) :
         macro_name(static_params->macro_name),
@@ -503,8 +649,13 @@ namespace libassert {
         file_name(static_params->location.file),
         line(static_params->location.line),
         function("<error>"),
-        n_args(_n_args),
-        trace(std::move(_raw_trace)) {}
+        n_args(_n_args)
+        #ifndef LIBASSERT_STACKTRACE_BACKEND_NONE
+        , trace(std::move(_raw_trace))
+        #endif
+    {
+        (void)_raw_trace; // unused without a stack trace backend
+    }
 
     LIBASSERT_ATTR_COLD assertion_info::~assertion_info() = default;
 
@@ -517,8 +668,7 @@ namespace libassert {
             // if this is a disambiguating handler or similar it needs to be fed all paths
             if(path_handler->has_add_path()) {
                 path_handler->add_path(file_name);
-                const auto& stacktrace = get_stacktrace();
-                for(const auto& frame : stacktrace.frames) {
+                for(const auto& frame : trace_frames(get_stacktrace())) {
                     path_handler->add_path(frame.filename);
                 }
                 path_handler->finalize();
@@ -539,7 +689,25 @@ namespace libassert {
         }
     }
 
-    LIBASSERT_ATTR_COLD const cpptrace::raw_trace& assertion_info::get_raw_trace() const {
+    #if defined(LIBASSERT_STACKTRACE_BACKEND_NONE)
+    LIBASSERT_ATTR_COLD const raw_trace_type& assertion_info::get_raw_trace() const {
+        static constexpr empty_trace trace{};
+        return trace;
+    }
+
+    LIBASSERT_ATTR_COLD const stacktrace_type& assertion_info::get_stacktrace() const {
+        return get_raw_trace();
+    }
+    #elif defined(LIBASSERT_STACKTRACE_BACKEND_STDLIB)
+    LIBASSERT_ATTR_COLD const raw_trace_type& assertion_info::get_raw_trace() const {
+        return trace;
+    }
+
+    LIBASSERT_ATTR_COLD const stacktrace_type& assertion_info::get_stacktrace() const {
+        return trace;
+    }
+    #else
+    LIBASSERT_ATTR_COLD const raw_trace_type& assertion_info::get_raw_trace() const {
         try {
             return std::get<cpptrace::raw_trace>(trace);
         } catch(std::bad_variant_access&) {
@@ -547,16 +715,19 @@ namespace libassert {
         }
     }
 
-    LIBASSERT_ATTR_COLD const cpptrace::stacktrace& assertion_info::get_stacktrace() const {
+    LIBASSERT_ATTR_COLD const stacktrace_type& assertion_info::get_stacktrace() const {
         if(trace.index() == 0) {
             // do resolution
+            phase_timer timer(failure_phase::symbolization);
             auto raw_trace = std::move(std::get<cpptrace::raw_trace>(trace));
             trace = raw_trace.resolve();
         }
         return std::get<cpptrace::stacktrace>(trace);
     }
+    #endif
 
     std::string assertion_info::header(int width, const color_scheme& scheme) const {
+        phase_timer timer(failure_phase::layout);
         return tagline(scheme)
             + statement(scheme)
             + print_binary_diagnostics(width, scheme)
@@ -564,6 +735,7 @@ namespace libassert {
     }
 
     std::string assertion_info::tagline(const color_scheme& scheme) const {
+        phase_timer timer(failure_phase::layout);
         const auto prettified_function = prettify_type(std::string(function));
         if(message && !message->empty()) {
             return microfmt::format(
@@ -586,10 +758,12 @@ namespace libassert {
     }
 
     std::string assertion_info::location() const {
+        phase_timer timer(failure_phase::layout);
         return microfmt::format("{}:{}", get_path_handler()->resolve_path(file_name), line);
     }
 
     std::string assertion_info::statement(const color_scheme& scheme) const {
+        phase_timer timer(failure_phase::layout);
         return microfmt::format(
             "    {}\n",
             highlight(
@@ -605,6 +779,7 @@ namespace libassert {
     }
 
     std::string assertion_info::print_binary_diagnostics(int width, const color_scheme& scheme) const {
+        phase_timer timer(failure_phase::layout);
         if(binary_diagnostics) {
             return libassert::detail::print_binary_diagnostics(*binary_diagnostics, width, scheme);
         } else {
@@ -613,6 +788,7 @@ namespace libassert {
     }
 
     std::string assertion_info::print_extra_diagnostics(int width, const color_scheme& scheme) const {
+        phase_timer timer(failure_phase::layout);
         if(!extra_diagnostics.empty()) {
             return libassert::detail::print_extra_diagnostics(extra_diagnostics, width, scheme);
         } else {
@@ -621,11 +797,19 @@ namespace libassert {
     }
 
     std::string assertion_info::print_stacktrace(int width, const color_scheme& scheme) const {
-        std::string output = "Stack trace:\n";
-        return libassert::detail::print_stacktrace(get_stacktrace(), width, scheme, get_path_handler());
+        #ifdef LIBASSERT_STACKTRACE_BACKEND_NONE
+        (void)width;
+        (void)scheme;
+        return "";
+        #else
+        phase_timer timer(failure_phase::layout);
+        const auto frames = trace_frames(get_stacktrace());
+        return libassert::detail::print_stacktrace(frames, width, scheme, get_path_handler());
+        #endif
     }
 
     LIBASSERT_ATTR_COLD std::string assertion_info::to_string(int width, const color_scheme& scheme) const {
+        phase_timer timer(failure_phase::layout);
         // auto& stacktrace = get_stacktrace(); // TODO
         // now do output
         std::string output;
@@ -635,8 +819,10 @@ namespace libassert {
         output += print_binary_diagnostics(width, scheme);
         output += print_extra_diagnostics(width, scheme);
         // generate stack trace
+        #ifndef LIBASSERT_STACKTRACE_BACKEND_NONE
         output += "\nStack trace:\n";
         output += print_stacktrace(width, scheme);
+        #endif
         return output;
     }
 }
@@ -644,8 +830,19 @@ namespace libassert {
 namespace libassert {
     LIBASSERT_ATTR_COLD LIBASSERT_ATTR_NOINLINE [[nodiscard]]
     std::string stacktrace(int width, const color_scheme& scheme, std::size_t skip) {
+        #if defined(LIBASSERT_STACKTRACE_BACKEND_NONE)
+        (void)width;
+        (void)scheme;
+        (void)skip;
+        return "";
+        #else
+         #if defined(LIBASSERT_STACKTRACE_BACKEND_STDLIB)
+        auto trace = std::stacktrace::current(skip + 1);
+         #else
         auto trace = cpptrace::generate_trace(skip + 1);
+         #endif
         detail::identity_path_handler handler;
-        return print_stacktrace(trace, width, scheme, &handler);
+        return print_stacktrace(trace_frames(trace), width, scheme, &handler);
+        #endif
     }
 }
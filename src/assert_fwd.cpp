@@ -0,0 +1,216 @@
+#include <libassert/assert-fwd.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <string>
+#include <utility>
+
+#include "common.hpp"
+#include "utils.hpp"
+
+#include <libassert/assert.hpp>
+
+// The failure path of <libassert/assert-fwd.hpp>'s macros. It mirrors process_assert_fail and process_panic in
+// assert.hpp with the values already reduced to fwd_values by the site.
+
+namespace libassert::detail {
+    namespace {
+        using kind = fwd_value::kind;
+
+        // integers and floating point numbers are stringified as their original type so the literal formats come out
+        // the same as with <libassert/assert.hpp>
+        LIBASSERT_ATTR_COLD std::string stringify_signed(long long value, std::size_t size) {
+            switch(size) {
+                case sizeof(signed char): return generate_stringification(static_cast<signed char>(value));
+                case sizeof(short):       return generate_stringification(static_cast<short>(value));
+                case sizeof(int):         return generate_stringification(static_cast<int>(value));
+                default:                  return generate_stringification(value);
+            }
+        }
+
+        LIBASSERT_ATTR_COLD std::string stringify_unsigned(unsigned long long value, std::size_t size) {
+            switch(size) {
+                case sizeof(unsigned char):  return generate_stringification(static_cast<unsigned char>(value));
+                case sizeof(unsigned short): return generate_stringification(static_cast<unsigned short>(value));
+                case sizeof(unsigned int):   return generate_stringification(static_cast<unsigned int>(value));
+                default:                     return generate_stringification(value);
+            }
+        }
+
+        LIBASSERT_ATTR_COLD std::string stringify_fwd_value(const fwd_value& value) {
+            switch(value.value_kind) {
+                case kind::boolean:
+                    return generate_stringification(value.boolean);
+                case kind::character:
+                    return generate_stringification(value.character);
+                case kind::signed_integer:
+                    return stringify_signed(value.signed_integer, value.size);
+                case kind::unsigned_integer:
+                    return stringify_unsigned(value.unsigned_integer, value.size);
+                case kind::signed_enum:
+                    return bstringf(
+                        "enum %s: %s",
+                        prettify_type(std::string(value.type)).c_str(),
+                        stringify_signed(value.signed_integer, value.size).c_str()
+                    );
+                case kind::unsigned_enum:
+                    return bstringf(
+                        "enum %s: %s",
+                        prettify_type(std::string(value.type)).c_str(),
+                        stringify_unsigned(value.unsigned_integer, value.size).c_str()
+                    );
+                case kind::floating_point:
+                    if(value.size == sizeof(float)) {
+                        return generate_stringification(static_cast<float>(value.floating_point));
+                    } else if(value.size == sizeof(double)) {
+                        return generate_stringification(static_cast<double>(value.floating_point));
+                    } else {
+                        return generate_stringification(value.floating_point);
+                    }
+                case kind::null_pointer:
+                    return generate_stringification(nullptr);
+                case kind::pointer:
+                    return prettify_type(std::string(value.type))
+                        + ": "
+                        + stringification::stringify_pointer_value(value.pointer);
+                case kind::c_string:
+                    return generate_stringification(value.c_string);
+                case kind::string:
+                    return generate_stringification(value.string);
+                case kind::other:
+                default:
+                    return bstringf("<instance of %s>", prettify_type(std::string(value.type)).c_str());
+            }
+        }
+
+        LIBASSERT_ATTR_COLD bool is_arithmetic(const fwd_value& value) {
+            return value.value_kind == kind::signed_integer
+                || value.value_kind == kind::unsigned_integer
+                || value.value_kind == kind::floating_point;
+        }
+
+        LIBASSERT_ATTR_COLD binary_diagnostics_descriptor fwd_binary_diagnostic(
+            const fwd_value& left,
+            const fwd_value& right,
+            std::string_view left_str,
+            std::string_view right_str,
+            std::string_view op
+        ) {
+            const bool either_is_character = left.value_kind == kind::character || right.value_kind == kind::character;
+            const bool either_is_arithmetic = is_arithmetic(left) || is_arithmetic(right);
+            const literal_format previous_format = set_literal_format(
+                left_str,
+                right_str,
+                op,
+                either_is_character && either_is_arithmetic
+            );
+            binary_diagnostics_descriptor descriptor(
+                left_str,
+                right_str,
+                stringify_fwd_value(left),
+                stringify_fwd_value(right),
+                has_multiple_formats()
+            );
+            restore_literal_format(previous_format);
+            return descriptor;
+        }
+
+        LIBASSERT_ATTR_COLD std::optional<binary_diagnostics_descriptor> fwd_binary_diagnostics(
+            const fwd_value* operands,
+            std::string_view op,
+            const assert_static_parameters* params
+        ) {
+            if(op.empty()) {
+                if(operands[0].value_kind == kind::boolean) {
+                    return std::nullopt;
+                }
+                fwd_value true_value{};
+                make_fwd_value(true_value, true);
+                return fwd_binary_diagnostic(operands[0], true_value, params->expr_str, "true", "==");
+            }
+            auto [left_expression, right_expression] = decompose_expression(params->expr_str, op);
+            return fwd_binary_diagnostic(operands[0], operands[1], left_expression, right_expression, op);
+        }
+
+        LIBASSERT_ATTR_COLD void process_fwd_args(
+            assertion_info& info,
+            const assert_static_parameters* params,
+            const fwd_value* args,
+            std::size_t n_args,
+            const char* pretty_function
+        ) {
+            LIBASSERT_PRIMITIVE_DEBUG_ASSERT(n_args < params->args_strings.size);
+            for(std::size_t i = 0; i < n_args; i++) {
+                const auto& arg = args[i];
+                const auto arg_string = params->args_strings.data[i];
+                if(
+                    arg.value_kind == kind::signed_integer
+                    && arg.size == sizeof(int)
+                    && arg_string == errno_expansion
+                ) {
+                    const int err = static_cast<int>(arg.signed_integer);
+                    info.extra_diagnostics.push_back({ "errno", bstringf("%2d \"%s\"", err, strerror_wrapper(err).c_str()) });
+                } else if(i == 0 && arg.value_kind == kind::c_string) {
+                    info.message = arg.c_string ? arg.c_string : "(nullptr)";
+                } else if(i == 0 && arg.value_kind == kind::string) {
+                    info.message = std::string(arg.string);
+                } else {
+                    info.extra_diagnostics.push_back({ arg_string, stringify_fwd_value(arg) });
+                }
+            }
+            if(pretty_function) {
+                info.function = pretty_function;
+            } else {
+                info.function = function_from_trace(info.get_raw_trace());
+            }
+        }
+
+        LIBASSERT_ATTR_COLD const assert_static_parameters* fwd_static_parameters(const fwd_site& site) {
+            return decode_static_parameters(site.macro_name, site.type, site.strings, site.location);
+        }
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void fwd_assert_fail(
+        const fwd_site& site,
+        const fwd_value* operands,
+        std::string_view op,
+        const fwd_value* args,
+        std::size_t n_args,
+        const char* pretty_function
+    ) {
+        const auto* params = fwd_static_parameters(site);
+        process_failure(
+            params,
+            n_args,
+            [&] { return fwd_binary_diagnostics(operands, op, params); },
+            [&] (assertion_info& info) {
+                process_fwd_args(info, params, args, n_args, pretty_function);
+                info.binary_diagnostics = fwd_binary_diagnostics(operands, op, params);
+            }
+        );
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void fwd_panic(
+        const fwd_site& site,
+        const fwd_value* args,
+        std::size_t n_args,
+        const char* pretty_function
+    ) {
+        const auto* params = fwd_static_parameters(site);
+        raw_trace_type raw_trace;
+        {
+            phase_timer timer(failure_phase::trace_capture);
+            raw_trace = generate_raw_trace();
+        }
+        assertion_info info(params, std::move(raw_trace), n_args);
+        {
+            phase_timer timer(failure_phase::stringification);
+            process_fwd_args(info, params, args, n_args, pretty_function);
+        }
+        fail(info);
+        LIBASSERT_PRIMITIVE_PANIC("PANIC/UNREACHABLE failure handler returned");
+    }
+}
@@ -0,0 +1,99 @@
+#include <libassert/assertion-failure.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <string>
+#include <utility>
+
+#include <libassert/assert.hpp>
+
+namespace libassert {
+    struct assertion_failure::impl {
+        assertion_info info;
+        std::once_flag rendered;
+        std::string what;
+
+        explicit impl(assertion_info&& info_) : info(std::move(info_)) {}
+        explicit impl(const assertion_info& other) : info(copy(other)) {}
+
+        static assertion_info copy(const assertion_info& other) {
+            // the static parameters are only read during construction
+            const detail::assert_static_parameters params{
+                other.macro_name,
+                other.type,
+                other.expression_string,
+                {other.file_name.data(), static_cast<int>(other.line)},
+                {nullptr, 0}
+            };
+            assertion_info info(&params, raw_trace_type{}, other.n_args);
+            info.function = other.function;
+            info.message = other.message;
+            if(other.binary_diagnostics) {
+                info.binary_diagnostics = binary_diagnostics_descriptor(
+                    other.binary_diagnostics->left_expression,
+                    other.binary_diagnostics->right_expression,
+                    std::string(other.binary_diagnostics->left_stringification),
+                    std::string(other.binary_diagnostics->right_stringification),
+                    other.binary_diagnostics->multiple_formats
+                );
+            }
+            info.extra_diagnostics = other.extra_diagnostics;
+            #ifndef LIBASSERT_STACKTRACE_BACKEND_NONE
+            info.trace = other.trace;
+            #endif
+            return info;
+        }
+    };
+
+    LIBASSERT_ATTR_COLD assertion_failure::assertion_failure(assertion_info&& info)
+        : pimpl(std::make_shared<impl>(std::move(info))) {}
+
+    LIBASSERT_ATTR_COLD assertion_failure::assertion_failure(const assertion_info& info)
+        : pimpl(std::make_shared<impl>(info)) {}
+
+    LIBASSERT_ATTR_COLD const char* assertion_failure::what() const noexcept {
+        try {
+            std::call_once(pimpl->rendered, [this] {
+                pimpl->what = pimpl->info.header(0, color_scheme::blank);
+            });
+            return pimpl->what.c_str();
+        } catch(...) {
+            return "libassert::assertion_failure";
+        }
+    }
+
+    const assertion_info& assertion_failure::info() const noexcept {
+        return pimpl->info;
+    }
+
+    assert_type assertion_failure::type() const noexcept {
+        return pimpl->info.type;
+    }
+
+    std::string_view assertion_failure::macro_name() const noexcept {
+        return pimpl->info.macro_name;
+    }
+
+    std::string_view assertion_failure::expression() const noexcept {
+        return pimpl->info.expression_string;
+    }
+
+    std::string_view assertion_failure::file_name() const noexcept {
+        return pimpl->info.file_name;
+    }
+
+    std::uint32_t assertion_failure::line() const noexcept {
+        return pimpl->info.line;
+    }
+
+    std::string_view assertion_failure::function() const noexcept {
+        return pimpl->info.function;
+    }
+
+    const std::optional<std::string>& assertion_failure::message() const noexcept {
+        return pimpl->info.message;
+    }
+}
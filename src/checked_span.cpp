@@ -0,0 +1,82 @@
+#include <libassert/checked-span.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+#include <string>
+
+#include "stacktrace.hpp"
+#include "utils.hpp"
+
+#include <libassert/assert.hpp>
+
+// The failure path shared by every libassert::checked_span check. The passing path is one compare and a call here, so
+// this doesn't depend on the element type and the location is found from the trace.
+
+namespace libassert::detail {
+    namespace {
+        struct bounds_check_site {
+            const char* name;
+            std::string_view strings;
+        };
+
+        LIBASSERT_ATTR_COLD bounds_check_site get_bounds_check_site(bounds_check_operation operation) {
+            // sites are identified by their strings' addresses as well, see decode_static_parameters
+            switch(operation) {
+                case bounds_check_operation::index:
+                    return {"libassert::checked_span::operator[]", site_strings("index")};
+                case bounds_check_operation::front:
+                    return {"libassert::checked_span::front", site_strings("")};
+                case bounds_check_operation::back:
+                    return {"libassert::checked_span::back", site_strings("")};
+                case bounds_check_operation::dereference:
+                default:
+                    return {"libassert::checked_span::iterator::operator*", site_strings("")};
+            }
+        }
+    }
+
+    LIBASSERT_ATTR_COLD [[noreturn]] LIBASSERT_ATTR_NOINLINE LIBASSERT_EXPORT
+    void bounds_check_fail(
+        bounds_check_operation operation,
+        std::size_t index,
+        std::size_t size,
+        std::string_view element_type
+    ) {
+        // the site is the operation, its disposition is decided before the trace is captured so the location of a
+        // reported failure is filled in from the trace afterwards
+        const auto site = get_bounds_check_site(operation);
+        const auto* params = decode_static_parameters(
+            site.name,
+            assert_type::assertion,
+            site.strings,
+            source_location("<unknown>", 0)
+        );
+        process_failure(
+            params,
+            0,
+            [] { return std::optional<binary_diagnostics_descriptor>{}; },
+            [&] (assertion_info& info) {
+                const auto location = location_from_trace(info.get_raw_trace());
+                info.file_name = location.file;
+                info.line = static_cast<std::uint32_t>(location.line);
+                info.function = function_from_trace(info.get_raw_trace());
+                const bool empty = operation == bounds_check_operation::front
+                    || operation == bounds_check_operation::back;
+                info.message = empty ? "the span is empty" : "index out of bounds";
+                if(!empty) {
+                    info.extra_diagnostics.push_back({"index", generate_stringification(index)});
+                }
+                info.extra_diagnostics.push_back({"size", generate_stringification(size)});
+                info.extra_diagnostics.push_back({"element type", prettify_type(std::string(element_type))});
+            }
+        );
+        // the access can't be made, whether the failure handler returned or the failure was only counted or collected
+        (void)std::fputs("checked_span access out of bounds and the failure handler didn't end the program\n", stderr);
+        (void)std::fflush(stderr);
+        std::abort();
+    }
+}
@@ -0,0 +1,192 @@
+#include <libassert/failure-collector.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+#include "utils.hpp"
+#include "microfmt.hpp"
+
+#include <libassert/assert.hpp>
+
+namespace libassert {
+    namespace detail {
+        thread_local failure_collector* current_collector = nullptr;
+
+        LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+        collection_mode get_collection_mode(const assert_static_parameters* params) {
+            failure_collector* collector = current_collector;
+            if(collector == nullptr) {
+                return collection_mode::none;
+            }
+            if(collector->capture_traces && collector->site_indices.count(params) == 0) {
+                return collection_mode::with_trace;
+            }
+            return collection_mode::without_trace;
+        }
+
+        LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+        void collect_failure(assertion_info& info, const assert_static_parameters* params) {
+            failure_collector* collector = current_collector;
+            LIBASSERT_PRIMITIVE_DEBUG_ASSERT(collector != nullptr);
+            auto& batch = collector->failures;
+            auto [it, inserted] = collector->site_indices.try_emplace(
+                params,
+                static_cast<std::uint32_t>(batch.sites.size())
+            );
+            if(inserted) {
+                failure_site site{
+                    info.macro_name,
+                    info.type,
+                    info.expression_string,
+                    info.file_name,
+                    info.line,
+                    info.function,
+                    info.n_args,
+                    info.binary_diagnostics ? std::move(info.binary_diagnostics->left_expression) : std::string(),
+                    info.binary_diagnostics ? std::move(info.binary_diagnostics->right_expression) : std::string(),
+                    info.binary_diagnostics && info.binary_diagnostics->multiple_formats,
+                    0,
+                    std::nullopt
+                };
+                if(collector->capture_traces) {
+                    site.trace = info.get_raw_trace();
+                }
+                batch.sites.push_back(std::move(site));
+            }
+            batch.sites[it->second].count++;
+            collected_failure failure{it->second, std::move(info.message), {}, {}, std::move(info.extra_diagnostics)};
+            if(info.binary_diagnostics) {
+                failure.left_stringification = std::move(info.binary_diagnostics->left_stringification);
+                failure.right_stringification = std::move(info.binary_diagnostics->right_stringification);
+            }
+            batch.failures.push_back(std::move(failure));
+        }
+    }
+
+    LIBASSERT_ATTR_COLD bool failure_batch::empty() const noexcept {
+        return failures.empty();
+    }
+
+    LIBASSERT_ATTR_COLD std::size_t failure_batch::size() const noexcept {
+        return failures.size();
+    }
+
+    LIBASSERT_ATTR_COLD
+    std::string failure_batch::to_string(int width, const color_scheme& scheme, std::size_t max_values_per_site) const {
+        std::string output = microfmt::format(
+            "{}{} failures at {} sites collected{}\n",
+            scheme.accent,
+            failures.size(),
+            sites.size(),
+            scheme.reset
+        );
+        // first and later failures of each site
+        std::vector<const collected_failure*> first(sites.size(), nullptr);
+        std::vector<std::vector<const collected_failure*>> later(sites.size());
+        for(const auto& failure : failures) {
+            if(!first[failure.site]) {
+                first[failure.site] = &failure;
+            } else if(later[failure.site].size() < max_values_per_site) {
+                later[failure.site].push_back(&failure);
+            }
+        }
+        for(std::size_t i = 0; i < sites.size(); i++) {
+            const auto& site = sites[i];
+            const auto& failure = *first[i];
+            // rebuild the first failure's assertion_info to reuse the normal report rendering
+            const detail::assert_static_parameters params{
+                site.macro_name,
+                site.type,
+                site.expression_string,
+                {site.file_name.data(), static_cast<int>(site.line)},
+                {nullptr, 0}
+            };
+            assertion_info info(&params, site.trace ? raw_trace_type(*site.trace) : raw_trace_type{}, site.n_args);
+            info.function = site.function;
+            info.message = failure.message;
+            if(!site.left_expression.empty() || !site.right_expression.empty()) {
+                info.binary_diagnostics = binary_diagnostics_descriptor(
+                    site.left_expression,
+                    site.right_expression,
+                    std::string(failure.left_stringification),
+                    std::string(failure.right_stringification),
+                    site.multiple_formats
+                );
+            }
+            info.extra_diagnostics = failure.extra_diagnostics;
+            output += "\n";
+            output += info.header(width, scheme);
+            if(site.trace) {
+                output += "\nStack trace:\n";
+                output += info.print_stacktrace(width, scheme);
+            }
+            if(site.count > 1) {
+                output += microfmt::format("\n{}Failed {} times{}", scheme.accent, site.count, scheme.reset);
+                if(!later[i].empty()) {
+                    output += ", later values:";
+                }
+                output += "\n";
+            }
+            for(const auto* later_failure : later[i]) {
+                std::string values;
+                // like the full report, sides that stringify to their own expression are left out
+                if(later_failure->left_stringification != site.left_expression) {
+                    values = microfmt::format("{} => {}", site.left_expression, later_failure->left_stringification);
+                }
+                if(later_failure->right_stringification != site.right_expression) {
+                    values += microfmt::format(
+                        "{}{} => {}",
+                        values.empty() ? "" : ", ",
+                        site.right_expression,
+                        later_failure->right_stringification
+                    );
+                }
+                for(const auto& extra : later_failure->extra_diagnostics) {
+                    values += microfmt::format("{}{} => {}", values.empty() ? "" : ", ", extra.expression, extra.stringification);
+                }
+                if(later_failure->message) {
+                    values += microfmt::format("{}{}", values.empty() ? "" : ": ", *later_failure->message);
+                }
+                output += microfmt::format("    {}\n", values);
+            }
+            if(site.count > 1 + later[i].size()) {
+                output += microfmt::format("    ... {} more\n", site.count - 1 - later[i].size());
+            }
+        }
+        return output;
+    }
+
+    LIBASSERT_ATTR_COLD failure_collector::failure_collector(callback_type callback_, bool capture_traces_)
+        : previous(detail::current_collector), callback(std::move(callback_)), capture_traces(capture_traces_) {
+        #ifdef LIBASSERT_STACKTRACE_BACKEND_NONE
+        capture_traces = false; // there are no traces to capture
+        #endif
+        detail::current_collector = this;
+    }
+
+    LIBASSERT_ATTR_COLD failure_collector::~failure_collector() {
+        LIBASSERT_PRIMITIVE_DEBUG_ASSERT(detail::current_collector == this, "failure_collector destroyed out of order");
+        detail::current_collector = previous;
+        if(callback) {
+            callback(failures);
+        } else if(!failures.empty()) {
+            enable_virtual_terminal_processing_if_needed();
+            std::string report = failures.to_string(
+                terminal_width(stderr_fileno),
+                isatty(stderr_fileno) ? get_color_scheme() : color_scheme::blank
+            );
+            (void)std::fwrite(report.data(), 1, report.size(), stderr);
+            (void)std::fflush(stderr);
+        }
+    }
+
+    LIBASSERT_ATTR_COLD const failure_batch& failure_collector::batch() const noexcept {
+        return failures;
+    }
+}
@@ -0,0 +1,308 @@
+#include <libassert/failure-ring.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "common.hpp"
+#include "utils.hpp"
+
+#if IS_WINDOWS
+ #include <windows.h>
+ #undef min
+ #undef max
+#else
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+#include <libassert/assert.hpp>
+
+// File layout:
+//   ring_header (64 bytes)
+//   slot_count slots of slot_size bytes, each a slot_header followed by the payload
+// A slot holding sequence number s has begin == end == s. The writer invalidates end, publishes begin, writes the
+// payload and checksum, then publishes end. A reader only accepts a slot if begin and end agree and the checksum of
+// the payload matches, which catches writers that died mid-record as well as two writers lapping the same slot.
+
+namespace libassert {
+    namespace {
+        constexpr char ring_magic[8] = {'L', 'A', 'R', 'I', 'N', 'G', '1', '\0'};
+        constexpr std::uint32_t ring_version = 1;
+        constexpr std::uint32_t truncated_flag = 1;
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+        struct ring_geometry {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t slot_count;
+            std::uint32_t slot_size;
+        };
+
+        struct ring_header {
+            ring_geometry geometry;
+            std::uint32_t reserved;
+            std::atomic<std::uint64_t> next_sequence;
+            unsigned char padding[32];
+        };
+        static_assert(sizeof(ring_header) == 64);
+
+        struct slot_header {
+            std::atomic<std::uint64_t> begin;
+            std::uint32_t length;
+            std::uint32_t checksum;
+            std::uint32_t flags;
+            std::uint32_t reserved;
+            std::atomic<std::uint64_t> end;
+        };
+        static_assert(sizeof(slot_header) == 32);
+
+        // fnv-1a
+        std::uint32_t checksum(const unsigned char* data, std::size_t size) {
+            std::uint32_t hash = 2166136261u;
+            for(std::size_t i = 0; i < size; i++) {
+                hash ^= data[i];
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        std::size_t ring_file_size(std::uint32_t slot_count, std::uint32_t slot_size) {
+            return sizeof(ring_header) + std::size_t(slot_count) * slot_size;
+        }
+
+        bool has_valid_header(const ring_geometry& header, std::size_t file_size) {
+            return std::memcmp(header.magic, ring_magic, sizeof(ring_magic)) == 0
+                && header.version == ring_version
+                && header.slot_count != 0
+                && header.slot_size > sizeof(slot_header)
+                && ring_file_size(header.slot_count, header.slot_size) == file_size;
+        }
+
+        [[noreturn]] LIBASSERT_ATTR_COLD void throw_system_error(std::string_view what, std::string_view path) {
+            #if IS_WINDOWS
+             int code = static_cast<int>(GetLastError());
+             const auto& category = std::system_category();
+            #else
+             int code = errno;
+             const auto& category = std::generic_category();
+            #endif
+            throw std::system_error(
+                code,
+                category,
+                detail::bstringf("libassert failure_ring: %s \"%s\"", std::string(what).c_str(), std::string(path).c_str())
+            );
+        }
+    }
+
+    failure_ring::failure_ring(std::string_view path, std::uint32_t slot_count_, std::uint32_t slot_size_) {
+        if(slot_count_ == 0 || slot_size_ <= sizeof(slot_header)) {
+            throw std::invalid_argument(
+                detail::bstringf(
+                    "libassert failure_ring: slot count must be nonzero and slot size must exceed %d bytes",
+                    int(sizeof(slot_header))
+                )
+            );
+        }
+        std::string path_str(path);
+        #if IS_WINDOWS
+         HANDLE file = CreateFileA(
+             path_str.c_str(),
+             GENERIC_READ | GENERIC_WRITE,
+             FILE_SHARE_READ | FILE_SHARE_WRITE,
+             nullptr,
+             OPEN_ALWAYS,
+             FILE_ATTRIBUTE_NORMAL,
+             nullptr
+         );
+         if(file == INVALID_HANDLE_VALUE) {
+             throw_system_error("failed to open", path);
+         }
+         LARGE_INTEGER existing_size;
+         if(!GetFileSizeEx(file, &existing_size)) {
+             CloseHandle(file);
+             throw_system_error("failed to stat", path);
+         }
+         auto file_size = static_cast<std::size_t>(existing_size.QuadPart);
+        #else
+         int fd = open(path_str.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+         if(fd == -1) {
+             throw_system_error("failed to open", path);
+         }
+         struct stat st;
+         if(fstat(fd, &st) == -1) {
+             close(fd);
+             throw_system_error("failed to stat", path);
+         }
+         auto file_size = static_cast<std::size_t>(st.st_size);
+        #endif
+        // reuse the geometry of an existing ring so its records can be read back and its sequence continued
+        bool reuse = false;
+        if(file_size >= sizeof(ring_header)) {
+            ring_geometry existing;
+            std::ifstream stream(path_str, std::ios::binary);
+            if(stream.read(reinterpret_cast<char*>(&existing), sizeof(existing))) { // NOLINT
+                if(has_valid_header(existing, file_size)) {
+                    slot_count_ = existing.slot_count;
+                    slot_size_ = existing.slot_size;
+                    reuse = true;
+                }
+            }
+        }
+        std::size_t size = ring_file_size(slot_count_, slot_size_);
+        #if IS_WINDOWS
+         if(!reuse) {
+             // recreate from scratch so stale contents don't look like records
+             LARGE_INTEGER zero{};
+             LARGE_INTEGER new_size;
+             new_size.QuadPart = static_cast<LONGLONG>(size);
+             if(
+                 !SetFilePointerEx(file, zero, nullptr, FILE_BEGIN) || !SetEndOfFile(file)
+                 || !SetFilePointerEx(file, new_size, nullptr, FILE_BEGIN) || !SetEndOfFile(file)
+             ) {
+                 CloseHandle(file);
+                 throw_system_error("failed to resize", path);
+             }
+         }
+         HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+         CloseHandle(file);
+         if(mapping == nullptr) {
+             throw_system_error("failed to map", path);
+         }
+         void* addr = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+         CloseHandle(mapping);
+         if(addr == nullptr) {
+             throw_system_error("failed to map", path);
+         }
+        #else
+         if(!reuse) {
+             // recreate from scratch so stale contents don't look like records
+             if(ftruncate(fd, 0) == -1 || ftruncate(fd, static_cast<off_t>(size)) == -1) {
+                 close(fd);
+                 throw_system_error("failed to resize", path);
+             }
+         }
+         void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+         close(fd);
+         if(addr == MAP_FAILED) {
+             throw_system_error("failed to map", path);
+         }
+        #endif
+        base = static_cast<unsigned char*>(addr);
+        mapping_size = size;
+        slot_count = slot_count_;
+        slot_size = slot_size_;
+        if(!reuse) {
+            auto* header = new (base) ring_header{};
+            header->geometry.version = ring_version;
+            header->geometry.slot_count = slot_count;
+            header->geometry.slot_size = slot_size;
+            header->next_sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(header->geometry.magic, ring_magic, sizeof(ring_magic));
+        }
+    }
+
+    failure_ring::~failure_ring() {
+        #if IS_WINDOWS
+         FlushViewOfFile(base, 0);
+         UnmapViewOfFile(base);
+        #else
+         munmap(base, mapping_size);
+        #endif
+    }
+
+    void failure_ring::append(std::string_view record) noexcept {
+        auto* header = reinterpret_cast<ring_header*>(base); // NOLINT
+        std::uint64_t sequence = header->next_sequence.fetch_add(1, std::memory_order_relaxed) + 1;
+        auto* slot_base = base + sizeof(ring_header) + ((sequence - 1) % slot_count) * slot_size;
+        auto* slot = reinterpret_cast<slot_header*>(slot_base); // NOLINT
+        unsigned char* payload = slot_base + sizeof(slot_header);
+        std::uint32_t length = static_cast<std::uint32_t>(std::min(record.size(), std::size_t(capacity())));
+        slot->end.store(0, std::memory_order_relaxed);
+        slot->begin.store(sequence, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(payload, record.data(), length);
+        slot->length = length;
+        slot->flags = length < record.size() ? truncated_flag : 0;
+        slot->checksum = checksum(payload, length);
+        slot->end.store(sequence, std::memory_order_release);
+    }
+
+    void failure_ring::append(const assertion_info& info) {
+        append(info.to_string(0, color_scheme::blank));
+    }
+
+    std::uint32_t failure_ring::capacity() const noexcept {
+        return slot_size - static_cast<std::uint32_t>(sizeof(slot_header));
+    }
+
+    std::uint32_t failure_ring::size() const noexcept {
+        return slot_count;
+    }
+
+    std::vector<failure_ring_record> read_failure_ring(std::string_view path, std::size_t n) {
+        std::string path_str(path);
+        std::ifstream stream(path_str, std::ios::binary);
+        if(!stream) {
+            throw_system_error("failed to open", path);
+        }
+        // snapshot the file, a live writer may be appending concurrently and torn slots will fail validation below
+        std::vector<unsigned char> contents{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+        if(contents.size() < sizeof(ring_header)) {
+            throw std::runtime_error(detail::bstringf("libassert: \"%s\" is not a failure ring", path_str.c_str()));
+        }
+        ring_geometry header;
+        std::memcpy(&header, contents.data(), sizeof(header));
+        if(!has_valid_header(header, contents.size())) {
+            throw std::runtime_error(detail::bstringf("libassert: \"%s\" is not a failure ring", path_str.c_str()));
+        }
+        std::vector<failure_ring_record> records;
+        for(std::uint32_t i = 0; i < header.slot_count; i++) {
+            const unsigned char* slot_base = contents.data() + sizeof(ring_header) + std::size_t(i) * header.slot_size;
+            std::uint64_t begin;
+            std::uint64_t end;
+            std::uint32_t length;
+            std::uint32_t sum;
+            std::uint32_t flags;
+            std::memcpy(&begin, slot_base + offsetof(slot_header, begin), sizeof(begin));
+            std::memcpy(&end, slot_base + offsetof(slot_header, end), sizeof(end));
+            std::memcpy(&length, slot_base + offsetof(slot_header, length), sizeof(length));
+            std::memcpy(&sum, slot_base + offsetof(slot_header, checksum), sizeof(sum));
+            std::memcpy(&flags, slot_base + offsetof(slot_header, flags), sizeof(flags));
+            const unsigned char* payload = slot_base + sizeof(slot_header);
+            if(
+                begin == 0
+                || begin != end
+                || length > header.slot_size - sizeof(slot_header)
+                || checksum(payload, length) != sum
+            ) {
+                continue;
+            }
+            records.push_back({
+                begin,
+                (flags & truncated_flag) != 0,
+                std::string(reinterpret_cast<const char*>(payload), length) // NOLINT
+            });
+        }
+        std::sort(records.begin(), records.end(), [](const auto& a, const auto& b) { return a.sequence < b.sequence; });
+        if(records.size() > n) {
+            records.erase(records.begin(), records.end() - static_cast<std::ptrdiff_t>(n));
+        }
+        return records;
+    }
+}
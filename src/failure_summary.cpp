@@ -0,0 +1,263 @@
+#include <libassert/assert.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+#include "utils.hpp"
+#include "microfmt.hpp"
+
+namespace libassert::detail {
+    // distinct values are tracked for the first failures of a site, after that repeats only bump counters
+    constexpr std::size_t max_value_samples = 64;
+
+    using summary_clock = std::chrono::steady_clock;
+
+    struct site_summary {
+        const assert_static_parameters* params;
+        std::uint64_t count = 0;
+        summary_clock::time_point first;
+        summary_clock::time_point last;
+        std::size_t samples = 0;
+        std::unordered_set<std::size_t> distinct_values;
+        std::string first_report;
+    };
+
+    struct summary_state {
+        std::atomic<bool> enabled = false;
+        std::atomic<bool> print_at_exit = false;
+        std::once_flag atexit_flag;
+        std::mutex mutex;
+        summary_clock::time_point epoch;
+        std::unordered_map<const assert_static_parameters*, site_summary> sites;
+    };
+
+    summary_state& get_summary_state() {
+        static summary_state state;
+        return state;
+    }
+
+    LIBASSERT_ATTR_COLD
+    std::size_t hash_values(const std::optional<binary_diagnostics_descriptor>& binary_diagnostics) {
+        if(!binary_diagnostics) {
+            return 0;
+        }
+        std::string values = binary_diagnostics->left_stringification;
+        values += '\0';
+        values += binary_diagnostics->right_stringification;
+        return std::hash<std::string>{}(values);
+    }
+
+    LIBASSERT_ATTR_COLD
+    void sample_values(site_summary& site, const std::optional<binary_diagnostics_descriptor>& binary_diagnostics) {
+        if(site.samples < max_value_samples) {
+            site.samples++;
+            site.distinct_values.insert(hash_values(binary_diagnostics));
+        }
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    failure_disposition record_failure(const assert_static_parameters* params) {
+        auto& state = get_summary_state();
+        if(!state.enabled.load(std::memory_order_relaxed)) {
+            return failure_disposition::report;
+        }
+        auto now = summary_clock::now();
+        std::unique_lock lock(state.mutex);
+        auto [it, inserted] = state.sites.try_emplace(params);
+        auto& site = it->second;
+        site.count++;
+        site.last = now;
+        if(inserted) {
+            site.params = params;
+            site.first = now;
+            return failure_disposition::report_first;
+        }
+        return site.samples < max_value_samples ? failure_disposition::sample : failure_disposition::count;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void record_failure_values(
+        const assert_static_parameters* params,
+        const std::optional<binary_diagnostics_descriptor>& binary_diagnostics
+    ) {
+        auto& state = get_summary_state();
+        std::unique_lock lock(state.mutex);
+        if(auto it = state.sites.find(params); it != state.sites.end()) {
+            sample_values(it->second, binary_diagnostics);
+        }
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void record_first_failure(const assert_static_parameters* params, const assertion_info& info) {
+        // rendered outside the lock, this resolves the stack trace
+        std::string report = info.to_string(0, color_scheme::blank);
+        auto& state = get_summary_state();
+        std::unique_lock lock(state.mutex);
+        if(auto it = state.sites.find(params); it != state.sites.end()) {
+            sample_values(it->second, info.binary_diagnostics);
+            it->second.first_report = std::move(report);
+        }
+    }
+
+    LIBASSERT_ATTR_COLD
+    std::string format_timestamp(summary_clock::time_point epoch, summary_clock::time_point time) {
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time - epoch).count();
+        return microfmt::format("+{}.{}s", ms / 1000, bstringf("%03d", static_cast<int>(ms % 1000)));
+    }
+
+    LIBASSERT_ATTR_COLD
+    void print_summary_at_exit() {
+        if(get_summary_state().print_at_exit.load()) {
+            print_failure_summary();
+        }
+    }
+}
+
+namespace libassert {
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void enable_failure_summary(bool print_at_exit) {
+        auto& state = detail::get_summary_state();
+        {
+            std::unique_lock lock(state.mutex);
+            if(!state.enabled.load() && state.sites.empty()) {
+                state.epoch = detail::summary_clock::now();
+            }
+        }
+        state.print_at_exit = print_at_exit;
+        if(print_at_exit) {
+            // state is constructed above so this runs before it's destroyed
+            std::call_once(state.atexit_flag, [] { std::atexit(detail::print_summary_at_exit); });
+        }
+        state.enabled = true;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void disable_failure_summary() {
+        auto& state = detail::get_summary_state();
+        state.enabled = false;
+        state.print_at_exit = false;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void reset_failure_summary() {
+        auto& state = detail::get_summary_state();
+        std::unique_lock lock(state.mutex);
+        state.sites.clear();
+        state.epoch = detail::summary_clock::now();
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::string failure_summary(const color_scheme& scheme) {
+        struct row {
+            std::uint64_t count;
+            std::string first;
+            std::string last;
+            std::string distinct;
+            std::string location;
+            std::string_view expression;
+            std::string report;
+        };
+        std::vector<row> rows;
+        std::uint64_t total = 0;
+        {
+            auto& state = detail::get_summary_state();
+            std::unique_lock lock(state.mutex);
+            for(const auto& [params, site] : state.sites) {
+                total += site.count;
+                rows.push_back({
+                    site.count,
+                    detail::format_timestamp(state.epoch, site.first),
+                    detail::format_timestamp(state.epoch, site.last),
+                    std::to_string(site.distinct_values.size())
+                        + (site.count > site.samples ? "/" + std::to_string(site.samples) : ""),
+                    microfmt::format("{}:{}", params->location.file, params->location.line),
+                    params->expr_str,
+                    site.first_report
+                });
+            }
+        }
+        std::sort(rows.begin(), rows.end(), [](const row& a, const row& b) {
+            return std::tie(b.count, a.location) < std::tie(a.count, b.location);
+        });
+        row header{0, "First", "Last", "Distinct", "Location", "Expression", ""};
+        std::size_t count_width = 5;
+        std::size_t first_width = header.first.size();
+        std::size_t last_width = header.last.size();
+        std::size_t distinct_width = header.distinct.size();
+        std::size_t location_width = header.location.size();
+        for(const auto& r : rows) {
+            count_width = std::max(count_width, std::to_string(r.count).size());
+            first_width = std::max(first_width, r.first.size());
+            last_width = std::max(last_width, r.last.size());
+            distinct_width = std::max(distinct_width, r.distinct.size());
+            location_width = std::max(location_width, r.location.size());
+        }
+        std::string output = microfmt::format(
+            "{}Assertion failure summary: {} failures at {} sites{}\n",
+            scheme.accent,
+            total,
+            rows.size(),
+            scheme.reset
+        );
+        if(rows.empty()) {
+            return output;
+        }
+        output += microfmt::format(
+            "{}{>{}}  {<{}}  {<{}}  {<{}}  {<{}}  {}{}\n",
+            scheme.accent,
+            count_width,
+            "Count",
+            first_width,
+            header.first,
+            last_width,
+            header.last,
+            distinct_width,
+            header.distinct,
+            location_width,
+            header.location,
+            header.expression,
+            scheme.reset
+        );
+        for(const auto& r : rows) {
+            output += microfmt::format(
+                "{>{}}  {<{}}  {<{}}  {<{}}  {<{}}  {}\n",
+                count_width,
+                r.count,
+                first_width,
+                r.first,
+                last_width,
+                r.last,
+                distinct_width,
+                r.distinct,
+                location_width,
+                r.location,
+                r.expression
+            );
+        }
+        for(const auto& r : rows) {
+            if(!r.report.empty()) {
+                output += microfmt::format("\n{}First failure at {}:{}\n", scheme.accent, r.location, scheme.reset);
+                output += r.report;
+                output += '\n';
+            }
+        }
+        return output;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void print_failure_summary() {
+        enable_virtual_terminal_processing_if_needed();
+        std::string summary = failure_summary(isatty(stderr_fileno) ? get_color_scheme() : color_scheme::blank);
+        (void)std::fwrite(summary.data(), 1, summary.size(), stderr);
+        (void)std::fflush(stderr);
+    }
+}
@@ -0,0 +1,19 @@
+#include "common.hpp"
+#include "utils.hpp"
+
+#include <libassert/assert.hpp>
+
+// Explicit instantiations matching the instantiation declarations in stringification.hpp and assert.hpp, they're
+// always compiled here so that translation units with LIBASSERT_PREBUILT_STRINGIFICATION can link against them.
+
+namespace libassert::detail {
+    #define LIBASSERT_X(T) \
+        LIBASSERT_STRINGIFICATION_INSTANTIATIONS(, T) \
+        LIBASSERT_PROCESS_ARG_INSTANTIATION(, T) \
+        LIBASSERT_BINARY_DIAGNOSTIC_INSTANTIATION(, T, T)
+    #define LIBASSERT_Y(A, B) LIBASSERT_BINARY_DIAGNOSTIC_INSTANTIATION(, A, B)
+    LIBASSERT_FOR_EACH_PREBUILT_TYPE(LIBASSERT_X)
+    LIBASSERT_FOR_EACH_PREBUILT_MIXED_PAIR(LIBASSERT_Y)
+    #undef LIBASSERT_X
+    #undef LIBASSERT_Y
+}
@@ -3,10 +3,11 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <initializer_list>
-#include <iostream>
 #include <iterator>
+#include <ostream>
 #include <string>
 #if ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
  #include <string_view>
@@ -284,9 +285,11 @@ namespace libassert::microfmt {
         return str;
     }
 
+    // stdout rather than std::cout, <iostream> adds a static initializer to every translation unit including this
     template<typename S, typename... Args>
     void print(const S& fmt, Args&&... args) {
-        detail::format(std::ostream_iterator<char>(std::cout), fmt, {args...});
+        auto str = format(fmt, args...);
+        fwrite(str.data(), 1, str.size(), stdout);
     }
 
     template<typename S, typename... Args>
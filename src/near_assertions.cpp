@@ -0,0 +1,218 @@
+#include <libassert/near-assertions.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <string>
+
+#include "analysis.hpp"
+#include "utils.hpp"
+
+#include <libassert/assert.hpp>
+
+// The failure path of ASSERT_NEAR and ASSERT_ALL_NEAR, the operands are float, double, or long double by now so this
+// isn't instantiated in every translation unit.
+
+namespace libassert::detail {
+    namespace {
+        // values closer than this print the same in decimal except for the last digits, the hex floats show the bits
+        constexpr std::uint64_t hex_float_ulps = std::uint64_t(1) << 20;
+
+        // like set_literal_format for a == b, but hex floats are shown when useful unless the mode is fixed
+        LIBASSERT_ATTR_COLD literal_format set_near_literal_format(
+            std::string_view a_str,
+            std::string_view b_str,
+            bool hex_floats
+        ) {
+            const literal_format previous = set_literal_format(a_str, b_str, "==", false);
+            if(hex_floats && get_literal_format_config().first == literal_format_mode::infer) {
+                set_thread_current_literal_format(get_thread_current_literal_format() | literal_format::float_hex);
+            }
+            return previous;
+        }
+
+        template<typename T>
+        LIBASSERT_ATTR_COLD bool is_nan(T x) {
+            return x != x;
+        }
+
+        template<typename T>
+        LIBASSERT_ATTR_COLD bool show_hex_floats(T a, T b, const tolerance& tol) {
+            if(tol.kind == tolerance_kind::ulps) {
+                return true;
+            }
+            return !is_nan(a) && !is_nan(b) && ulp_distance(a, b) <= hex_float_ulps;
+        }
+
+        LIBASSERT_ATTR_COLD std::string stringify_tolerance(const tolerance& tol) {
+            switch(tol.kind) {
+                case tolerance_kind::absolute:
+                    return generate_stringification(tol.value) + " (absolute)";
+                case tolerance_kind::relative:
+                    return generate_stringification(tol.value) + " (relative)";
+                case tolerance_kind::ulps:
+                default:
+                    return generate_stringification(tol.ulps) + " ULPs";
+            }
+        }
+
+        // how far a and b are apart in the tolerance's units, NaNs and infinite differences are infinitely far apart,
+        // a relative error of inf / inf would be NaN otherwise
+        template<typename T>
+        LIBASSERT_ATTR_COLD long double near_error(T a, T b, const tolerance& tol) {
+            if(is_nan(a) || is_nan(b)) {
+                return std::numeric_limits<long double>::infinity();
+            }
+            const auto x = static_cast<long double>(a);
+            const auto y = static_cast<long double>(b);
+            const long double difference = std::abs(x - y);
+            if(!std::isfinite(difference)) {
+                return std::numeric_limits<long double>::infinity();
+            }
+            switch(tol.kind) {
+                case tolerance_kind::absolute:
+                    return difference;
+                case tolerance_kind::relative:
+                    return difference / std::max(std::abs(x), std::abs(y));
+                case tolerance_kind::ulps:
+                default:
+                    return static_cast<long double>(ulp_distance(a, b));
+            }
+        }
+
+        template<typename T>
+        LIBASSERT_ATTR_COLD void add_difference_diagnostics(assertion_info& info, T a, T b) {
+            info.extra_diagnostics.push_back({ "difference", generate_stringification(std::abs(a - b)) });
+            if(!is_nan(a) && !is_nan(b)) {
+                info.extra_diagnostics.push_back({ "ulps apart", generate_stringification(ulp_distance(a, b)) });
+            }
+        }
+
+        template<typename T>
+        LIBASSERT_ATTR_COLD void add_scalar_near_diagnostics(
+            assertion_info& info,
+            const near_operands<T>& operands,
+            const tolerance& tol
+        ) {
+            const literal_format previous_format = set_near_literal_format(
+                operands.a_str,
+                operands.b_str,
+                show_hex_floats(operands.a, operands.b, tol)
+            );
+            info.binary_diagnostics = binary_diagnostics_descriptor(
+                operands.a_str,
+                operands.b_str,
+                generate_stringification(operands.a),
+                generate_stringification(operands.b),
+                has_multiple_formats()
+            );
+            restore_literal_format(previous_format);
+            add_difference_diagnostics(info, operands.a, operands.b);
+            info.extra_diagnostics.push_back({ "tolerance", stringify_tolerance(tol) });
+        }
+
+        template<typename T>
+        LIBASSERT_ATTR_COLD void add_range_near_diagnostics(
+            assertion_info& info,
+            const near_range_operands<T>& operands,
+            const tolerance& tol
+        ) {
+            if(operands.a_size != operands.b_size) {
+                info.extra_diagnostics.push_back({
+                    "sizes",
+                    generate_stringification(operands.a_size) + " and " + generate_stringification(operands.b_size)
+                });
+                return;
+            }
+            const std::size_t size = operands.a_size;
+            std::size_t mismatches = 0;
+            std::size_t worst = 0;
+            long double worst_error = -1;
+            // over the elements which aren't NaN
+            std::size_t compared = 0;
+            long double max_difference = 0;
+            long double sum_difference = 0;
+            for(std::size_t i = 0; i < size; i++) {
+                const T a = operands.a[i];
+                const T b = operands.b[i];
+                if(!is_near(a, b, tol)) {
+                    mismatches++;
+                    const long double error = near_error(a, b, tol);
+                    // the first mismatch seeds worst so it never names an element that passed
+                    if(mismatches == 1 || error > worst_error) {
+                        worst = i;
+                        worst_error = error;
+                    }
+                }
+                if(!is_nan(a) && !is_nan(b) && a != b) {
+                    const long double difference = std::abs(static_cast<long double>(a) - static_cast<long double>(b));
+                    max_difference = std::max(max_difference, difference);
+                    sum_difference += difference;
+                }
+                compared += !is_nan(a) && !is_nan(b);
+            }
+            const T a = operands.a[worst];
+            const T b = operands.b[worst];
+            info.extra_diagnostics.push_back({
+                "mismatches",
+                generate_stringification(mismatches) + " of " + generate_stringification(size)
+            });
+            info.extra_diagnostics.push_back({ "worst index", generate_stringification(worst) });
+            const literal_format previous_format = set_near_literal_format("", "", show_hex_floats(a, b, tol));
+            info.extra_diagnostics.push_back({
+                "worst values",
+                generate_stringification(a) + ", " + generate_stringification(b)
+            });
+            restore_literal_format(previous_format);
+            add_difference_diagnostics(info, a, b);
+            // accumulated in long double, but the digits past a double's don't say much
+            info.extra_diagnostics.push_back({
+                "max difference",
+                generate_stringification(static_cast<double>(max_difference))
+            });
+            if(compared > 0) {
+                info.extra_diagnostics.push_back({
+                    "mean difference",
+                    generate_stringification(static_cast<double>(sum_difference / static_cast<long double>(compared)))
+                });
+            }
+            info.extra_diagnostics.push_back({ "tolerance", stringify_tolerance(tol) });
+        }
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void add_near_diagnostics(assertion_info& info, const near_operands<float>& operands, const tolerance& tol) {
+        add_scalar_near_diagnostics(info, operands, tol);
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void add_near_diagnostics(assertion_info& info, const near_operands<double>& operands, const tolerance& tol) {
+        add_scalar_near_diagnostics(info, operands, tol);
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void add_near_diagnostics(assertion_info& info, const near_operands<long double>& operands, const tolerance& tol) {
+        add_scalar_near_diagnostics(info, operands, tol);
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void add_near_diagnostics(assertion_info& info, const near_range_operands<float>& operands, const tolerance& tol) {
+        add_range_near_diagnostics(info, operands, tol);
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void add_near_diagnostics(assertion_info& info, const near_range_operands<double>& operands, const tolerance& tol) {
+        add_range_near_diagnostics(info, operands, tol);
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT
+    void add_near_diagnostics(
+        assertion_info& info,
+        const near_range_operands<long double>& operands,
+        const tolerance& tol
+    ) {
+        add_range_near_diagnostics(info, operands, tol);
+    }
+}
@@ -0,0 +1,221 @@
+#include <libassert/assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string_view>
+#include <string>
+
+#include "common.hpp"
+#include "utils.hpp"
+#include "microfmt.hpp"
+
+namespace libassert::detail {
+    struct phase_counters {
+        std::atomic<std::uint64_t> calls = 0;
+        std::atomic<std::uint64_t> nanoseconds = 0;
+    };
+
+    struct phase_timing_state {
+        std::atomic<bool> enabled = false;
+        std::atomic<bool> print_at_exit = false;
+        std::once_flag atexit_flag;
+        std::array<phase_counters, failure_phase_count> phases;
+    };
+
+    phase_timing_state& get_phase_timing_state() {
+        static phase_timing_state state;
+        return state;
+    }
+
+    LIBASSERT_ATTR_COLD
+    void print_phase_timing_summary_at_exit() {
+        if(get_phase_timing_state().print_at_exit.load()) {
+            print_phase_timing_summary();
+        }
+    }
+
+    LIBASSERT_ATTR_COLD
+    bool phase_timing_enabled_from_environment() {
+        const char* value = std::getenv("LIBASSERT_PHASE_TIMING"); // NOLINT(concurrency-mt-unsafe)
+        return value != nullptr && *value != '\0' && std::string_view(value) != "0";
+    }
+
+    LIBASSERT_ATTR_COLD
+    void enable_phase_timing(phase_timing_state& state, bool print_at_exit) {
+        state.print_at_exit = print_at_exit;
+        if(print_at_exit) {
+            // state is constructed before this so this runs before it's destroyed
+            std::call_once(state.atexit_flag, [] { std::atexit(print_phase_timing_summary_at_exit); });
+        }
+        state.enabled = true;
+    }
+
+    // the environment is only checked once timing state is first needed, i.e. on the first failure or api call, so
+    // explicit calls override it
+    LIBASSERT_ATTR_COLD
+    phase_timing_state& get_initialized_phase_timing_state() {
+        static const bool from_environment = [] {
+            const bool enabled = phase_timing_enabled_from_environment();
+            if(enabled) {
+                enable_phase_timing(get_phase_timing_state(), true);
+            }
+            return enabled;
+        } ();
+        (void)from_environment;
+        return get_phase_timing_state();
+    }
+
+    // the innermost active timer on this thread
+    thread_local phase_timer* current_phase_timer = nullptr;
+
+    LIBASSERT_ATTR_COLD
+    void add_phase_time(failure_phase phase, std::chrono::steady_clock::duration time) {
+        auto& counters = get_phase_timing_state().phases[static_cast<std::size_t>(phase)];
+        counters.nanoseconds.fetch_add(
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count()),
+            std::memory_order_relaxed
+        );
+    }
+
+    LIBASSERT_ATTR_COLD phase_timer::phase_timer(failure_phase phase_) : phase(phase_) {
+        if(!get_initialized_phase_timing_state().enabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+        // re-entering the current phase just extends it
+        if(current_phase_timer != nullptr && current_phase_timer->phase == phase) {
+            return;
+        }
+        active = true;
+        parent = current_phase_timer;
+        current_phase_timer = this;
+        start = std::chrono::steady_clock::now();
+        if(parent) {
+            add_phase_time(parent->phase, start - parent->start);
+        }
+    }
+
+    LIBASSERT_ATTR_COLD phase_timer::~phase_timer() {
+        if(!active) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        add_phase_time(phase, now - start);
+        get_phase_timing_state().phases[static_cast<std::size_t>(phase)].calls.fetch_add(1, std::memory_order_relaxed);
+        current_phase_timer = parent;
+        if(parent) {
+            parent->start = now;
+        }
+    }
+
+    LIBASSERT_ATTR_COLD
+    std::string format_duration(std::chrono::nanoseconds time) {
+        return bstringf("%.3fms", static_cast<double>(time.count()) / 1e6);
+    }
+}
+
+namespace libassert {
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void enable_phase_timing(bool print_at_exit) {
+        detail::enable_phase_timing(detail::get_initialized_phase_timing_state(), print_at_exit);
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void disable_phase_timing() {
+        auto& state = detail::get_initialized_phase_timing_state();
+        state.enabled = false;
+        state.print_at_exit = false;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void reset_phase_timings() {
+        for(auto& counters : detail::get_initialized_phase_timing_state().phases) {
+            counters.calls = 0;
+            counters.nanoseconds = 0;
+        }
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::array<phase_timing, failure_phase_count> phase_timings() {
+        std::array<phase_timing, failure_phase_count> timings;
+        const auto& phases = detail::get_initialized_phase_timing_state().phases;
+        for(std::size_t i = 0; i < failure_phase_count; i++) {
+            timings[i].calls = phases[i].calls.load(std::memory_order_relaxed);
+            timings[i].time = std::chrono::nanoseconds(phases[i].nanoseconds.load(std::memory_order_relaxed));
+        }
+        return timings;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::string_view phase_name(failure_phase phase) {
+        switch(phase) {
+            case failure_phase::trace_capture:       return "trace capture";
+            case failure_phase::stringification:     return "stringification";
+            case failure_phase::decomposition:       return "decomposition";
+            case failure_phase::symbolization:       return "symbolization";
+            case failure_phase::type_prettification: return "type prettification";
+            case failure_phase::highlighting:        return "highlighting";
+            case failure_phase::layout:              return "layout";
+            case failure_phase::output:              return "output";
+            default:
+                return "unknown";
+        }
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::string phase_timing_summary(const color_scheme& scheme) {
+        const auto timings = phase_timings();
+        std::chrono::nanoseconds total{0};
+        for(const auto& timing : timings) {
+            total += timing.time;
+        }
+        std::string output = microfmt::format(
+            "{}Assertion failure path timing: {} total{}\n",
+            scheme.accent,
+            detail::format_duration(total),
+            scheme.reset
+        );
+        std::size_t name_width = 5;
+        for(std::size_t i = 0; i < failure_phase_count; i++) {
+            name_width = std::max(name_width, phase_name(static_cast<failure_phase>(i)).size());
+        }
+        output += microfmt::format(
+            "{}{<{}}  {>8}  {>12}  {>12}  {>6}{}\n",
+            scheme.accent,
+            name_width,
+            "Phase",
+            "Calls",
+            "Total",
+            "Mean",
+            "Share",
+            scheme.reset
+        );
+        for(std::size_t i = 0; i < failure_phase_count; i++) {
+            const auto& timing = timings[i];
+            std::string mean = "-";
+            if(timing.calls != 0) {
+                mean = detail::format_duration(timing.time / static_cast<std::int64_t>(timing.calls));
+            }
+            std::string share = "-";
+            if(total.count() != 0) {
+                share = detail::bstringf("%.1f%%", 100.0 * static_cast<double>(timing.time.count()) / total.count());
+            }
+            output += microfmt::format(
+                "{<{}}  {>8}  {>12}  {>12}  {>6}\n",
+                name_width,
+                phase_name(static_cast<failure_phase>(i)),
+                timing.calls,
+                detail::format_duration(timing.time),
+                mean,
+                share
+            );
+        }
+        return output;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void print_phase_timing_summary() {
+        enable_virtual_terminal_processing_if_needed();
+        std::string summary = phase_timing_summary(isatty(stderr_fileno) ? get_color_scheme() : color_scheme::blank);
+        (void)std::fwrite(summary.data(), 1, summary.size(), stderr);
+        (void)std::fflush(stderr);
+    }
+}
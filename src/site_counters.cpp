@@ -0,0 +1,710 @@
+#include <libassert/site-counters.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+#include "utils.hpp"
+
+#if IS_LINUX
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
+#include <libassert/assert.hpp>
+
+// File layout:
+//   counter_header (64 bytes)
+//   capacity records of 512 bytes, the first count of which are valid
+// Sequence lock: the publisher makes the sequence odd, writes the records and header fields, and makes it even again.
+// A reader accepts a snapshot of the file if the sequence was even and unchanged before and after copying it.
+
+namespace libassert::detail {
+    // the shards registered by one thread
+    struct thread_site_counters {
+        std::vector<std::pair<site_counter_shard*, std::size_t>> shards; // shard and site index
+        thread_site_counters();
+        ~thread_site_counters();
+        thread_site_counters(const thread_site_counters&) = delete;
+        thread_site_counters(thread_site_counters&&) = delete;
+        thread_site_counters& operator=(const thread_site_counters&) = delete;
+        thread_site_counters& operator=(thread_site_counters&&) = delete;
+    };
+
+    struct site_totals {
+        std::uint64_t evaluations = 0;
+        std::uint64_t failures = 0;
+        std::uint64_t sampled_evaluations = 0;
+        std::uint64_t sampled_ticks = 0;
+
+        void add(const site_counter_shard& shard) {
+            evaluations += shard.evaluations.load(std::memory_order_relaxed);
+            failures += shard.failures.load(std::memory_order_relaxed);
+            sampled_evaluations += shard.sampled_evaluations.load(std::memory_order_relaxed);
+            sampled_ticks += shard.sampled_ticks.load(std::memory_order_relaxed);
+        }
+    };
+
+    struct site_counter_registry {
+        std::mutex mutex;
+        std::vector<thread_site_counters*> threads;
+        std::vector<const site_key*> sites;
+        std::unordered_map<const site_key*, std::size_t> site_indices;
+        std::vector<site_totals> exited_totals; // counts of threads that have exited, indexed like sites
+        std::chrono::steady_clock::time_point first_registration;
+        std::uint64_t first_registration_ticks = 0; // cost_clock_now() at first_registration
+        std::string profile_path; // from LIBASSERT_SITE_PROFILE
+    };
+
+    site_counter_registry& get_site_counter_registry() {
+        static site_counter_registry registry;
+        return registry;
+    }
+
+    LIBASSERT_ATTR_COLD thread_site_counters::thread_site_counters() {
+        auto& registry = get_site_counter_registry();
+        std::unique_lock lock(registry.mutex);
+        registry.threads.push_back(this);
+    }
+
+    LIBASSERT_ATTR_COLD thread_site_counters::~thread_site_counters() {
+        auto& registry = get_site_counter_registry();
+        std::unique_lock lock(registry.mutex);
+        for(const auto& [shard, index] : shards) {
+            registry.exited_totals[index].add(*shard);
+        }
+        registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), this));
+    }
+
+    std::atomic<double> cost_budget{0.01};
+
+    // the typical difference between two back to back clock reads, which is included in every sample's time
+    LIBASSERT_ATTR_COLD std::uint64_t cost_clock_overhead() {
+        static const std::uint64_t overhead = [] {
+            std::vector<std::uint64_t> samples(1001);
+            for(auto& sample : samples) {
+                const std::uint64_t start = cost_clock_now();
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                sample = cost_clock_now() - start;
+            }
+            std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+            return samples[samples.size() / 2];
+        } ();
+        return overhead;
+    }
+
+    LIBASSERT_ATTR_COLD void write_site_profile_at_exit() {
+        try {
+            write_site_profile(get_site_counter_registry().profile_path);
+        } catch(const std::exception& e) {
+            (void)std::fprintf(stderr, "%s\n", e.what());
+        }
+    }
+
+    // the environment is checked when the first site is registered, registry.mutex must be held
+    LIBASSERT_ATTR_COLD void on_first_site_registration(site_counter_registry& registry) {
+        registry.first_registration = std::chrono::steady_clock::now();
+        registry.first_registration_ticks = cost_clock_now();
+        // calibrated here rather than during the first sample
+        (void)cost_clock_overhead();
+        const char* path = std::getenv("LIBASSERT_SITE_PROFILE"); // NOLINT(concurrency-mt-unsafe)
+        if(path != nullptr && *path != '\0') {
+            registry.profile_path = path;
+            // the registry is constructed before this so the profile is written before it's destroyed
+            std::atexit(write_site_profile_at_exit);
+        }
+    }
+
+    // rdtsc ticks are calibrated against the steady clock since the first registration, once. The calibration can sleep
+    // so registry.mutex mustn't be held, threads registering sites would wait on it.
+    LIBASSERT_ATTR_COLD double cost_ticks_per_nanosecond(site_counter_registry& registry) {
+        #ifdef LIBASSERT_COST_CLOCK_RDTSC
+        std::chrono::steady_clock::time_point first_registration;
+        std::uint64_t first_registration_ticks = 0;
+        {
+            std::unique_lock lock(registry.mutex);
+            if(registry.sites.empty()) {
+                return 1;
+            }
+            first_registration = registry.first_registration;
+            first_registration_ticks = registry.first_registration_ticks;
+        }
+        static const double ticks_per_nanosecond = [&] {
+            // too short an interval makes for a poor calibration
+            std::this_thread::sleep_until(first_registration + std::chrono::milliseconds(10));
+            const std::uint64_t ticks = cost_clock_now() - first_registration_ticks;
+            const auto elapsed = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - first_registration
+            ).count();
+            return elapsed > 0 && ticks > 0 ? static_cast<double>(ticks) / elapsed : 1;
+        } ();
+        return ticks_per_nanosecond;
+        #else
+        (void)registry;
+        return 1;
+        #endif
+    }
+
+    // xorshift64, random sample intervals keep samples from aliasing with loops
+    LIBASSERT_ATTR_COLD std::uint64_t next_cost_sample_random() {
+        thread_local std::uint64_t state = [] {
+            const auto seed = cost_clock_now() ^ reinterpret_cast<std::uintptr_t>(&state); // NOLINT
+            return seed == 0 ? 0x9e3779b97f4a7c15 : seed;
+        } ();
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    // what taking a sample costs on top of the evaluation: the clock reads plus recording it, as a moving average
+    thread_local double cost_sample_overhead = 0;
+
+    // Sampling one in every period evaluations of a site costing c per evaluation adds sample_overhead / (period * c),
+    // which has to stay below the budget
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void record_cost_sample(
+        site_counter_shard& shard,
+        std::uint64_t start,
+        std::uint64_t end
+    ) {
+        bump_site_counter(shard.sampled_evaluations);
+        shard.sampled_ticks.store(
+            shard.sampled_ticks.load(std::memory_order_relaxed) + (end - start),
+            std::memory_order_relaxed
+        );
+        const auto clock_overhead = static_cast<double>(cost_clock_overhead());
+        const double mean = static_cast<double>(shard.sampled_ticks.load(std::memory_order_relaxed))
+            / static_cast<double>(shard.sampled_evaluations.load(std::memory_order_relaxed));
+        const double cost = std::max(mean - clock_overhead, 1.0);
+        const double budget = cost_budget.load(std::memory_order_relaxed);
+        const double sample_overhead = std::max(cost_sample_overhead, clock_overhead);
+        constexpr double max_period = 1 << 24;
+        const double period = std::clamp(sample_overhead / (budget * cost), 1.0, max_period);
+        // uniform in [period / 2, period * 3 / 2) so the mean period is kept
+        const auto half = static_cast<std::uint64_t>(period / 2);
+        const auto width = std::max<std::uint64_t>(static_cast<std::uint64_t>(period), 1);
+        shard.next_cost_sample = shard.evaluations.load(std::memory_order_relaxed)
+            + std::max<std::uint64_t>(half + next_cost_sample_random() % width, 1);
+        // this call, the second clock read, and the branches around them, bounded so that a page fault or interrupt
+        // doesn't stop a site from being sampled for a long time
+        const double spent = std::min(static_cast<double>(cost_clock_now() - end), 64 * clock_overhead) + clock_overhead;
+        cost_sample_overhead = cost_sample_overhead == 0 ? spent : cost_sample_overhead * 0.9 + spent * 0.1;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void register_site_counter_shard(site_counter_shard& shard, const site_key* key) {
+        // the registry has to be constructed first so it outlives the thread_local below for the main thread
+        auto& registry = get_site_counter_registry();
+        thread_local thread_site_counters this_thread;
+        std::unique_lock lock(registry.mutex);
+        auto [it, inserted] = registry.site_indices.try_emplace(key, registry.sites.size());
+        if(inserted) {
+            if(registry.sites.empty()) {
+                on_first_site_registration(registry);
+            }
+            registry.sites.push_back(key);
+            registry.exited_totals.emplace_back();
+        }
+        this_thread.shards.emplace_back(&shard, it->second);
+        shard.key = key;
+    }
+}
+
+namespace libassert {
+    namespace {
+        constexpr char counter_magic[8] = {'L', 'A', 'S', 'I', 'T', 'E', 'S', '1'};
+        constexpr std::uint32_t counter_version = 1;
+        constexpr std::uint32_t initial_capacity = 64;
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+        struct counter_header {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t record_size;
+            std::uint32_t capacity;
+            std::uint32_t count;
+            std::uint64_t pid;
+            std::atomic<std::uint64_t> sequence;
+            std::uint64_t timestamp;
+            std::uint64_t publications;
+            unsigned char padding[8];
+        };
+        static_assert(sizeof(counter_header) == 64);
+
+        struct counter_record {
+            std::uint64_t evaluations;
+            std::uint64_t failures;
+            std::uint32_t line;
+            std::uint32_t reserved;
+            char macro_name[40];
+            char file_name[208];
+            char expression[240];
+        };
+        static_assert(sizeof(counter_record) == 512);
+
+        std::size_t counter_file_size(std::uint32_t capacity) {
+            return sizeof(counter_header) + std::size_t(capacity) * sizeof(counter_record);
+        }
+
+        // truncates and null-terminates
+        template<std::size_t N>
+        void copy_string(char (&destination)[N], std::string_view source) { // NOLINT(*-avoid-c-arrays)
+            std::size_t length = std::min(source.size(), N - 1);
+            std::memcpy(destination, source.data(), length);
+            std::memset(destination + length, 0, N - length);
+        }
+
+        template<typename T>
+        T load_field(const char* data, std::size_t offset) {
+            T value;
+            std::memcpy(&value, data + offset, sizeof(value));
+            return value;
+        }
+
+        template<std::size_t N>
+        std::string read_string(const char (&source)[N]) { // NOLINT(*-avoid-c-arrays)
+            return std::string(source, strnlen(source, N));
+        }
+
+        [[noreturn]] LIBASSERT_ATTR_COLD void throw_system_error(int code, std::string_view what, std::string_view path) {
+            throw std::system_error(
+                code,
+                std::generic_category(),
+                detail::bstringf("libassert site counters: %s \"%s\"", std::string(what).c_str(), std::string(path).c_str())
+            );
+        }
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::vector<site_counter_snapshot> site_counters() {
+        auto& registry = detail::get_site_counter_registry();
+        std::vector<const detail::site_key*> sites;
+        std::vector<detail::site_totals> totals;
+        {
+            std::unique_lock lock(registry.mutex);
+            sites = registry.sites;
+            totals = registry.exited_totals;
+            for(const auto* thread : registry.threads) {
+                for(const auto& [shard, index] : thread->shards) {
+                    totals[index].add(*shard);
+                }
+            }
+        }
+        const bool any_sampled = std::any_of(
+            totals.begin(),
+            totals.end(),
+            [] (const detail::site_totals& site) { return site.sampled_evaluations != 0; }
+        );
+        // only calibrated once needed, outside the lock
+        const double ticks_per_ns = any_sampled ? detail::cost_ticks_per_nanosecond(registry) : 1;
+        std::vector<site_counter_snapshot> snapshot;
+        snapshot.reserve(sites.size());
+        for(std::size_t i = 0; i < sites.size(); i++) {
+            const auto* key = sites[i];
+            const auto& site = totals[i];
+            std::chrono::nanoseconds estimated_cost{0};
+            if(site.sampled_evaluations != 0) {
+                const auto overhead = static_cast<double>(detail::cost_clock_overhead());
+                const double mean = static_cast<double>(site.sampled_ticks) / static_cast<double>(site.sampled_evaluations);
+                estimated_cost = std::chrono::nanoseconds(
+                    static_cast<std::int64_t>(
+                        std::max(mean - overhead, 0.0) * static_cast<double>(site.evaluations) / ticks_per_ns
+                    )
+                );
+            }
+            snapshot.push_back({
+                std::string(key->macro_name),
+                std::string(key->expr_str),
+                key->location.file,
+                static_cast<std::uint32_t>(key->location.line),
+                site.evaluations,
+                site.failures,
+                site.sampled_evaluations,
+                estimated_cost
+            });
+        }
+        return snapshot;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void set_site_cost_budget(double fraction) {
+        if(!(fraction > 0 && fraction <= 1)) {
+            throw std::invalid_argument(
+                detail::bstringf("libassert: site cost budget must be in (0, 1], got %f", fraction)
+            );
+        }
+        detail::cost_budget.store(fraction, std::memory_order_relaxed);
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT double site_cost_budget() {
+        return detail::cost_budget.load(std::memory_order_relaxed);
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::vector<site_counter_snapshot> site_cost_ranking() {
+        auto sites = site_counters();
+        std::stable_sort(sites.begin(), sites.end(), [](const site_counter_snapshot& a, const site_counter_snapshot& b) {
+            return a.estimated_cost > b.estimated_cost;
+        });
+        return sites;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::string site_cost_report(std::size_t rows) {
+        const auto sites = site_cost_ranking();
+        std::chrono::nanoseconds total{0};
+        for(const auto& site : sites) {
+            total += site.estimated_cost;
+        }
+        std::string report = detail::bstringf(
+            "Assertion site cost: %.3fms estimated total, %zu sites\n",
+            static_cast<double>(total.count()) / 1e6,
+            sites.size()
+        );
+        report += detail::bstringf(
+            "%12s  %6s  %10s  %14s  %10s  %s\n",
+            "Estimated",
+            "Share",
+            "Per eval",
+            "Evaluations",
+            "Sampled",
+            "Location: Expression"
+        );
+        for(std::size_t i = 0; i < std::min(rows, sites.size()); i++) {
+            const auto& site = sites[i];
+            std::string share = "-";
+            std::string per_evaluation = "-";
+            if(total.count() != 0) {
+                share = detail::bstringf("%.1f%%", 100.0 * static_cast<double>(site.estimated_cost.count()) / total.count());
+            }
+            if(site.sampled_evaluations != 0) {
+                per_evaluation = detail::bstringf(
+                    "%.1fns",
+                    static_cast<double>(site.estimated_cost.count()) / static_cast<double>(site.evaluations)
+                );
+            }
+            report += detail::bstringf(
+                "%10.3fms  %6s  %10s  %14llu  %10llu  %s:%u: %s\n",
+                static_cast<double>(site.estimated_cost.count()) / 1e6,
+                share.c_str(),
+                per_evaluation.c_str(),
+                static_cast<unsigned long long>(site.evaluations),
+                static_cast<unsigned long long>(site.sampled_evaluations),
+                site.file_name.c_str(),
+                site.line,
+                site.expression.c_str()
+            );
+        }
+        return report;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::string default_site_counter_path(std::uint64_t pid) {
+        return "/dev/shm/libassert-" + std::to_string(pid) + ".counters";
+    }
+
+    #if IS_LINUX
+    LIBASSERT_ATTR_COLD site_counter_publisher::site_counter_publisher(
+        std::chrono::milliseconds interval_,
+        std::string_view path
+    ) : file_path(path.empty() ? default_site_counter_path(static_cast<std::uint64_t>(getpid())) : std::string(path)),
+        interval(interval_) {
+        fd = open(file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if(fd == -1) {
+            throw_system_error(errno, "failed to open", file_path);
+        }
+        std::size_t size = counter_file_size(initial_capacity);
+        void* addr = MAP_FAILED;
+        if(ftruncate(fd, static_cast<off_t>(size)) == 0) {
+            addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if(addr == MAP_FAILED) {
+            int code = errno;
+            close(fd);
+            unlink(file_path.c_str());
+            throw_system_error(code, "failed to map", file_path);
+        }
+        base = static_cast<unsigned char*>(addr);
+        mapping_size = size;
+        auto* header = new (base) counter_header{};
+        header->version = counter_version;
+        header->record_size = sizeof(counter_record);
+        header->capacity = initial_capacity;
+        header->pid = static_cast<std::uint64_t>(getpid());
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(header->magic, counter_magic, sizeof(counter_magic));
+        publish_now();
+        thread = std::thread([this] {
+            std::unique_lock lock(mutex);
+            while(!cv.wait_for(lock, interval, [this] { return stopping; })) {
+                publish_locked();
+            }
+        });
+    }
+
+    LIBASSERT_ATTR_COLD site_counter_publisher::~site_counter_publisher() {
+        {
+            std::unique_lock lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        thread.join();
+        munmap(base, mapping_size);
+        close(fd);
+        unlink(file_path.c_str());
+    }
+
+    LIBASSERT_ATTR_COLD void site_counter_publisher::publish_locked() {
+        auto sites = site_counters();
+        auto* header = reinterpret_cast<counter_header*>(base); // NOLINT
+        const std::uint64_t sequence = header->sequence.load(std::memory_order_relaxed);
+        header->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::uint32_t capacity = header->capacity;
+        if(sites.size() > capacity) {
+            // grow, if that fails the sites that fit are still published
+            auto new_capacity = static_cast<std::uint32_t>(std::max<std::size_t>(std::size_t(capacity) * 2, sites.size()));
+            std::size_t new_size = counter_file_size(new_capacity);
+            if(ftruncate(fd, static_cast<off_t>(new_size)) == 0) {
+                void* addr = mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if(addr != MAP_FAILED) {
+                    munmap(base, mapping_size);
+                    base = static_cast<unsigned char*>(addr);
+                    mapping_size = new_size;
+                    header = reinterpret_cast<counter_header*>(base); // NOLINT
+                    header->capacity = capacity = new_capacity;
+                }
+            }
+        }
+        auto count = static_cast<std::uint32_t>(std::min<std::size_t>(sites.size(), capacity));
+        auto* records = reinterpret_cast<counter_record*>(base + sizeof(counter_header)); // NOLINT
+        for(std::uint32_t i = 0; i < count; i++) {
+            const auto& site = sites[i];
+            auto& record = records[i];
+            record.evaluations = site.evaluations;
+            record.failures = site.failures;
+            record.line = site.line;
+            record.reserved = 0;
+            copy_string(record.macro_name, site.macro_name);
+            copy_string(record.file_name, site.file_name);
+            copy_string(record.expression, site.expression);
+        }
+        header->count = count;
+        header->timestamp = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()
+            ).count()
+        );
+        header->publications++;
+        header->sequence.store(sequence + 2, std::memory_order_release);
+    }
+    #else
+    LIBASSERT_ATTR_COLD site_counter_publisher::site_counter_publisher(std::chrono::milliseconds interval_, std::string_view path)
+        : file_path(path), interval(interval_) {
+        throw_system_error(ENOSYS, "publishing isn't supported on this platform", file_path);
+    }
+
+    LIBASSERT_ATTR_COLD site_counter_publisher::~site_counter_publisher() = default;
+
+    LIBASSERT_ATTR_COLD void site_counter_publisher::publish_locked() {}
+    #endif
+
+    LIBASSERT_ATTR_COLD void site_counter_publisher::publish_now() {
+        std::unique_lock lock(mutex);
+        publish_locked();
+    }
+
+    LIBASSERT_ATTR_COLD const std::string& site_counter_publisher::path() const noexcept {
+        return file_path;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT site_counter_sample read_site_counters(std::string_view path) {
+        std::string path_str(path);
+        constexpr int attempts = 100;
+        for(int attempt = 0; attempt < attempts; attempt++) {
+            std::ifstream stream(path_str, std::ios::binary);
+            if(!stream) {
+                throw_system_error(errno, "failed to open", path);
+            }
+            std::vector<char> contents{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+            if(
+                contents.size() < sizeof(counter_header)
+                || std::memcmp(contents.data(), counter_magic, sizeof(counter_magic)) != 0
+                || load_field<std::uint32_t>(contents.data(), offsetof(counter_header, version)) != counter_version
+                || load_field<std::uint32_t>(contents.data(), offsetof(counter_header, record_size)) != sizeof(counter_record)
+            ) {
+                throw std::runtime_error(detail::bstringf("libassert: \"%s\" is not a site counter file", path_str.c_str()));
+            }
+            const auto sequence = load_field<std::uint64_t>(contents.data(), offsetof(counter_header, sequence));
+            const auto capacity = load_field<std::uint32_t>(contents.data(), offsetof(counter_header, capacity));
+            const auto count = load_field<std::uint32_t>(contents.data(), offsetof(counter_header, count));
+            // check the sequence again after the copy
+            std::uint64_t sequence_after = sequence + 1;
+            stream.clear();
+            stream.seekg(offsetof(counter_header, sequence));
+            stream.read(reinterpret_cast<char*>(&sequence_after), sizeof(sequence_after)); // NOLINT
+            if(
+                !stream
+                || sequence % 2 != 0
+                || sequence != sequence_after
+                || count > capacity
+                || contents.size() < counter_file_size(count)
+            ) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            site_counter_sample sample{
+                load_field<std::uint64_t>(contents.data(), offsetof(counter_header, pid)),
+                std::chrono::nanoseconds(load_field<std::uint64_t>(contents.data(), offsetof(counter_header, timestamp))),
+                load_field<std::uint64_t>(contents.data(), offsetof(counter_header, publications)),
+                {}
+            };
+            const char* records = contents.data() + sizeof(counter_header);
+            for(std::uint32_t i = 0; i < count; i++) {
+                counter_record record;
+                std::memcpy(&record, records + std::size_t(i) * sizeof(counter_record), sizeof(record));
+                sample.sites.push_back({
+                    read_string(record.macro_name),
+                    read_string(record.expression),
+                    read_string(record.file_name),
+                    record.line,
+                    record.evaluations,
+                    record.failures
+                });
+            }
+            return sample;
+        }
+        throw std::runtime_error(
+            detail::bstringf("libassert: no consistent publication could be read from \"%s\"", path_str.c_str())
+        );
+    }
+    namespace {
+        constexpr std::string_view profile_magic = "# libassert site profile v1";
+
+        // Expressions are stringified with whitespace normalized and file names and macro names are unlikely to have
+        // tabs or newlines, replace them anyway so every site stays on one line
+        std::string profile_field(std::string_view value) {
+            std::string field(value);
+            std::replace_if(field.begin(), field.end(), [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+            return field;
+        }
+
+        [[noreturn]] LIBASSERT_ATTR_COLD void throw_invalid_profile(std::string_view path, std::size_t line_number) {
+            throw std::runtime_error(
+                detail::bstringf(
+                    "libassert: \"%s\" is not a site profile (line %zu)",
+                    std::string(path).c_str(),
+                    line_number
+                )
+            );
+        }
+    }
+
+    // Format:
+    //   # libassert site profile v1
+    //   duration_ns <n>
+    //   one line per site: evaluations failures line macro file expression, separated by tabs
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void write_site_profile(std::string_view path) {
+        auto sites = site_counters();
+        std::chrono::nanoseconds duration{0};
+        {
+            auto& registry = detail::get_site_counter_registry();
+            std::unique_lock lock(registry.mutex);
+            if(!registry.sites.empty()) {
+                duration = std::chrono::steady_clock::now() - registry.first_registration;
+            }
+        }
+        std::string path_str(path);
+        std::ofstream stream(path_str, std::ios::trunc);
+        if(!stream) {
+            throw_system_error(errno, "failed to open", path);
+        }
+        stream << profile_magic << '\n' << "duration_ns " << duration.count() << '\n';
+        for(const auto& site : sites) {
+            stream << site.evaluations << '\t' << site.failures << '\t' << site.line << '\t'
+                   << profile_field(site.macro_name) << '\t' << profile_field(site.file_name) << '\t'
+                   << profile_field(site.expression) << '\n';
+        }
+        stream.flush();
+        if(!stream) {
+            throw_system_error(errno, "failed to write", path);
+        }
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT site_profile read_site_profile(std::string_view path) {
+        std::string path_str(path);
+        std::ifstream stream(path_str);
+        if(!stream) {
+            throw_system_error(errno, "failed to open", path);
+        }
+        std::string line;
+        if(!std::getline(stream, line) || line != profile_magic) {
+            throw_invalid_profile(path, 1);
+        }
+        site_profile profile{};
+        {
+            long long duration = 0;
+            std::string key;
+            if(!std::getline(stream, line) || !(std::istringstream(line) >> key >> duration) || key != "duration_ns") {
+                throw_invalid_profile(path, 2);
+            }
+            profile.duration = std::chrono::nanoseconds(duration);
+        }
+        for(std::size_t line_number = 3; std::getline(stream, line); line_number++) {
+            if(line.empty()) {
+                continue;
+            }
+            std::vector<std::string_view> fields;
+            std::string_view rest = line;
+            for(int i = 0; i < 5; i++) {
+                auto tab = rest.find('\t');
+                if(tab == std::string_view::npos) {
+                    throw_invalid_profile(path, line_number);
+                }
+                fields.push_back(rest.substr(0, tab));
+                rest.remove_prefix(tab + 1);
+            }
+            fields.push_back(rest);
+            site_counter_snapshot site{
+                std::string(fields[3]),
+                std::string(fields[5]),
+                std::string(fields[4]),
+                0,
+                0,
+                0
+            };
+            unsigned long long evaluations = 0;
+            unsigned long long failures = 0;
+            unsigned long site_line = 0;
+            if(
+                !(std::istringstream(std::string(fields[0])) >> evaluations)
+                || !(std::istringstream(std::string(fields[1])) >> failures)
+                || !(std::istringstream(std::string(fields[2])) >> site_line)
+            ) {
+                throw_invalid_profile(path, line_number);
+            }
+            site.evaluations = evaluations;
+            site.failures = failures;
+            site.line = static_cast<std::uint32_t>(site_line);
+            profile.sites.push_back(std::move(site));
+        }
+        return profile;
+    }
+}
@@ -0,0 +1,377 @@
+#include <libassert/site-map.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+#include "utils.hpp"
+
+#include <libassert/assert.hpp>
+
+namespace libassert::detail {
+    struct stripped_site {
+        std::string file_name;
+        std::vector<std::string> arg_names;
+        std::vector<std::string_view> args_strings;
+        assert_static_parameters params;
+    };
+
+    LIBASSERT_ATTR_COLD std::string_view stripped_macro_name(assert_type type) {
+        switch(type) {
+            case assert_type::debug_assertion: return "DEBUG_ASSERT";
+            case assert_type::assertion:       return "ASSERT";
+            case assert_type::assumption:      return "ASSUME";
+            case assert_type::panic:           return "PANIC";
+            case assert_type::unreachable:     return "UNREACHABLE";
+            default:                           return "ASSERT";
+        }
+    }
+
+    // The macro name is only known up to the assertion type, the site map has the exact one. Arguments are named by
+    // their position, starting at 1.
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT const assert_static_parameters* stripped_static_parameters(
+        std::uint64_t site_id,
+        assert_type type,
+        std::size_t n_args
+    ) {
+        static std::mutex mutex;
+        static std::map<std::pair<std::uint64_t, assert_type>, std::unique_ptr<stripped_site>> sites;
+        std::unique_lock lock(mutex);
+        auto& site = sites[{site_id, type}];
+        if(!site) {
+            site = std::make_unique<stripped_site>();
+            site->file_name = bstringf("site#%016llx", static_cast<unsigned long long>(site_id));
+            for(std::size_t i = 0; i < n_args; i++) {
+                site->arg_names.push_back("$" + std::to_string(i + 1));
+            }
+            for(const auto& name : site->arg_names) {
+                site->args_strings.emplace_back(name);
+            }
+            // trailing terminator, as in the arrays LIBASSERT_STATIC_DATA emits otherwise
+            site->args_strings.emplace_back("");
+            site->params = {
+                stripped_macro_name(type),
+                type,
+                "",
+                source_location{site->file_name.c_str(), 0},
+                {site->args_strings.data(), site->args_strings.size()}
+            };
+        }
+        return &site->params;
+    }
+}
+
+namespace libassert {
+    namespace {
+        constexpr std::string_view site_map_magic = "# libassert site map v1";
+
+        [[noreturn]] LIBASSERT_ATTR_COLD void throw_system_error(int code, std::string_view what, std::string_view path) {
+            throw std::system_error(
+                code,
+                std::generic_category(),
+                detail::bstringf("libassert site map: %s \"%s\"", std::string(what).c_str(), std::string(path).c_str())
+            );
+        }
+
+        [[noreturn]] LIBASSERT_ATTR_COLD void throw_invalid_site_map(std::string_view path, std::size_t line_number) {
+            throw std::runtime_error(
+                detail::bstringf(
+                    "libassert: \"%s\" is not a site map (line %zu)",
+                    std::string(path).c_str(),
+                    line_number
+                )
+            );
+        }
+
+        std::vector<std::string_view> split(std::string_view str, char separator) {
+            std::vector<std::string_view> parts;
+            for(;;) {
+                const auto end = str.find(separator);
+                parts.push_back(str.substr(0, end));
+                if(end == std::string_view::npos) {
+                    return parts;
+                }
+                str.remove_prefix(end + 1);
+            }
+        }
+
+        std::string escape_field(std::string_view value) {
+            std::string field;
+            for(char c : value) {
+                switch(c) {
+                    case '\\': field += "\\\\"; break;
+                    case '\t': field += "\\t"; break;
+                    case '\n': field += "\\n"; break;
+                    case '\r': field += "\\r"; break;
+                    default:   field += c; break;
+                }
+            }
+            return field;
+        }
+
+        bool unescape_field(std::string_view field, std::string& value) {
+            value.clear();
+            for(std::size_t i = 0; i < field.size(); i++) {
+                if(field[i] != '\\') {
+                    value += field[i];
+                    continue;
+                }
+                if(++i == field.size()) {
+                    return false;
+                }
+                switch(field[i]) {
+                    case '\\': value += '\\'; break;
+                    case 't':  value += '\t'; break;
+                    case 'n':  value += '\n'; break;
+                    case 'r':  value += '\r'; break;
+                    default:   return false;
+                }
+            }
+            return true;
+        }
+
+        bool parse_u64(std::string_view str, int base, std::uint64_t& value) {
+            if(str.empty() || str.size() > 20) {
+                return false;
+            }
+            std::string copy(str);
+            char* end = nullptr;
+            errno = 0;
+            value = std::strtoull(copy.c_str(), &end, base);
+            return errno == 0 && end == copy.c_str() + copy.size() && copy[0] != '-' && copy[0] != '+';
+        }
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::vector<site_map_entry> parse_site_records(std::string_view section) {
+        std::vector<site_map_entry> sites;
+        std::unordered_set<std::uint64_t> seen;
+        std::size_t offset = 0;
+        while(offset + sizeof(std::uint32_t) <= section.size()) {
+            std::uint32_t magic;
+            std::memcpy(&magic, section.data() + offset, sizeof(magic));
+            if(magic == 0) {
+                // padding from the alignment of the next record
+                offset += sizeof(std::uint32_t);
+                continue;
+            }
+            std::uint32_t size = 0;
+            if(magic == detail::site_record_magic && offset + 2 * sizeof(std::uint32_t) <= section.size()) {
+                std::memcpy(&size, section.data() + offset + sizeof(std::uint32_t), sizeof(size));
+            }
+            const std::size_t strings_offset = offset + 2 * sizeof(std::uint32_t);
+            if(
+                magic != detail::site_record_magic
+                || size == 0
+                || size > section.size() - std::min(strings_offset, section.size())
+                || section[strings_offset + size - 1] != '\0'
+            ) {
+                throw std::runtime_error(detail::bstringf("libassert: malformed site record at offset %zu", offset));
+            }
+            const std::string_view strings = section.substr(strings_offset, size);
+            auto parts = split(strings.substr(0, size - 1), '\0');
+            if(parts.size() < 4) {
+                throw std::runtime_error(detail::bstringf("libassert: malformed site record at offset %zu", offset));
+            }
+            const std::uint64_t id = detail::site_id(strings.data(), strings.size());
+            if(seen.insert(id).second) {
+                std::uint64_t line = 0;
+                (void)parse_u64(parts[2], 10, line);
+                site_map_entry site{
+                    id,
+                    std::string(parts[0]),
+                    std::string(parts[1]),
+                    static_cast<std::uint32_t>(line),
+                    std::string(parts[3]),
+                    {}
+                };
+                // LIBASSERT_MAP leaves an empty argument at the end
+                if(parts.size() > 4 && parts.back().empty()) {
+                    parts.pop_back();
+                }
+                for(std::size_t i = 4; i < parts.size(); i++) {
+                    site.args.emplace_back(parts[i]);
+                }
+                sites.push_back(std::move(site));
+            }
+            offset = (strings_offset + size + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t) * sizeof(std::uint32_t);
+        }
+        return sites;
+    }
+
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT void write_site_map(
+        const std::string& path,
+        const std::vector<site_map_entry>& sites
+    ) {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if(!stream) {
+            throw_system_error(errno, "failed to open", path);
+        }
+        stream << site_map_magic << '\n';
+        for(const auto& site : sites) {
+            stream << detail::bstringf("%016llx", static_cast<unsigned long long>(site.id)) << '\t'
+                   << escape_field(site.macro_name) << '\t' << escape_field(site.file_name) << '\t' << site.line
+                   << '\t' << escape_field(site.expression);
+            for(const auto& arg : site.args) {
+                stream << '\t' << escape_field(arg);
+            }
+            stream << '\n';
+        }
+        stream.flush();
+        if(!stream) {
+            throw_system_error(errno, "failed to write", path);
+        }
+    }
+
+    // Format:
+    //   # libassert site map v1
+    //   one line per site: id macro file line expression args..., separated by tabs
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::vector<site_map_entry> read_site_map(const std::string& path) {
+        std::ifstream stream(path, std::ios::binary);
+        if(!stream) {
+            throw_system_error(errno, "failed to open", path);
+        }
+        std::string line;
+        if(!std::getline(stream, line) || line != site_map_magic) {
+            throw_invalid_site_map(path, 1);
+        }
+        std::vector<site_map_entry> sites;
+        for(std::size_t line_number = 2; std::getline(stream, line); line_number++) {
+            if(line.empty()) {
+                continue;
+            }
+            const auto fields = split(line, '\t');
+            site_map_entry site{};
+            std::uint64_t site_line = 0;
+            if(
+                fields.size() < 5
+                || fields[0].size() != 16
+                || !parse_u64(fields[0], 16, site.id)
+                || !parse_u64(fields[3], 10, site_line)
+                || !unescape_field(fields[1], site.macro_name)
+                || !unescape_field(fields[2], site.file_name)
+                || !unescape_field(fields[4], site.expression)
+            ) {
+                throw_invalid_site_map(path, line_number);
+            }
+            site.line = static_cast<std::uint32_t>(site_line);
+            for(std::size_t i = 5; i < fields.size(); i++) {
+                if(!unescape_field(fields[i], site.args.emplace_back())) {
+                    throw_invalid_site_map(path, line_number);
+                }
+            }
+            sites.push_back(std::move(site));
+        }
+        return sites;
+    }
+
+    namespace {
+        // the statement of a stripped site as printed by assertion_info::statement: MACRO(); or MACRO(...);
+        bool is_stripped_statement(std::string_view line) {
+            const auto start = line.find_first_not_of(' ');
+            if(start == std::string_view::npos) {
+                return false;
+            }
+            line.remove_prefix(start);
+            const auto paren = line.find('(');
+            return paren != std::string_view::npos
+                && paren > 0
+                && (line.substr(paren) == "();" || line.substr(paren) == "(...);");
+        }
+
+        std::string expanded_statement(const site_map_entry& site) {
+            std::string statement = site.macro_name + "(" + site.expression;
+            if(!site.args.empty()) {
+                statement += site.expression.empty() ? "..." : ", ...";
+            }
+            return statement + ");";
+        }
+    }
+
+    // Reports are expanded line by line, a site's statement and extra diagnostics follow the line with its location
+    // up to the next empty line
+    LIBASSERT_ATTR_COLD LIBASSERT_EXPORT std::string expand_site_ids(
+        std::string_view text,
+        const std::vector<site_map_entry>& sites
+    ) {
+        constexpr std::string_view prefix = "site#";
+        constexpr std::size_t id_length = 16;
+        std::unordered_map<std::uint64_t, const site_map_entry*> by_id;
+        for(const auto& site : sites) {
+            by_id.emplace(site.id, &site);
+        }
+        std::string output;
+        const site_map_entry* current = nullptr;
+        bool statement_pending = false;
+        for(auto line : split(text, '\n')) {
+            std::string expanded;
+            bool found_site = false;
+            for(auto pos = line.find(prefix); pos != std::string_view::npos; pos = line.find(prefix)) {
+                std::uint64_t id = 0;
+                auto it = by_id.end();
+                const auto id_str = line.substr(pos + prefix.size(), id_length);
+                if(id_str.size() == id_length && parse_u64(id_str, 16, id)) {
+                    it = by_id.find(id);
+                }
+                if(it == by_id.end()) {
+                    expanded += line.substr(0, pos + prefix.size());
+                    line.remove_prefix(pos + prefix.size());
+                    continue;
+                }
+                expanded += line.substr(0, pos);
+                expanded += it->second->file_name;
+                line.remove_prefix(pos + prefix.size() + id_length);
+                if(line.substr(0, 2) == ":0") {
+                    line.remove_prefix(2);
+                }
+                expanded += ":" + std::to_string(it->second->line);
+                current = it->second;
+                found_site = true;
+            }
+            expanded += line;
+            if(!found_site && current) {
+                const auto indent = expanded.find_first_not_of(' ');
+                if(indent == std::string::npos) {
+                    current = nullptr;
+                } else if(statement_pending && is_stripped_statement(expanded)) {
+                    expanded = expanded.substr(0, indent) + expanded_statement(*current);
+                } else if(expanded[indent] == '$') {
+                    // an extra diagnostic, $n is the nth argument
+                    const auto end = expanded.find(' ', indent);
+                    std::uint64_t index = 0;
+                    if(
+                        end != std::string::npos
+                        && parse_u64(std::string_view(expanded).substr(indent + 1, end - indent - 1), 10, index)
+                        && index >= 1
+                        && index <= current->args.size()
+                    ) {
+                        expanded = expanded.substr(0, indent) + current->args[index - 1] + expanded.substr(end);
+                    }
+                }
+                statement_pending = false;
+            } else {
+                statement_pending = found_site;
+            }
+            output += expanded;
+            output += '\n';
+        }
+        // split produces an extra empty part after a trailing newline
+        output.pop_back();
+        return output;
+    }
+}
@@ -0,0 +1,408 @@
+#include <libassert/socket-sink.hpp>
+
+#include "common.hpp"
+
+#if !IS_WINDOWS
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "utils.hpp"
+
+#include <libassert/assert.hpp>
+
+namespace libassert {
+    namespace {
+        void append_u32(std::string& out, std::uint32_t value) {
+            for(int i = 0; i < 4; i++) {
+                out += static_cast<char>((value >> (8 * i)) & 0xff);
+            }
+        }
+
+        void append_field(std::string& out, std::string_view field) {
+            append_u32(out, static_cast<std::uint32_t>(field.size()));
+            out += field;
+        }
+
+        // the report is cut short so the record fits in max_size, the other fields are small and kept whole so the
+        // record's framing stays valid, if they don't fit either the record is dropped by submit
+        LIBASSERT_ATTR_COLD std::string serialize_failure_record(const assertion_info& info, std::size_t max_size) {
+            std::string payload;
+            append_field(payload, info.action());
+            append_field(payload, info.file_name);
+            append_field(payload, std::to_string(info.line));
+            append_field(payload, info.function);
+            append_field(payload, info.expression_string);
+            append_field(payload, info.message ? std::string_view(*info.message) : std::string_view());
+            const std::string report = info.to_string(0, color_scheme::blank);
+            const std::size_t room = max_size > payload.size() + 4 ? max_size - (payload.size() + 4) : 0;
+            append_field(payload, std::string_view(report).substr(0, room));
+            return payload;
+        }
+
+        #ifdef MSG_NOSIGNAL
+         constexpr int send_flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+        #else
+         constexpr int send_flags = MSG_DONTWAIT; // SO_NOSIGPIPE is set on the socket instead
+        #endif
+
+        // bounded mpmc queue, https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+        class record_queue {
+            struct cell {
+                std::atomic<std::size_t> sequence;
+                std::string data;
+            };
+            std::unique_ptr<cell[]> cells;
+            std::size_t mask;
+            alignas(64) std::atomic<std::size_t> enqueue_pos{0};
+            alignas(64) std::atomic<std::size_t> dequeue_pos{0};
+        public:
+            explicit record_queue(std::size_t capacity) {
+                std::size_t size = 2;
+                while(size < capacity) {
+                    size *= 2;
+                }
+                cells = std::make_unique<cell[]>(size);
+                mask = size - 1;
+                for(std::size_t i = 0; i < size; i++) {
+                    cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            bool try_push(std::string&& record) {
+                std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+                cell* c;
+                for(;;) {
+                    c = &cells[pos & mask];
+                    std::size_t sequence = c->sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+                    if(diff == 0) {
+                        if(enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    } else if(diff < 0) {
+                        return false; // full
+                    } else {
+                        pos = enqueue_pos.load(std::memory_order_relaxed);
+                    }
+                }
+                c->data = std::move(record);
+                c->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            bool try_pop(std::string& record) {
+                std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+                cell* c;
+                for(;;) {
+                    c = &cells[pos & mask];
+                    std::size_t sequence = c->sequence.load(std::memory_order_acquire);
+                    auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+                    if(diff == 0) {
+                        if(dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    } else if(diff < 0) {
+                        return false; // empty
+                    } else {
+                        pos = dequeue_pos.load(std::memory_order_relaxed);
+                    }
+                }
+                record = std::move(c->data);
+                c->data = std::string();
+                c->sequence.store(pos + mask + 1, std::memory_order_release);
+                return true;
+            }
+        };
+
+    }
+
+    class unix_socket_sink::impl {
+    public:
+        unix_socket_sink_options options;
+        record_queue queue;
+        std::atomic<std::uint64_t> sent_count{0};
+        std::atomic<std::uint64_t> dropped_count{0};
+        // everything below is guarded by send_mutex
+        std::mutex send_mutex;
+        int fd = -1;
+        std::string pending; // batch being sent, may be partially sent
+        std::size_t pending_offset = 0;
+        std::deque<std::size_t> pending_records; // sizes of the records in pending
+        // background thread
+        std::mutex thread_mutex;
+        std::condition_variable thread_cv;
+        bool stopping = false;
+        std::thread thread;
+
+        explicit impl(unix_socket_sink_options options_)
+            : options(std::move(options_)), queue(options.queue_capacity) {
+            thread = std::thread([this] { run(); });
+        }
+
+        ~impl() {
+            {
+                std::unique_lock lock(thread_mutex);
+                stopping = true;
+            }
+            thread_cv.notify_one();
+            thread.join();
+            flush_for(options.flush_interval);
+            std::unique_lock lock(send_mutex);
+            disconnect(false);
+            dropped_count += pending_records.size();
+            // and whatever didn't make it into the last batch
+            std::string record;
+            while(queue.try_pop(record)) {
+                dropped_count++;
+            }
+        }
+
+        void run() {
+            std::unique_lock lock(thread_mutex);
+            while(!stopping) {
+                thread_cv.wait_for(lock, options.flush_interval);
+                lock.unlock();
+                {
+                    std::unique_lock send_lock(send_mutex);
+                    send_available();
+                }
+                lock.lock();
+            }
+        }
+
+        bool submit(std::string_view payload) {
+            // a truncated payload couldn't be parsed by the collector
+            if(payload.size() > options.max_record_size) {
+                dropped_count++;
+                return false;
+            }
+            std::string record;
+            record.reserve(4 + payload.size());
+            append_u32(record, static_cast<std::uint32_t>(payload.size()));
+            record += payload;
+            if(!queue.try_push(std::move(record))) {
+                dropped_count++;
+                return false;
+            }
+            return true;
+        }
+
+        bool submit(const assertion_info& info) {
+            return submit(serialize_failure_record(info, options.max_record_size));
+        }
+
+        bool connect() {
+            if(fd != -1) {
+                return true;
+            }
+            sockaddr_un addr{};
+            if(options.path.size() >= sizeof(addr.sun_path)) {
+                return false;
+            }
+            addr.sun_family = AF_UNIX;
+            std::memcpy(addr.sun_path, options.path.c_str(), options.path.size() + 1);
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if(fd == -1) {
+                return false;
+            }
+            (void)fcntl(fd, F_SETFD, FD_CLOEXEC);
+            #ifdef SO_NOSIGPIPE
+             int one = 1;
+             (void)setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+            #endif
+            if(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) { // NOLINT
+                close(fd);
+                fd = -1;
+                return false;
+            }
+            (void)fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            return true;
+        }
+
+        void disconnect(bool drop_pending) {
+            if(fd != -1) {
+                close(fd);
+                fd = -1;
+            }
+            // a partially sent batch can't be resumed on a new connection
+            if(drop_pending) {
+                dropped_count += pending_records.size();
+                pending.clear();
+                pending_offset = 0;
+                pending_records.clear();
+            }
+        }
+
+        void fill_batch() {
+            if(pending_offset == pending.size()) {
+                pending.clear();
+                pending_offset = 0;
+            }
+            std::string record;
+            while(pending.size() < options.max_batch_size && queue.try_pop(record)) {
+                pending += record;
+                pending_records.push_back(record.size());
+            }
+        }
+
+        // sends as much as can be sent without blocking, returns false if the connection is unusable
+        bool send_available() {
+            if(!connect()) {
+                // leave records in the queue, they're dropped by submit once it fills up
+                return false;
+            }
+            for(;;) {
+                fill_batch();
+                if(pending_offset == pending.size()) {
+                    return true;
+                }
+                ssize_t n = send(fd, pending.data() + pending_offset, pending.size() - pending_offset, send_flags);
+                if(n < 0) {
+                    if(errno == EINTR) {
+                        continue;
+                    }
+                    if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                        return true;
+                    }
+                    disconnect(true);
+                    return false;
+                }
+                pending_offset += static_cast<std::size_t>(n);
+                // pop fully sent records
+                std::size_t offset = 0;
+                while(!pending_records.empty() && offset + pending_records.front() <= pending_offset) {
+                    offset += pending_records.front();
+                    pending_records.pop_front();
+                    sent_count++;
+                }
+                pending.erase(0, offset);
+                pending_offset -= offset;
+            }
+        }
+
+        bool flush_for(std::chrono::milliseconds timeout) {
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            std::unique_lock lock(send_mutex);
+            for(;;) {
+                if(!send_available()) {
+                    return false;
+                }
+                fill_batch();
+                if(pending_records.empty()) {
+                    return true;
+                }
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()
+                );
+                if(remaining.count() <= 0) {
+                    return false;
+                }
+                pollfd pfd{fd, POLLOUT, 0};
+                (void)poll(&pfd, 1, static_cast<int>(remaining.count()));
+            }
+        }
+    };
+
+    namespace {
+        struct installed_sink_state {
+            std::mutex mutex;
+            // shared so a failing thread can flush the sink without holding the mutex, the sink's destructor may run
+            // meanwhile
+            std::shared_ptr<unix_socket_sink::impl> sink;
+            // the handler which was set before the first sink, restored when the installed sink is destroyed
+            detail::failure_handler_type previous_handler = default_failure_handler;
+        };
+
+        // initialized on first use, libassert has no static initializers
+        installed_sink_state& get_installed_sink_state() {
+            static installed_sink_state state;
+            return state;
+        }
+
+        LIBASSERT_ATTR_COLD void socket_sink_failure_handler(const assertion_info& info) {
+            auto& state = get_installed_sink_state();
+            std::shared_ptr<unix_socket_sink::impl> sink;
+            {
+                std::unique_lock lock(state.mutex);
+                sink = state.sink;
+            }
+            if(sink) {
+                sink->submit(info);
+                sink->flush_for(std::chrono::seconds(1));
+            }
+            default_failure_handler(info);
+        }
+    }
+
+    unix_socket_sink::unix_socket_sink(unix_socket_sink_options options)
+        : pimpl(std::make_shared<impl>(std::move(options))) {}
+
+    unix_socket_sink::~unix_socket_sink() {
+        auto& state = get_installed_sink_state();
+        std::unique_lock lock(state.mutex);
+        if(state.sink == pimpl) {
+            state.sink.reset();
+            // unless another handler was set after the sink was installed
+            detail::replace_failure_handler(socket_sink_failure_handler, state.previous_handler);
+        }
+    }
+
+    bool unix_socket_sink::submit(const assertion_info& info) {
+        return pimpl->submit(info);
+    }
+
+    bool unix_socket_sink::submit(std::string_view payload) {
+        // no wakeup here, the background thread picks records up in batches every flush_interval
+        return pimpl->submit(payload);
+    }
+
+    bool unix_socket_sink::flush(std::chrono::milliseconds timeout) {
+        return pimpl->flush_for(timeout);
+    }
+
+    std::uint64_t unix_socket_sink::sent() const noexcept {
+        return pimpl->sent_count.load();
+    }
+
+    std::uint64_t unix_socket_sink::dropped() const noexcept {
+        return pimpl->dropped_count.load();
+    }
+
+    void unix_socket_sink::install_failure_handler() {
+        auto& state = get_installed_sink_state();
+        std::unique_lock lock(state.mutex);
+        state.sink = pimpl;
+        const auto previous = detail::exchange_failure_handler(socket_sink_failure_handler);
+        // replacing another sink keeps the handler from before it
+        if(previous != socket_sink_failure_handler) {
+            state.previous_handler = previous;
+        }
+    }
+
+    LIBASSERT_ATTR_COLD std::string serialize_failure_record(const assertion_info& info) {
+        return serialize_failure_record(info, std::numeric_limits<std::size_t>::max());
+    }
+}
+
+#endif
@@ -0,0 +1,77 @@
+#include "stacktrace.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "utils.hpp"
+
+#include <libassert/assert.hpp>
+
+namespace libassert::detail {
+    #if defined(LIBASSERT_STACKTRACE_BACKEND_NONE)
+
+    LIBASSERT_ATTR_COLD
+    std::vector<trace_frame> trace_frames(const stacktrace_type&) {
+        return {};
+    }
+
+    LIBASSERT_ATTR_COLD
+    std::vector<trace_frame> resolve_trace_prefix(const raw_trace_type&, std::size_t) {
+        return {};
+    }
+
+    #elif defined(LIBASSERT_STACKTRACE_BACKEND_STDLIB)
+
+    LIBASSERT_ATTR_COLD
+    std::vector<trace_frame> resolve_trace_prefix(const raw_trace_type& trace, std::size_t count) {
+        // entries are symbolized as they're inspected
+        phase_timer timer(failure_phase::symbolization);
+        std::vector<trace_frame> frames;
+        count = std::min(count, static_cast<std::size_t>(trace.size()));
+        frames.reserve(count);
+        for(std::size_t i = 0; i < count; i++) {
+            const auto& entry = trace[i];
+            const auto line = entry.source_line();
+            frames.push_back({
+                reinterpret_cast<std::uintptr_t>(entry.native_handle()), // NOLINT(*-reinterpret-cast)
+                line == 0 ? std::nullopt : std::optional<std::uint32_t>(static_cast<std::uint32_t>(line)),
+                entry.source_file(),
+                entry.description()
+            });
+        }
+        return frames;
+    }
+
+    LIBASSERT_ATTR_COLD
+    std::vector<trace_frame> trace_frames(const stacktrace_type& trace) {
+        return resolve_trace_prefix(trace, trace.size());
+    }
+
+    #else
+
+    LIBASSERT_ATTR_COLD
+    std::vector<trace_frame> trace_frames(const stacktrace_type& trace) {
+        std::vector<trace_frame> frames;
+        frames.reserve(trace.frames.size());
+        for(const auto& frame : trace.frames) {
+            frames.push_back({
+                static_cast<std::uintptr_t>(frame.raw_address),
+                frame.line.has_value() ? std::optional<std::uint32_t>(frame.line.value()) : std::nullopt,
+                frame.filename,
+                frame.symbol
+            });
+        }
+        return frames;
+    }
+
+    LIBASSERT_ATTR_COLD
+    std::vector<trace_frame> resolve_trace_prefix(const raw_trace_type& trace, std::size_t count) {
+        count = std::min(count, trace.frames.size());
+        phase_timer timer(failure_phase::symbolization);
+        return trace_frames(cpptrace::raw_trace{{trace.frames.begin(), trace.frames.begin() + count}}.resolve());
+    }
+
+    #endif
+}
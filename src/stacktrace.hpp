@@ -0,0 +1,62 @@
+#ifndef STACKTRACE_HPP
+#define STACKTRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <libassert/assert.hpp>
+
+#if !defined(LIBASSERT_STACKTRACE_BACKEND_NONE) && !defined(LIBASSERT_STACKTRACE_BACKEND_STDLIB)
+ #if defined(__has_include) && __has_include(<cpptrace/basic.hpp>)
+  #include <cpptrace/basic.hpp>
+  #include <cpptrace/exceptions.hpp>
+ #else
+  #include <cpptrace/cpptrace.hpp>
+ #endif
+#endif
+
+// Everything that depends on the stack trace backend, trace printing only sees trace_frames
+
+namespace libassert::detail {
+    struct trace_frame {
+        std::uintptr_t address;
+        std::optional<std::uint32_t> line;
+        std::string filename;
+        std::string symbol;
+
+        bool operator==(const trace_frame& other) const {
+            return address == other.address
+                && line == other.line
+                && filename == other.filename
+                && symbol == other.symbol;
+        }
+        bool operator!=(const trace_frame& other) const {
+            return !(*this == other);
+        }
+    };
+
+    // errors from within the library carry a trace when the backend can provide one
+    #if defined(LIBASSERT_STACKTRACE_BACKEND_NONE) || defined(LIBASSERT_STACKTRACE_BACKEND_STDLIB)
+    using runtime_error = std::runtime_error;
+    #else
+    using runtime_error = cpptrace::runtime_error;
+    #endif
+
+    LIBASSERT_ATTR_COLD
+    std::vector<trace_frame> trace_frames(const stacktrace_type& trace);
+
+    // resolves at most the first count frames of the trace
+    LIBASSERT_ATTR_COLD
+    std::vector<trace_frame> resolve_trace_prefix(const raw_trace_type& trace, std::size_t count);
+
+    // the file and line of the first frame outside of libassert, or "<unknown>", for failures reported from inside the
+    // library without a source_location, see assert.cpp
+    LIBASSERT_ATTR_COLD
+    source_location location_from_trace(const raw_trace_type& trace);
+}
+
+#endif
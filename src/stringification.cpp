@@ -1,4 +1,5 @@
 #include <bitset>
+#include <cmath>
 #include <iomanip>
 #include <limits>
 #include <mutex>
@@ -248,7 +249,8 @@ namespace libassert::detail {
             oss<<std::setprecision(std::numeric_limits<T>::max_digits10)<<value;
             std::string s = std::move(oss).str();
             // std::showpoint adds a bunch of unecessary digits, so manually doing it correctly here
-            if(s.find('.') == std::string::npos) {
+            // hex floats always have an exponent, 0x1p+0.0 wouldn't be a literal, and neither would inf.0 or nan.0
+            if(format != literal_format::float_hex && std::isfinite(value) && s.find('.') == std::string::npos) {
                 s += ".0";
             }
             return s;
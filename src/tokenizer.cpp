@@ -1,10 +1,11 @@
 #include "tokenizer.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cctype>
+#include <cstddef>
 #include <optional>
 #include <string_view>
-#include <unordered_set>
 #include <variant>
 #include <vector>
 
@@ -66,89 +67,26 @@ namespace libassert::detail {
 
     // key#nt:keyword
     // [...temp0.querySelectorAll("span.keyword, span.literal")].map(node => `"${node.innerHTML.replace(`<span class="shy"></span>`, "")}",`).join("\n")
-    std::unordered_set<std::string_view> keywords {
-        "alignas",
-        "constinit",
-        // "false",
-        "public",
-        // "true",
-        "alignof",
-        "const_cast",
-        "float",
-        "register",
-        "try",
-        "asm",
-        "continue",
-        "for",
-        "reinterpret_cast",
-        "typedef",
-        "auto",
-        "co_await",
-        "friend",
-        "requires",
-        "typeid",
-        "bool",
-        "co_return",
-        "goto",
-        "return",
-        "typename",
-        "break",
-        "co_yield",
-        "if",
-        "short",
-        "union",
-        "case",
-        "decltype",
-        "inline",
-        "signed",
-        "unsigned",
-        "catch",
-        "default",
-        "int",
-        "sizeof",
-        "using",
-        "char",
-        "delete",
-        "long",
-        "static",
-        "virtual",
-        "char8_t",
-        "do",
-        "mutable",
-        "static_assert",
-        "void",
-        "char16_t",
-        "double",
-        "namespace",
-        "static_cast",
-        "volatile",
-        "char32_t",
-        "dynamic_cast",
-        "new",
-        "struct",
-        "wchar_t",
-        "class",
-        "else",
-        "noexcept",
-        "switch",
-        "while",
-        "concept",
-        "enum",
-        // "nullptr",
-        "template",
-        "const",
-        "explicit",
-        "operator",
-        "this",
-        "consteval",
-        "export",
-        "private",
-        "thread_local",
-        "constexpr",
-        "extern",
-        "protected",
-        "throw"
-    };
+    // sorted so keywords can be looked up with a binary search, an unordered_set would need a dynamic initializer
+    // false, true, and nullptr are excluded
+    constexpr std::array keywords = to_array<std::string_view>({
+        "alignas", "alignof", "asm", "auto", "bool", "break", "case", "catch", "char", "char16_t", "char32_t",
+        "char8_t", "class", "co_await", "co_return", "co_yield", "concept", "const", "const_cast", "consteval",
+        "constexpr", "constinit", "continue", "decltype", "default", "delete", "do", "double", "dynamic_cast", "else",
+        "enum", "explicit", "export", "extern", "float", "for", "friend", "goto", "if", "inline", "int", "long",
+        "mutable", "namespace", "new", "noexcept", "operator", "private", "protected", "public", "register",
+        "reinterpret_cast", "requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast",
+        "struct", "switch", "template", "this", "thread_local", "throw", "try", "typedef", "typeid", "typename",
+        "union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while"
+    });
+    static_assert([] {
+        for(std::size_t i = 1; i < keywords.size(); i++) {
+            if(!(keywords[i - 1] < keywords[i])) {
+                return false;
+            }
+        }
+        return true;
+    } ());
 
     class tokenizer {
         std::string_view source;
@@ -255,8 +193,9 @@ namespace libassert::detail {
                     TRY(read_identifier_or_keyword());
                     auto end = pos();
                     std::string_view contents = std::string_view(source.data() + begin, end - begin);
+                    const bool is_keyword = std::binary_search(keywords.begin(), keywords.end(), contents);
                     tokens.push_back({
-                        keywords.find(contents) == keywords.end() ? token_e::identifier : token_e::keyword,
+                        is_keyword ? token_e::keyword : token_e::identifier,
                         contents
                     });
                 } else {
@@ -9,15 +9,9 @@
 
 #include <libassert/assert.hpp>
 
-#if defined(__has_include) && __has_include(<cpptrace/basic.hpp>)
- #include <cpptrace/basic.hpp>
- #include <cpptrace/exceptions.hpp>
-#else
- #include <cpptrace/cpptrace.hpp>
-#endif
-
 #include "utils.hpp"
 #include "microfmt.hpp"
+#include "stacktrace.hpp"
 
 #include <libassert/assert.hpp>
 
@@ -70,7 +64,7 @@ namespace libassert::detail {
                 );
             }
             out_message += microfmt::format("    {}({});\n", name, expression);
-            throw cpptrace::runtime_error(std::move(out_message));
+            throw runtime_error(std::move(out_message));
         }
     }
 
@@ -88,7 +82,7 @@ namespace libassert::detail {
             message
         );
         out_message += "    LIBASSERT_PRIMITIVE_PANIC(...);\n";
-        throw cpptrace::runtime_error(std::move(out_message));
+        throw runtime_error(std::move(out_message));
     }
 
     /*
@@ -85,6 +85,15 @@ namespace libassert::detail {
      * Other
      */
 
+    using failure_handler_type = void (*)(const assertion_info&);
+
+    // for handlers the library installs and removes itself, see assert.cpp
+    LIBASSERT_ATTR_COLD
+    failure_handler_type exchange_failure_handler(failure_handler_type handler);
+    // sets the handler only if the current one is still expected, returns whether it did
+    LIBASSERT_ATTR_COLD
+    bool replace_failure_handler(failure_handler_type expected, failure_handler_type desired);
+
     // Container utility
     template<typename N> class needle {
         // TODO: Re-evaluate
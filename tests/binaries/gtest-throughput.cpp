@@ -0,0 +1,44 @@
+// Compares the cost of passing checks between libassert's gtest wrappers and gtest's own macros
+// Build in release mode for meaningful numbers
+
+#include <libassert/assert-gtest.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+constexpr std::size_t n_checks = 10'000'000;
+
+const std::vector<int>& data() {
+    static std::vector<int> values = [] {
+        std::vector<int> v(1024);
+        std::iota(v.begin(), v.end(), 0);
+        return v;
+    }();
+    return values;
+}
+
+template<typename F>
+void measure(const char* name, F check) {
+    const auto& values = data();
+    auto start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < n_checks; i++) {
+        check(values[i % values.size()]);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::printf("%-12s %8.3f ns/check\n", name, ns / n_checks);
+}
+
+TEST(Throughput, PassingChecks) {
+    measure("EXPECT_EQ", [] (int x) { EXPECT_EQ(x, x + 0); });
+    measure("EXPECT_LT", [] (int x) { EXPECT_LT(x, 1024); });
+    measure("EXPECT_TRUE", [] (int x) { EXPECT_TRUE(x >= 0); });
+    measure("ASSERT_EQ", [] (int x) { ASSERT_EQ(x, x + 0); });
+    measure("EXPECT ==", [] (int x) { EXPECT(x == x + 0); });
+    measure("EXPECT <", [] (int x) { EXPECT(x < 1024); });
+    measure("EXPECT bool", [] (int x) { EXPECT(x >= 0); });
+    measure("ASSERT ==", [] (int x) { ASSERT(x == x + 0); });
+}
@@ -0,0 +1,166 @@
+# Checks the passing path of the assertion forms in corpus.cpp against raw conditions. Usage:
+#   audit.py <objdump> <corpus object> <NDEBUG corpus object>
+# The passing path of a function is taken to be its instructions up to the first ret, the failure path is expected to
+# be out of line either in a .cold part or after the ret. For every lib_<name> function compared to ref_<name>:
+#  - the passing path may not contain more calls or conditional branches
+#  - the passing path may not store more to the stack
+#  - the passing path may not save more callee-saved registers, unless the raw condition itself makes calls (the
+#    failure path needs the operands after them)
+#  - the failure path has to be out of line
+# Under NDEBUG the failure paths of DEBUG_ASSERT*, ASSUME*, and their value variants have to be removed entirely.
+# x86-64 AT&T syntax only.
+
+import re
+import subprocess
+import sys
+
+function_re = re.compile(r"^[0-9a-f]+ <([^>]+)>:$")
+instruction_re = re.compile(r"^\s*([0-9a-f]+):\s+(.*)$")
+
+class Instruction:
+    def __init__(self, address, mnemonic, operands, relocated):
+        self.address = address
+        self.mnemonic = mnemonic
+        self.operands = operands
+        self.relocated = relocated
+
+    def __str__(self):
+        return "{:x}: {} {}".format(self.address, self.mnemonic, self.operands)
+
+def disassemble(objdump, path):
+    output = subprocess.run(
+        [objdump, "-d", "-r", "-w", "--no-show-raw-insn", path],
+        check=True,
+        capture_output=True,
+        text=True
+    ).stdout
+    functions = {}
+    current = None
+    for line in output.splitlines():
+        m = function_re.match(line)
+        if m:
+            current = functions.setdefault(m.group(1), [])
+            continue
+        m = instruction_re.match(line)
+        if m and current is not None:
+            address = int(m.group(1), 16)
+            text, _, relocation = m.group(2).partition("\t")
+            parts = text.split(None, 1)
+            mnemonic = parts[0] if parts else ""
+            # prefixes
+            if mnemonic in ("rep", "repz", "bnd", "notrack", "data16", "cs") and len(parts) > 1:
+                parts = parts[1].split(None, 1)
+                mnemonic = parts[0]
+            operands = parts[1] if len(parts) > 1 else ""
+            current.append(Instruction(address, mnemonic, operands, "R_" in relocation))
+    return functions
+
+def is_conditional_branch(ins):
+    return ins.mnemonic.startswith("j") and not ins.mnemonic.startswith("jmp")
+
+def is_call(ins):
+    return ins.mnemonic.startswith("call")
+
+def is_stack_store(ins):
+    if ins.mnemonic.startswith(("push", "lea", "cmp", "test")) or is_call(ins):
+        return False
+    destination = ins.operands.rsplit(",", 1)[-1]
+    return "(%rsp" in destination or "(%rbp" in destination
+
+class PassingPath:
+    def __init__(self, instructions):
+        self.instructions = []
+        end = None
+        for ins in instructions:
+            if ins.mnemonic in ("endbr64", "endbr32") or ins.mnemonic.startswith("nop"):
+                continue
+            self.instructions.append(ins)
+            if ins.mnemonic.startswith("ret") or (ins.mnemonic.startswith("jmp") and ins.relocated):
+                end = ins.address
+                break
+        self.end = end
+        self.calls = sum(1 for ins in self.instructions if is_call(ins) or (ins.mnemonic.startswith("jmp") and ins.relocated))
+        self.branches = sum(1 for ins in self.instructions if is_conditional_branch(ins))
+        self.stack_stores = sum(1 for ins in self.instructions if is_stack_store(ins))
+        self.saved_registers = sum(1 for ins in self.instructions if ins.mnemonic.startswith("push"))
+        # branches to a .cold part or past the end of the passing path
+        self.exits = sum(
+            1 for ins in self.instructions
+                if is_conditional_branch(ins) and (ins.relocated or self.branch_target(ins) > (end or 0))
+        )
+
+    @staticmethod
+    def branch_target(ins):
+        try:
+            return int(ins.operands.split()[0], 16)
+        except (ValueError, IndexError):
+            return 0
+
+    def dump(self):
+        return "\n".join("        " + str(ins) for ins in self.instructions)
+
+def audit(functions, ndebug):
+    failures = []
+    checked = 0
+    for name in sorted(functions):
+        if not name.startswith("lib_") or name.endswith(".cold"):
+            continue
+        case = name[len("lib_"):]
+        ref_name = "ref_" + case
+        if ref_name not in functions:
+            failures.append("{}: no {} to compare to".format(name, ref_name))
+            continue
+        checked += 1
+        lib = PassingPath(functions[name])
+        ref = PassingPath(functions[ref_name])
+        problems = []
+        if lib.end is None:
+            problems.append("no ret found")
+        if lib.calls > ref.calls:
+            problems.append("{} calls, raw condition has {}".format(lib.calls, ref.calls))
+        if lib.branches > ref.branches:
+            problems.append("{} conditional branches, raw condition has {}".format(lib.branches, ref.branches))
+        if lib.stack_stores > ref.stack_stores:
+            problems.append("{} stack stores, raw condition has {}".format(lib.stack_stores, ref.stack_stores))
+        if lib.saved_registers > ref.saved_registers and ref.calls == 0:
+            problems.append(
+                "{} saved registers, raw condition has {}".format(lib.saved_registers, ref.saved_registers)
+            )
+        removed = ndebug and case.startswith(("debug_assert", "assume"))
+        if removed:
+            remaining_calls = sum(1 for ins in functions[name] if is_call(ins)) - ref.calls
+            if lib.exits != 0 or name + ".cold" in functions or remaining_calls > 0:
+                problems.append("failure path isn't removed under NDEBUG")
+        elif lib.exits == 0:
+            problems.append("failure path isn't out of line")
+        if problems:
+            failures.append(
+                "{}{}: {}\n    passing path:\n{}\n    raw condition:\n{}".format(
+                    name,
+                    " (NDEBUG)" if ndebug else "",
+                    ", ".join(problems),
+                    lib.dump(),
+                    ref.dump()
+                )
+            )
+    return checked, failures
+
+def main():
+    if len(sys.argv) != 4:
+        print("Usage: audit.py <objdump> <corpus object> <NDEBUG corpus object>")
+        sys.exit(1)
+    objdump = sys.argv[1]
+    all_failures = []
+    for path, ndebug in ((sys.argv[2], False), (sys.argv[3], True)):
+        checked, failures = audit(disassemble(objdump, path), ndebug)
+        if checked == 0:
+            all_failures.append("{}: no lib_ functions found".format(path))
+        print("{}{}: {} assertion forms checked, {} failed".format(
+            path, " (NDEBUG)" if ndebug else "", checked, len(failures)
+        ))
+        all_failures += failures
+    for failure in all_failures:
+        print(failure)
+    sys.exit(1 if all_failures else 0)
+
+main()
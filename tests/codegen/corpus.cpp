@@ -0,0 +1,93 @@
+// Assertion forms inspected by audit.py. Every lib_<name> function has a ref_<name> counterpart doing the same check
+// with a raw if, the passing path of the lib_ function may not be more expensive than the ref_ function's.
+// Compiled at -O2 once as is and once with NDEBUG.
+
+#include <cstddef>
+#include <string_view>
+
+#include <libassert/assert.hpp>
+#include <libassert/checked-span.hpp>
+
+#define CODEGEN_EXPORT extern "C" LIBASSERT_ATTR_NOINLINE
+
+[[gnu::cold]] void codegen_fail();
+
+#define REF_CHECK(expr) \
+    do { \
+        if(!(expr)) { \
+            codegen_fail(); \
+        } \
+    } while(false)
+
+// ASSERT
+
+CODEGEN_EXPORT void ref_assert_int(int a, int b) { REF_CHECK(a < b); }
+CODEGEN_EXPORT void lib_assert_int(int a, int b) { ASSERT(a < b); }
+
+CODEGEN_EXPORT void ref_assert_bool(bool x) { REF_CHECK(x); }
+CODEGEN_EXPORT void lib_assert_bool(bool x) { ASSERT(x); }
+
+CODEGEN_EXPORT void ref_assert_pointer(const int* p) { REF_CHECK(p != nullptr); }
+CODEGEN_EXPORT void lib_assert_pointer(const int* p) { ASSERT(p != nullptr); }
+
+CODEGEN_EXPORT void ref_assert_message(int a, int b) { REF_CHECK(a == b); }
+CODEGEN_EXPORT void lib_assert_message(int a, int b) { ASSERT(a == b, "a and b should match"); }
+
+CODEGEN_EXPORT void ref_assert_extra_diagnostics(int a, int b, int c) { REF_CHECK(a != b); (void)c; }
+CODEGEN_EXPORT void lib_assert_extra_diagnostics(int a, int b, int c) { ASSERT(a != b, "message", c); }
+
+CODEGEN_EXPORT void ref_assert_string_view(std::string_view a, std::string_view b) { REF_CHECK(a == b); }
+CODEGEN_EXPORT void lib_assert_string_view(std::string_view a, std::string_view b) { ASSERT(a == b); }
+
+CODEGEN_EXPORT void ref_assert_unsigned(std::size_t i, std::size_t n) { REF_CHECK(i < n); }
+CODEGEN_EXPORT void lib_assert_unsigned(std::size_t i, std::size_t n) { ASSERT(i < n); }
+
+// DEBUG_ASSERT and ASSUME
+
+CODEGEN_EXPORT void ref_debug_assert_int(int a, int b) { REF_CHECK(a <= b); }
+CODEGEN_EXPORT void lib_debug_assert_int(int a, int b) { DEBUG_ASSERT(a <= b); }
+
+CODEGEN_EXPORT void ref_assume_int(int a, int b) { REF_CHECK(a > b); }
+CODEGEN_EXPORT void lib_assume_int(int a, int b) { ASSUME(a > b); }
+
+// value variants
+
+CODEGEN_EXPORT int ref_assert_val_int(int a, int b) { REF_CHECK(a < b); return a; }
+CODEGEN_EXPORT int lib_assert_val_int(int a, int b) { return ASSERT_VAL(a < b); }
+
+CODEGEN_EXPORT const int* ref_assert_val_pointer(const int* p) { REF_CHECK(p); return p; }
+CODEGEN_EXPORT const int* lib_assert_val_pointer(const int* p) { return ASSERT_VAL(p); }
+
+CODEGEN_EXPORT int ref_debug_assert_val_int(int a, int b) { REF_CHECK(a < b); return a; }
+CODEGEN_EXPORT int lib_debug_assert_val_int(int a, int b) { return DEBUG_ASSERT_VAL(a < b); }
+
+CODEGEN_EXPORT const int* ref_debug_assert_val_pointer(const int* p) { REF_CHECK(p); return p; }
+CODEGEN_EXPORT const int* lib_debug_assert_val_pointer(const int* p) { return DEBUG_ASSERT_VAL(p); }
+
+CODEGEN_EXPORT int ref_assume_val_int(int a, int b) { REF_CHECK(a < b); return a; }
+CODEGEN_EXPORT int lib_assume_val_int(int a, int b) { return ASSUME_VAL(a < b); }
+
+// libassert::checked_span
+
+CODEGEN_EXPORT int ref_checked_span_index(const int* p, std::size_t n, std::size_t i) { REF_CHECK(i < n); return p[i]; }
+CODEGEN_EXPORT int lib_checked_span_index(const int* p, std::size_t n, std::size_t i) {
+    return libassert::checked_span<const int>(p, n)[i];
+}
+
+CODEGEN_EXPORT int ref_checked_span_front(const int* p, std::size_t n) { REF_CHECK(n != 0); return p[0]; }
+CODEGEN_EXPORT int lib_checked_span_front(const int* p, std::size_t n) {
+    return libassert::checked_span<const int>(p, n).front();
+}
+
+CODEGEN_EXPORT int ref_checked_span_back(const int* p, std::size_t n) { REF_CHECK(n != 0); return p[n - 1]; }
+CODEGEN_EXPORT int lib_checked_span_back(const int* p, std::size_t n) {
+    return libassert::checked_span<const int>(p, n).back();
+}
+
+CODEGEN_EXPORT int ref_checked_span_iterator(const int* p, std::size_t n, std::size_t i) {
+    REF_CHECK(i < n);
+    return p[i];
+}
+CODEGEN_EXPORT int lib_checked_span_iterator(const int* p, std::size_t n, std::size_t i) {
+    return *(libassert::checked_span<const int>(p, n).begin() + static_cast<std::ptrdiff_t>(i));
+}
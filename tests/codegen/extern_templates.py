@@ -0,0 +1,38 @@
+# Checks that an object whose assertions only have prebuilt operand types doesn't contain its own instantiations of the
+# failure path templates. Usage:
+#   extern_templates.py <nm> <object>
+# The only definitions allowed are the process_arg overloads for string literals which forward to const char*.
+
+import re
+import subprocess
+import sys
+
+template_re = re.compile(
+    r"libassert::detail::(generate_stringification|do_stringify|process_arg|generate_binary_diagnostic)<"
+)
+allowed_re = re.compile(r"libassert::detail::process_arg<\d+[uUlL]*>")
+symbol_re = re.compile(r"^\s*(?:[0-9a-fA-F]+\s+)?([A-Za-z])\s+(.*)$")
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: extern_templates.py <nm> <object>")
+        sys.exit(1)
+    nm, path = sys.argv[1:]
+    output = subprocess.run([nm, "-C", path], check=True, capture_output=True, text=True).stdout
+    defined = []
+    referenced = 0
+    for line in output.splitlines():
+        m = symbol_re.match(line)
+        if not m or not template_re.search(m.group(2)):
+            continue
+        symbol_type, name = m.groups()
+        if symbol_type == "U":
+            referenced += 1
+        elif not allowed_re.search(name):
+            defined.append(name)
+    print("{} prebuilt instantiations referenced, {} instantiated in the object".format(referenced, len(defined)))
+    for name in defined:
+        print(name)
+    sys.exit(1 if defined or referenced == 0 else 0)
+
+main()
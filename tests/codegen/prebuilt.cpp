@@ -0,0 +1,20 @@
+// Assertions whose operands all have prebuilt failure path instantiations, checked by extern_templates.py. Compiled
+// with LIBASSERT_PREBUILT_STRINGIFICATION at -O0 so that nothing is inlined into the object instead of being
+// instantiated.
+
+#include <cstddef>
+#include <string_view>
+#include <string>
+#include <vector>
+
+#include <libassert/assert.hpp>
+
+void prebuilt_int(int a, int b) { ASSERT(a < b, "message", a + b); }
+void prebuilt_size(const std::vector<int>& v) { ASSERT(v.size() == 3, v); }
+void prebuilt_unary(long n, unsigned long long m) { ASSERT(n); DEBUG_ASSERT(m, "unary"); }
+void prebuilt_double(double x, double y) { ASSERT(x == y, x - y); }
+void prebuilt_strings(const std::string& a, const std::string& b) { ASSERT(a != b, std::string_view(a)); }
+void prebuilt_c_string(const char* s, const char* t) { ASSERT(s == t, s); }
+void prebuilt_char(char c, char d) { ASSERT(c == d); }
+void prebuilt_bool(bool a, bool b) { ASSERT(a == b); }
+void prebuilt_string_vector(const std::vector<std::string>& v, const std::vector<std::string>& w) { ASSERT(v == w); }
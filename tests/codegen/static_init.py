@@ -0,0 +1,45 @@
+# Checks that none of libassert's objects have a static initializer. Usage:
+#   static_init.py <readelf> <object>...
+# An object with a dynamically initialized global, or one that registers a destructor at startup, contributes to
+# .init_array (or .ctors with old toolchains). Every libassert global has to be constant initialized or initialized
+# lazily on first use instead. ELF only.
+
+import re
+import subprocess
+import sys
+
+section_re = re.compile(r"^\s*\[\s*\d+\]\s+(\S+)\s")
+
+def initializer_sections(readelf, path):
+    output = subprocess.run([readelf, "-SW", path], check=True, capture_output=True, text=True).stdout
+    sections = []
+    for line in output.splitlines():
+        m = section_re.match(line)
+        if m and m.group(1).startswith((".init_array", ".ctors", ".rela.init_array", ".rela.ctors")):
+            sections.append(m.group(1))
+    return sections
+
+def initializer_functions(readelf, path):
+    output = subprocess.run([readelf, "-sW", path], check=True, capture_output=True, text=True).stdout
+    return sorted({line.split()[-1] for line in output.splitlines() if "_GLOBAL__sub_I" in line})
+
+def main():
+    if len(sys.argv) < 3:
+        print("Usage: static_init.py <readelf> <object>...")
+        sys.exit(1)
+    readelf = sys.argv[1]
+    failures = []
+    for path in sys.argv[2:]:
+        sections = initializer_sections(readelf, path)
+        if sections:
+            failures.append("{}: {} ({})".format(
+                path,
+                ", ".join(sections),
+                ", ".join(initializer_functions(readelf, path)) or "no named initializer"
+            ))
+    print("{} objects checked, {} with static initializers".format(len(sys.argv) - 2, len(failures)))
+    for failure in failures:
+        print(failure)
+    sys.exit(1 if failures else 0)
+
+main()
@@ -0,0 +1,128 @@
+// The functions under test only see <libassert/assert-fwd.hpp>, the rest of the file includes <libassert/assert.hpp>
+#include <libassert/assert-fwd.hpp>
+
+#ifdef LIBASSERT_STRINGIFICATION_HPP
+ #error "<libassert/assert-fwd.hpp> shouldn't include the stringification templates"
+#endif
+#if defined(_GLIBCXX_SSTREAM) || defined(_GLIBCXX_VECTOR) || defined(_GLIBCXX_VARIANT) || defined(_GLIBCXX_MEMORY)
+ #error "<libassert/assert-fwd.hpp> shouldn't include heavy standard library headers"
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <string_view>
+
+enum class color : std::int16_t { red = -1, green = 2 };
+
+struct opaque {
+    int x;
+};
+
+bool operator==(opaque, opaque) {
+    return false;
+}
+
+void fwd_compare(int x, int y) {
+    ASSERT(x == y, "values differ", x + y);
+}
+
+void fwd_values(const char* c_string, std::string_view string, color c, const int* pointer) {
+    opaque a{1};
+    opaque b{2};
+    ASSERT(a == b, string, c_string, c, pointer, 2.5f, 'a', static_cast<std::uint8_t>(7));
+}
+
+void fwd_unary(long value) {
+    DEBUG_ASSERT(value);
+    ASSUME(value >= 0);
+    ASSERT(value, "nonzero");
+}
+
+void fwd_errno() {
+    errno = EINVAL;
+    ASSERT(false, errno);
+}
+
+void fwd_panic(int code) {
+    PANIC("gave up", code);
+}
+
+constexpr int fwd_half(int x) {
+    ASSERT(x % 2 == 0);
+    return x / 2;
+}
+
+#include <gtest/gtest.h>
+#include <libassert/assert.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+std::string last_report;
+
+void capturing_handler(const libassert::assertion_info& info) {
+    last_report = info.to_string(0, libassert::color_scheme::blank);
+    if(info.type == libassert::assert_type::panic) {
+        throw std::runtime_error("panic");
+    }
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(capturing_handler);
+    return 1;
+} ();
+
+TEST(AssertFwd, Binary) {
+    fwd_compare(1, 2);
+    EXPECT_NE(last_report.find("ASSERT(x == y, ...);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("values differ"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("x => 1"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("y => 2"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("x + y => 3"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("assert_fwd.cpp:"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("fwd_compare"), std::string::npos) << last_report;
+}
+
+TEST(AssertFwd, Values) {
+    const int i = 0;
+    fwd_values("text", "message", color::red, &i);
+    EXPECT_NE(last_report.find("message"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("<instance of opaque>"), std::string::npos) << last_report;
+    // the extra diagnostics' names are padded to the same width
+    EXPECT_NE(last_report.find("=> \"text\"\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("=> enum color: -1\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("=> const int*: 0x"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("=> 2.5\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("=> 'a'\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("=> 7\n"), std::string::npos) << last_report;
+}
+
+TEST(AssertFwd, Unary) {
+    fwd_unary(0);
+    EXPECT_NE(last_report.find("ASSERT(value, ...);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("nonzero"), std::string::npos) << last_report;
+    fwd_errno();
+    EXPECT_NE(last_report.find("errno => 22"), std::string::npos) << last_report;
+}
+
+TEST(AssertFwd, Panic) {
+    EXPECT_THROW(fwd_panic(3), std::runtime_error);
+    EXPECT_NE(last_report.find("PANIC(...);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("gave up"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("code => 3"), std::string::npos) << last_report;
+}
+
+TEST(AssertFwd, ConstexprFunction) {
+    static_assert(fwd_half(4) == 2);
+    EXPECT_EQ(fwd_half(3), 1);
+    EXPECT_NE(last_report.find("ASSERT(x % 2 == 0);"), std::string::npos) << last_report;
+}
+
+TEST(AssertFwd, ReplacedByFullHeader) {
+    // assert.hpp took over the macros, so containers are stringified
+    std::vector<int> v{1, 2, 3};
+    ASSERT(v.empty(), v);
+    EXPECT_NE(last_report.find("v => std::vector<int>: [1, 2, 3]"), std::string::npos) << last_report;
+    EXPECT_EQ(ASSERT_VAL(v.size()), 3);
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <libassert/assert.hpp>
+#include <libassert/assertion-failure.hpp>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(libassert::throwing_failure_handler);
+    return 1;
+} ();
+
+void check_value(int x) {
+    ASSERT(x == 100, "x should be 100", x * 2);
+}
+
+libassert::assertion_failure catch_failure(int x) {
+    try {
+        check_value(x);
+    } catch(const libassert::assertion_failure& e) {
+        return e;
+    }
+    throw std::runtime_error("no assertion failure");
+}
+
+TEST(AssertionFailure, StructuredFields) {
+    auto e = catch_failure(5);
+    EXPECT_EQ(e.type(), libassert::assert_type::assertion);
+    EXPECT_EQ(e.macro_name(), "ASSERT");
+    EXPECT_EQ(e.expression(), "x == 100");
+    EXPECT_NE(e.file_name().find("assertion_failure.cpp"), std::string_view::npos);
+    EXPECT_EQ(e.line(), 16);
+    EXPECT_NE(e.function().find("check_value"), std::string_view::npos);
+    EXPECT_EQ(e.message(), "x should be 100");
+    ASSERT_TRUE(e.info().binary_diagnostics.has_value());
+    EXPECT_EQ(e.info().binary_diagnostics->left_stringification, "5");
+    ASSERT_EQ(e.info().extra_diagnostics.size(), 1);
+    EXPECT_EQ(e.info().extra_diagnostics[0].stringification, "10");
+}
+
+TEST(AssertionFailure, What) {
+    auto e = catch_failure(5);
+    std::string what = e.what();
+    EXPECT_NE(what.find("Assertion failed at"), std::string::npos) << what;
+    EXPECT_NE(what.find("x should be 100"), std::string::npos) << what;
+    EXPECT_NE(what.find("x => 5"), std::string::npos) << what;
+    EXPECT_EQ(what.find("Stack trace:"), std::string::npos) << what;
+    // rendered once
+    EXPECT_EQ(e.what(), e.what());
+    auto copy = e;
+    EXPECT_EQ(copy.what(), e.what());
+}
+
+TEST(AssertionFailure, ConcurrentWhat) {
+    auto e = catch_failure(7);
+    std::vector<const char*> results(8);
+    std::vector<std::thread> threads;
+    for(auto& result : results) {
+        threads.emplace_back([&e, &result] { result = e.what(); });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(auto* result : results) {
+        EXPECT_EQ(result, results[0]);
+    }
+}
+
+void forwarding_handler(const libassert::assertion_info& info) {
+    libassert::throwing_failure_handler(info);
+}
+
+TEST(AssertionFailure, CopiedFromOtherHandler) {
+    libassert::set_failure_handler(forwarding_handler);
+    auto e = catch_failure(3);
+    libassert::set_failure_handler(libassert::throwing_failure_handler);
+    EXPECT_EQ(e.expression(), "x == 100");
+    EXPECT_EQ(e.message(), "x should be 100");
+    EXPECT_EQ(e.info().binary_diagnostics->left_stringification, "3");
+    EXPECT_NE(std::string(e.what()).find("x => 3"), std::string::npos) << e.what();
+}
+
+TEST(AssertionFailure, Panic) {
+    auto panic = [] { PANIC("message"); };
+    EXPECT_THROW(panic(), libassert::assertion_failure);
+}
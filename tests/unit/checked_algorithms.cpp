@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <libassert/checked-algorithms.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <string>
+#include <vector>
+
+std::string last_report;
+int failures = 0;
+
+void capturing_handler(const libassert::assertion_info& info) {
+    last_report = info.to_string(0, libassert::color_scheme::blank);
+    failures++;
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(capturing_handler);
+    return 1;
+} ();
+
+TEST(CheckedAlgorithms, MatchStd) {
+    const int before = failures;
+    std::vector<int> v;
+    for(int i = 0; i < 1000; i++) {
+        v.push_back(i / 3);
+    }
+    for(int value = -2; value < 340; value++) {
+        EXPECT_EQ(
+            libassert::checked::lower_bound(v.begin(), v.end(), value),
+            std::lower_bound(v.begin(), v.end(), value)
+        );
+        EXPECT_EQ(
+            libassert::checked::upper_bound(v.begin(), v.end(), value),
+            std::upper_bound(v.begin(), v.end(), value)
+        );
+        EXPECT_EQ(
+            libassert::checked::equal_range(v.begin(), v.end(), value),
+            std::equal_range(v.begin(), v.end(), value)
+        );
+        EXPECT_EQ(
+            libassert::checked::binary_search(v.begin(), v.end(), value),
+            std::binary_search(v.begin(), v.end(), value)
+        );
+    }
+    std::vector<int> descending(v.rbegin(), v.rend());
+    EXPECT_EQ(
+        libassert::checked::lower_bound(descending.begin(), descending.end(), 100, std::greater<>{}),
+        std::lower_bound(descending.begin(), descending.end(), 100, std::greater<>{})
+    );
+    std::list<int> l(v.begin(), v.end());
+    EXPECT_EQ(
+        libassert::checked::upper_bound(l.begin(), l.end(), 50),
+        std::upper_bound(l.begin(), l.end(), 50)
+    );
+    std::vector<int> empty;
+    EXPECT_EQ(libassert::checked::lower_bound(empty.begin(), empty.end(), 1), empty.end());
+    EXPECT_FALSE(libassert::checked::binary_search(empty.begin(), empty.end(), 1));
+    EXPECT_EQ(failures, before);
+}
+
+TEST(CheckedAlgorithms, SearchPathViolation) {
+    // the first probe is the middle element
+    std::vector<int> v{1, 2, 3, 4, 9, 5, 6, 7, 8};
+    const int line = __LINE__ + 1;
+    libassert::checked::lower_bound(v.begin(), v.end(), 6);
+    EXPECT_NE(
+        last_report.find("libassert::checked::lower_bound(first, last, value, ...);"),
+        std::string::npos
+    ) << last_report;
+    EXPECT_NE(last_report.find("checked_algorithms.cpp:" + std::to_string(line)), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("the range isn't sorted"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("first  => [4] 9\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("second => [5] 5\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("size   => 9\n"), std::string::npos) << last_report;
+}
+
+TEST(CheckedAlgorithms, ProbesAreConsistent) {
+    // the first probe goes right past 10, the second probe at index 7 is smaller than it and both pairs probed are
+    // in order
+    std::vector<int> v{0, 1, 2, 3, 10, 11, 12, 4, 13};
+    libassert::checked::binary_search(v.begin(), v.end(), 12, std::less<int>{});
+    EXPECT_NE(last_report.find("libassert::checked::binary_search("), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("first  => [4] 10\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("second => [7] 4\n"), std::string::npos) << last_report;
+}
+
+TEST(CheckedAlgorithms, SampledViolation) {
+    // reversed: every adjacent pair is out of order, the search path starts with the middle pair
+    std::vector<int> v;
+    for(int i = 0; i < 100000; i++) {
+        v.push_back(100000 - i);
+    }
+    const int before = failures;
+    libassert::checked::upper_bound(v.begin(), v.end(), 3);
+    EXPECT_EQ(failures, before + 1);
+    EXPECT_NE(last_report.find("libassert::checked::upper_bound("), std::string::npos) << last_report;
+    // a single inversion off the search path is found by the samples sooner or later
+    std::vector<int> w(100, 0);
+    for(int i = 0; i < 100; i++) {
+        w[i] = i;
+    }
+    std::swap(w[10], w[11]);
+    for(int i = 0; i < 1000 && failures == before + 1; i++) {
+        libassert::checked::equal_range(w.begin(), w.end(), 90);
+    }
+    EXPECT_EQ(failures, before + 2);
+    EXPECT_NE(last_report.find("libassert::checked::equal_range("), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("first  => [10] 11\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("second => [11] 10\n"), std::string::npos) << last_report;
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <libassert/assertion-failure.hpp>
+#include <libassert/checked-span.hpp>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(libassert::throwing_failure_handler);
+    return 1;
+} ();
+
+// the report of the failure f throws, empty if it doesn't fail
+template<typename F>
+std::string failure_report(F&& f) {
+    try {
+        (void)f();
+    } catch(const libassert::assertion_failure& e) {
+        return e.info().to_string(0, libassert::color_scheme::blank);
+    }
+    return "";
+}
+
+int buffer[4] = {1, 2, 3, 4};
+
+constexpr int read_element_line = __LINE__ + 2;
+LIBASSERT_ATTR_NOINLINE int read_element(libassert::checked_span<const int> span, std::size_t i) {
+    return span[i];
+}
+
+TEST(CheckedSpan, Passing) {
+    std::vector<int> v{1, 2, 3};
+    libassert::checked_span span = v;
+    static_assert(std::is_same_v<decltype(span), libassert::checked_span<int>>);
+    span[1] = 5;
+    EXPECT_EQ(v[1], 5);
+    EXPECT_EQ(span.front(), 1);
+    EXPECT_EQ(span.back(), 3);
+    EXPECT_EQ(std::accumulate(span.begin(), span.end(), 0), 9);
+    std::sort(span.begin(), span.end(), std::greater<>{});
+    EXPECT_EQ(v, (std::vector<int>{5, 3, 1}));
+    const std::array<int, 2> a{4, 2};
+    libassert::checked_span<const int> const_span = a;
+    EXPECT_EQ(const_span[1], 2);
+    const_span = span;
+    EXPECT_EQ(const_span.size(), 3);
+    std::string_view sv = "abc";
+    libassert::checked_span chars = sv;
+    static_assert(std::is_same_v<decltype(chars), libassert::checked_span<const char>>);
+    EXPECT_EQ(chars.back(), 'c');
+    libassert::checked_span<int> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(CheckedSpan, Index) {
+    libassert::checked_span<int> span(buffer, 2);
+    const auto report = failure_report([&] { return span[3]; });
+    EXPECT_NE(report.find("libassert::checked_span::operator[](index);"), std::string::npos) << report;
+    EXPECT_NE(report.find("index out of bounds"), std::string::npos) << report;
+    EXPECT_NE(report.find("index        => 3\n"), std::string::npos) << report;
+    EXPECT_NE(report.find("size         => 2\n"), std::string::npos) << report;
+    EXPECT_NE(report.find("element type => int\n"), std::string::npos) << report;
+}
+
+TEST(CheckedSpan, ThrowingHandlerPreventsAccess) {
+    libassert::checked_span<int> span(buffer, 2);
+    int written = 0;
+    EXPECT_THROW(span[2] = 7, libassert::assertion_failure);
+    EXPECT_THROW(written = span[3], libassert::assertion_failure);
+    EXPECT_EQ(buffer[2], 3);
+    EXPECT_EQ(written, 0);
+}
+
+TEST(CheckedSpan, FrontAndBack) {
+    libassert::checked_span<int> span(buffer, 0);
+    auto report = failure_report([&] { return span.front(); });
+    EXPECT_NE(report.find("libassert::checked_span::front"), std::string::npos) << report;
+    EXPECT_NE(report.find("the span is empty"), std::string::npos) << report;
+    EXPECT_EQ(report.find("index"), std::string::npos) << report;
+    EXPECT_NE(report.find("size         => 0\n"), std::string::npos) << report;
+    // back on an empty span would read before the beginning
+    libassert::checked_span<int> back_span(buffer + 1, 0);
+    report = failure_report([&] { return back_span.back(); });
+    EXPECT_NE(report.find("libassert::checked_span::back"), std::string::npos) << report;
+    EXPECT_NE(report.find("the span is empty"), std::string::npos) << report;
+}
+
+TEST(CheckedSpan, IteratorDereference) {
+    std::vector<std::string> v{"a", "b"};
+    libassert::checked_span<const std::string> span = v;
+    auto it = span.begin();
+    EXPECT_EQ(it[1], "b");
+    EXPECT_EQ(it->size(), 1);
+    libassert::checked_span<int> ints(buffer + 2, 2);
+    auto report = failure_report([&] { return *ints.end(); });
+    EXPECT_NE(report.find("libassert::checked_span::iterator::operator*"), std::string::npos) << report;
+    EXPECT_NE(report.find("index        => 2\n"), std::string::npos) << report;
+    // before the beginning wraps around and fails the same compare
+    report = failure_report([&] { return *(ints.begin() - 1); });
+    EXPECT_NE(report.find("index        => 18446744073709551615\n"), std::string::npos) << report;
+}
+
+TEST(CheckedSpan, ElementType) {
+    std::vector<std::string> v{"a", "b"};
+    libassert::checked_span<const std::string> span(v.data(), 1);
+    const auto report = failure_report([&] { return span[1]; });
+    EXPECT_NE(report.find("element type => std::string\n"), std::string::npos) << report;
+}
+
+TEST(CheckedSpan, Location) {
+    #ifdef LIBASSERT_STACKTRACE_BACKEND_NONE
+    GTEST_SKIP() << "no stack trace backend";
+    #endif
+    const auto report = failure_report([] { return read_element(libassert::checked_span<const int>(buffer, 2), 3); });
+    // the failing call can be read_element's last instruction, a symbolizer that doesn't move return addresses back
+    // into the call finds no function there
+    EXPECT_TRUE(
+        report.find("read_element") != std::string::npos
+            || report.find("Assertion failed at <unknown>:0: <unknown>:") != std::string::npos
+    ) << report;
+    // the line is only known if the symbolizer can read debug info
+    EXPECT_TRUE(
+        report.find("checked_span.cpp:" + std::to_string(read_element_line)) != std::string::npos
+            || report.find("Assertion failed at <unknown>:0:") != std::string::npos
+    ) << report;
+}
+
+void returning_handler(const libassert::assertion_info&) {}
+
+TEST(CheckedSpan, ReturningHandlerAborts) {
+    EXPECT_DEATH(
+        {
+            libassert::set_failure_handler(returning_handler);
+            libassert::checked_span<int> span(buffer, 2);
+            (void)span[2];
+        },
+        "checked_span access out of bounds"
+    );
+}
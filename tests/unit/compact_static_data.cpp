@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+// compiled with LIBASSERT_COMPACT_STATIC_DATA
+#include <libassert/assert.hpp>
+#include <libassert/failure-collector.hpp>
+
+#include <string>
+
+std::string last_report;
+
+void capturing_handler(const libassert::assertion_info& info) {
+    last_report = info.to_string(0, libassert::color_scheme::blank);
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(capturing_handler);
+    return 1;
+} ();
+
+void check_twice(int x) {
+    ASSERT(x > 0, "first", x);
+    ASSERT(x > 0, "first", x);
+}
+
+constexpr int checked_half(int x) {
+    ASSERT(x % 2 == 0, "x must be even");
+    return x / 2;
+}
+
+TEST(CompactStaticData, Report) {
+    int x = 1;
+    int y = 2;
+    ASSERT(x == y, "values differ", x + y, [] { return 7; }());
+    EXPECT_NE(last_report.find("ASSERT(x == y, ...)"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("values differ"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("x + y "), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("[] { return 7; }() => 7"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("compact_static_data.cpp:"), std::string::npos) << last_report;
+}
+
+TEST(CompactStaticData, NoArgs) {
+    int x = 0;
+    (void)ASSERT_VAL(x);
+    EXPECT_NE(last_report.find("ASSERT_VAL(x)"), std::string::npos) << last_report;
+    EXPECT_EQ(last_report.find("Extra diagnostics"), std::string::npos) << last_report;
+}
+
+TEST(CompactStaticData, StringsWithEscapes) {
+    int x = 0;
+    ASSERT(x == 1, "\0 \"quoted\"", '\0');
+    EXPECT_NE(last_report.find("ASSERT(x == 1, ...)"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("'\\0'"), std::string::npos) << last_report;
+}
+
+TEST(CompactStaticData, ConstexprFunction) {
+    static_assert(checked_half(4) == 2);
+    EXPECT_EQ(checked_half(3), 1);
+    EXPECT_NE(last_report.find("x must be even"), std::string::npos) << last_report;
+}
+
+TEST(CompactStaticData, SitesAreStable) {
+    libassert::failure_collector collector(nullptr, false);
+    check_twice(0);
+    check_twice(-1);
+    // identical text on different lines is two sites, each failure of a site maps to the same site
+    ASSERT_EQ(collector.batch().sites.size(), 2);
+    EXPECT_EQ(collector.batch().sites[0].count, 2);
+    EXPECT_EQ(collector.batch().sites[1].count, 2);
+    EXPECT_NE(collector.batch().sites[0].line, collector.batch().sites[1].line);
+    EXPECT_EQ(collector.batch().sites[0].expression_string, "x > 0");
+    EXPECT_EQ(collector.batch().sites[0].n_args, 2);
+    EXPECT_EQ(collector.batch().failures[0].message, "first");
+    ASSERT_EQ(collector.batch().failures[0].extra_diagnostics.size(), 1);
+    EXPECT_EQ(collector.batch().failures[0].extra_diagnostics[0].expression, "x");
+}
+
+TEST(CompactStaticData, Decode) {
+    constexpr auto strings = libassert::detail::site_strings("a < b" "\0" "\"m\"" "\0" "c");
+    libassert::source_location location;
+    const auto* params = libassert::detail::decode_static_parameters(
+        "CHECK",
+        libassert::assert_type::assertion,
+        strings,
+        location
+    );
+    EXPECT_EQ(params->macro_name, "CHECK");
+    EXPECT_EQ(params->expr_str, "a < b");
+    EXPECT_EQ(params->location.line, location.line);
+    ASSERT_EQ(params->args_strings.size, 3);
+    EXPECT_EQ(params->args_strings.data[0], "\"m\"");
+    EXPECT_EQ(params->args_strings.data[1], "c");
+    EXPECT_EQ(params->args_strings.data[2], "");
+    EXPECT_EQ(
+        libassert::detail::decode_static_parameters("CHECK", libassert::assert_type::assertion, strings, location),
+        params
+    );
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <libassert/assert.hpp>
+#include <libassert/failure-collector.hpp>
+
+#include <string>
+#include <thread>
+
+int handler_calls = 0;
+
+void counting_handler(const libassert::assertion_info&) {
+    handler_calls++;
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(counting_handler);
+    return 1;
+} ();
+
+class FailureCollector : public testing::Test {
+protected:
+    void SetUp() override {
+        handler_calls = 0;
+    }
+};
+
+void check_value(int x) {
+    ASSERT(x == 100, "x should be 100");
+}
+
+void check_flag(bool flag) {
+    ASSERT(flag);
+}
+
+TEST_F(FailureCollector, CollectsInsteadOfHandler) {
+    std::size_t collected = 0;
+    {
+        libassert::failure_collector collector([&] (libassert::failure_batch& batch) { collected = batch.size(); });
+        for(int i = 0; i < 10; i++) {
+            check_value(i);
+        }
+        check_flag(false);
+        EXPECT_EQ(handler_calls, 0);
+        const auto& batch = collector.batch();
+        ASSERT_EQ(batch.sites.size(), 2);
+        EXPECT_EQ(batch.sites[0].count, 10);
+        EXPECT_EQ(batch.sites[1].count, 1);
+        EXPECT_EQ(batch.sites[0].left_expression, "x");
+        EXPECT_EQ(batch.sites[0].right_expression, "100");
+        EXPECT_EQ(batch.sites[1].left_expression, "");
+        EXPECT_EQ(batch.failures[3].left_stringification, "3");
+        EXPECT_EQ(batch.failures[3].message, "x should be 100");
+    }
+    EXPECT_EQ(collected, 11);
+    check_value(1);
+    EXPECT_EQ(handler_calls, 1);
+}
+
+TEST_F(FailureCollector, PassingChecksAreNotCollected) {
+    libassert::failure_collector collector([] (libassert::failure_batch&) {});
+    check_value(100);
+    check_flag(true);
+    EXPECT_TRUE(collector.batch().empty());
+}
+
+TEST_F(FailureCollector, TraceOnlyForFirstFailure) {
+    libassert::failure_collector collector([] (libassert::failure_batch&) {});
+    for(int i = 0; i < 3; i++) {
+        check_value(i);
+    }
+    #ifdef LIBASSERT_STACKTRACE_BACKEND_NONE
+    // nothing to capture without a stack trace backend
+    EXPECT_FALSE(collector.batch().sites[0].trace.has_value());
+    #else
+    EXPECT_TRUE(collector.batch().sites[0].trace.has_value());
+    #endif
+}
+
+TEST_F(FailureCollector, WithoutTraces) {
+    libassert::failure_collector collector([] (libassert::failure_batch&) {}, false);
+    check_value(1);
+    EXPECT_FALSE(collector.batch().sites[0].trace.has_value());
+    EXPECT_EQ(collector.batch().to_string(0, libassert::color_scheme::blank).find("Stack trace:"), std::string::npos);
+}
+
+TEST_F(FailureCollector, Nesting) {
+    libassert::failure_collector outer([] (libassert::failure_batch&) {});
+    check_value(1);
+    {
+        libassert::failure_collector inner([] (libassert::failure_batch& batch) {
+            EXPECT_EQ(batch.size(), 2);
+            // reported to the outer collector
+            check_flag(false);
+        });
+        check_value(2);
+        check_value(3);
+        EXPECT_EQ(outer.batch().size(), 1);
+    }
+    EXPECT_EQ(outer.batch().size(), 2);
+    EXPECT_EQ(handler_calls, 0);
+}
+
+TEST_F(FailureCollector, OtherThreadsUnaffected) {
+    libassert::failure_collector collector([] (libassert::failure_batch&) {});
+    std::thread thread([] { check_value(1); });
+    thread.join();
+    EXPECT_EQ(handler_calls, 1);
+    EXPECT_TRUE(collector.batch().empty());
+}
+
+TEST_F(FailureCollector, ToString) {
+    libassert::failure_collector collector([] (libassert::failure_batch&) {}, false);
+    for(int i = 0; i < 15; i++) {
+        check_value(i);
+    }
+    check_flag(false);
+    auto report = collector.batch().to_string(0, libassert::color_scheme::blank, 5);
+    EXPECT_NE(report.find("16 failures at 2 sites collected"), std::string::npos) << report;
+    EXPECT_NE(report.find("Assertion failed at"), std::string::npos) << report;
+    EXPECT_NE(report.find("x should be 100"), std::string::npos) << report;
+    EXPECT_NE(report.find("Failed 15 times, later values:"), std::string::npos) << report;
+    EXPECT_NE(report.find("    x => 1: x should be 100\n"), std::string::npos) << report;
+    EXPECT_NE(report.find("    x => 5: x should be 100\n"), std::string::npos) << report;
+    EXPECT_EQ(report.find("    x => 6"), std::string::npos) << report;
+    EXPECT_NE(report.find("    ... 9 more\n"), std::string::npos) << report;
+    EXPECT_NE(report.find("ASSERT(flag);"), std::string::npos) << report;
+}
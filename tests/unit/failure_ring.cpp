@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <libassert/assert.hpp>
+#include <libassert/failure-ring.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// keep in sync with src/failure_ring.cpp
+constexpr std::size_t ring_header_size = 64;
+constexpr std::size_t slot_header_size = 32;
+
+std::string ring_path(const std::string& name) {
+    std::string path = testing::TempDir() + "libassert-failure-ring-" + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+void overwrite(const std::string& path, std::size_t offset, const std::string& bytes) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+TEST(FailureRing, AppendAndRead) {
+    auto path = ring_path("basic");
+    {
+        libassert::failure_ring ring(path, 8, 128);
+        EXPECT_EQ(ring.size(), 8);
+        EXPECT_EQ(ring.capacity(), 128 - slot_header_size);
+        ring.append("foo");
+        ring.append("bar");
+    }
+    auto records = libassert::read_failure_ring(path);
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].sequence, 1);
+    EXPECT_EQ(records[0].text, "foo");
+    EXPECT_FALSE(records[0].truncated);
+    EXPECT_EQ(records[1].sequence, 2);
+    EXPECT_EQ(records[1].text, "bar");
+}
+
+TEST(FailureRing, WrapsAround) {
+    auto path = ring_path("wrap");
+    libassert::failure_ring ring(path, 4, 64);
+    for(int i = 1; i <= 10; i++) {
+        ring.append(std::to_string(i));
+    }
+    // readable while the ring is still mapped
+    auto records = libassert::read_failure_ring(path);
+    ASSERT_EQ(records.size(), 4);
+    for(int i = 0; i < 4; i++) {
+        EXPECT_EQ(records[i].sequence, 7 + i);
+        EXPECT_EQ(records[i].text, std::to_string(7 + i));
+    }
+    auto last = libassert::read_failure_ring(path, 2);
+    ASSERT_EQ(last.size(), 2);
+    EXPECT_EQ(last[0].text, "9");
+    EXPECT_EQ(last[1].text, "10");
+}
+
+TEST(FailureRing, Truncation) {
+    auto path = ring_path("truncation");
+    libassert::failure_ring ring(path, 2, 48);
+    ring.append(std::string(100, 'x'));
+    auto records = libassert::read_failure_ring(path);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_TRUE(records[0].truncated);
+    EXPECT_EQ(records[0].text, std::string(48 - slot_header_size, 'x'));
+}
+
+TEST(FailureRing, Reopen) {
+    auto path = ring_path("reopen");
+    {
+        libassert::failure_ring ring(path, 4, 64);
+        ring.append("first");
+    }
+    {
+        // existing geometry wins over the requested one
+        libassert::failure_ring ring(path, 16, 256);
+        EXPECT_EQ(ring.size(), 4);
+        ring.append("second");
+    }
+    auto records = libassert::read_failure_ring(path);
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].text, "first");
+    EXPECT_EQ(records[1].sequence, 2);
+    EXPECT_EQ(records[1].text, "second");
+}
+
+TEST(FailureRing, TornRecordsAreSkipped) {
+    auto path = ring_path("torn");
+    {
+        libassert::failure_ring ring(path, 4, 64);
+        ring.append("intact");
+        ring.append("payload");
+        ring.append("sequence");
+    }
+    // corrupt the payload of the second slot
+    overwrite(path, ring_header_size + 64 + slot_header_size, "P");
+    // clear the end sequence of the third slot, as if the writer died mid-record
+    overwrite(path, ring_header_size + 2 * 64 + 24, std::string(8, '\0'));
+    auto records = libassert::read_failure_ring(path);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].text, "intact");
+}
+
+TEST(FailureRing, NotARing) {
+    auto path = ring_path("garbage");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << std::string(200, 'z');
+    }
+    EXPECT_THROW(static_cast<void>(libassert::read_failure_ring(path)), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(libassert::read_failure_ring(path + "-missing")), std::system_error);
+    // a ring opened over garbage reinitializes the file
+    {
+        libassert::failure_ring ring(path, 2, 64);
+        ring.append("ok");
+    }
+    auto records = libassert::read_failure_ring(path);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0].text, "ok");
+}
+
+TEST(FailureRing, ConcurrentAppends) {
+    auto path = ring_path("concurrent");
+    constexpr int threads = 4;
+    constexpr int per_thread = 100;
+    {
+        libassert::failure_ring ring(path, threads * per_thread, 64);
+        std::vector<std::thread> workers;
+        for(int t = 0; t < threads; t++) {
+            workers.emplace_back([&ring, t] {
+                for(int i = 0; i < per_thread; i++) {
+                    ring.append(std::to_string(t) + ":" + std::to_string(i));
+                }
+            });
+        }
+        for(auto& worker : workers) {
+            worker.join();
+        }
+    }
+    auto records = libassert::read_failure_ring(path);
+    ASSERT_EQ(records.size(), threads * per_thread);
+    for(std::size_t i = 0; i < records.size(); i++) {
+        EXPECT_EQ(records[i].sequence, i + 1);
+    }
+}
+
+std::unique_ptr<libassert::failure_ring> handler_ring;
+
+TEST(FailureRing, FailureHandler) {
+    auto path = ring_path("handler");
+    handler_ring = std::make_unique<libassert::failure_ring>(path, 4, 4096);
+    libassert::set_failure_handler([] (const libassert::assertion_info& info) {
+        handler_ring->append(info);
+        throw std::runtime_error("failed");
+    });
+    int a = 1;
+    int b = 2;
+    auto fail = [&] { ASSERT(a == b, "ring message"); };
+    EXPECT_THROW(fail(), std::runtime_error);
+    libassert::set_failure_handler(libassert::default_failure_handler);
+    handler_ring.reset();
+    auto records = libassert::read_failure_ring(path);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_NE(records[0].text.find("ASSERT(a == b, ...);"), std::string::npos) << records[0].text;
+    EXPECT_NE(records[0].text.find("ring message"), std::string::npos);
+    EXPECT_EQ(records[0].text.find("\033["), std::string::npos);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <libassert/assert.hpp>
+
+#include <string>
+#include <string_view>
+
+int handler_calls = 0;
+
+void counting_handler(const libassert::assertion_info&) {
+    handler_calls++;
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(counting_handler);
+    return 1;
+} ();
+
+class FailureSummary : public testing::Test {
+protected:
+    void SetUp() override {
+        handler_calls = 0;
+        libassert::enable_failure_summary(false);
+        libassert::reset_failure_summary();
+    }
+    void TearDown() override {
+        libassert::disable_failure_summary();
+        libassert::reset_failure_summary();
+    }
+};
+
+void check_value(int x) {
+    ASSERT(x == 100, "x should be 100");
+}
+
+void check_flag(bool flag) {
+    ASSERT(flag);
+}
+
+std::size_t count_occurrences(std::string_view haystack, std::string_view needle) {
+    std::size_t count = 0;
+    for(auto pos = haystack.find(needle); pos != std::string_view::npos; pos = haystack.find(needle, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+TEST_F(FailureSummary, Disabled) {
+    libassert::disable_failure_summary();
+    for(int i = 0; i < 10; i++) {
+        check_value(i);
+    }
+    EXPECT_EQ(handler_calls, 10);
+    auto summary = libassert::failure_summary();
+    EXPECT_NE(summary.find("0 failures at 0 sites"), std::string::npos) << summary;
+}
+
+TEST_F(FailureSummary, OnlyFirstFailureIsReported) {
+    for(int i = 0; i < 1000; i++) {
+        check_value(i % 5);
+    }
+    check_value(100); // passes
+    EXPECT_EQ(handler_calls, 1);
+    auto summary = libassert::failure_summary();
+    EXPECT_NE(summary.find("1000 failures at 1 sites"), std::string::npos) << summary;
+    EXPECT_NE(summary.find("x == 100"), std::string::npos) << summary;
+    // five distinct values among the sampled failures
+    EXPECT_NE(summary.find(" 5/64 "), std::string::npos) << summary;
+    // the first report is kept
+    EXPECT_NE(summary.find("x should be 100"), std::string::npos) << summary;
+    EXPECT_NE(summary.find("x => 0"), std::string::npos) << summary;
+}
+
+TEST_F(FailureSummary, SortedByCount) {
+    for(int i = 0; i < 3; i++) {
+        check_value(i);
+    }
+    for(int i = 0; i < 7; i++) {
+        check_flag(false);
+    }
+    EXPECT_EQ(handler_calls, 2);
+    auto summary = libassert::failure_summary();
+    EXPECT_NE(summary.find("10 failures at 2 sites"), std::string::npos) << summary;
+    auto flag_row = summary.find("  flag\n");
+    auto value_row = summary.find("  x == 100\n");
+    ASSERT_NE(flag_row, std::string::npos) << summary;
+    ASSERT_NE(value_row, std::string::npos) << summary;
+    EXPECT_LT(flag_row, value_row);
+    EXPECT_EQ(count_occurrences(summary, "First failure at"), 2);
+    EXPECT_NE(summary.find("    7  +"), std::string::npos) << summary;
+}
+
+TEST_F(FailureSummary, Reset) {
+    check_value(1);
+    check_value(2);
+    EXPECT_EQ(handler_calls, 1);
+    libassert::reset_failure_summary();
+    check_value(3);
+    EXPECT_EQ(handler_calls, 2);
+    auto summary = libassert::failure_summary();
+    EXPECT_NE(summary.find("1 failures at 1 sites"), std::string::npos) << summary;
+}
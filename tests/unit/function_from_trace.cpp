@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+// compiled with LIBASSERT_FUNCTION_FROM_TRACE
+#include <libassert/assert.hpp>
+#include <libassert/failure-collector.hpp>
+
+#include <string>
+
+std::string last_function;
+std::string last_report;
+
+void capturing_handler(const libassert::assertion_info& info) {
+    last_function = std::string(info.function);
+    last_report = info.to_string(0, libassert::color_scheme::blank);
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(capturing_handler);
+    return 1;
+} ();
+
+LIBASSERT_ATTR_NOINLINE void check_in_named_function(int x) {
+    ASSERT(x > 0, "x should be positive");
+}
+
+template<typename T>
+LIBASSERT_ATTR_NOINLINE T check_in_template(T x) {
+    return ASSERT_VAL(x);
+}
+
+TEST(FunctionFromTrace, FirstUserFrame) {
+    #ifdef LIBASSERT_STACKTRACE_BACKEND_NONE
+    GTEST_SKIP() << "no stack trace backend";
+    #endif
+    check_in_named_function(0);
+    EXPECT_NE(last_function.find("check_in_named_function"), std::string::npos) << last_function;
+    EXPECT_NE(last_report.find("check_in_named_function"), std::string::npos) << last_report;
+}
+
+TEST(FunctionFromTrace, ValueForms) {
+    #ifdef LIBASSERT_STACKTRACE_BACKEND_NONE
+    GTEST_SKIP() << "no stack trace backend";
+    #endif
+    (void)check_in_template(0);
+    EXPECT_NE(last_function.find("check_in_template"), std::string::npos) << last_function;
+}
+
+TEST(FunctionFromTrace, UnknownWithoutTrace) {
+    libassert::failure_collector collector(nullptr, false);
+    check_in_named_function(0);
+    ASSERT_EQ(collector.batch().sites.size(), 1);
+    EXPECT_EQ(collector.batch().sites[0].function, "<unknown>");
+}
+
+TEST(FunctionFromTrace, EmptyTrace) {
+    EXPECT_EQ(libassert::detail::function_from_trace(libassert::raw_trace_type{}), "<unknown>");
+}
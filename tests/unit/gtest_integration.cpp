@@ -0,0 +1,61 @@
+#include <libassert/assert-gtest.hpp>
+#include <gtest/gtest-spi.h>
+
+#include <stdexcept>
+
+int reached = 0;
+
+void fatal_then_continue() {
+    ASSERT(1 + 1 == 3, "fatal message");
+    reached++;
+}
+
+void nonfatal_then_continue() {
+    EXPECT(1 + 1 == 3, "nonfatal message");
+    reached++;
+}
+
+void code_under_test(int x) {
+    LIBASSERT_ASSERT(x > 0);
+    reached++;
+}
+
+TEST(GTestIntegration, FatalReturns) {
+    reached = 0;
+    EXPECT_FATAL_FAILURE(fatal_then_continue(), "fatal message");
+    EXPECT_EQ(reached, 0);
+}
+
+TEST(GTestIntegration, NonFatalContinues) {
+    reached = 0;
+    EXPECT_NONFATAL_FAILURE(nonfatal_then_continue(), "1 + 1 => 2");
+    EXPECT_EQ(reached, 1);
+}
+
+TEST(GTestIntegration, Passing) {
+    reached = 0;
+    ASSERT(1 + 1 == 2);
+    EXPECT(2 + 2 == 4);
+    reached++;
+    EXPECT_EQ(reached, 1);
+}
+
+TEST(GTestIntegration, ReportsAssertionLocation) {
+    EXPECT_NONFATAL_FAILURE(nonfatal_then_continue(), "gtest_integration.cpp:14");
+}
+
+#if GTEST_HAS_EXCEPTIONS
+TEST(GTestIntegration, FailureOutsideWrapper) {
+    reached = 0;
+    // reported as a fatal failure, then unwinds with an exception gtest recognizes as already reported
+    EXPECT_FATAL_FAILURE(
+        {
+            try {
+                code_under_test(-1);
+            } catch(const testing::AssertionException&) {}
+        },
+        "x => -1"
+    );
+    EXPECT_EQ(reached, 0);
+}
+#endif
@@ -0,0 +1,131 @@
+// GoogleTest's ASSERT_NEAR takes precedence, libassert's is used as LIBASSERT_ASSERT_NEAR
+#include <gtest/gtest.h>
+#include <libassert/near-assertions.hpp>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+std::string last_report;
+int failures = 0;
+
+void capturing_handler(const libassert::assertion_info& info) {
+    last_report = info.to_string(0, libassert::color_scheme::blank);
+    failures++;
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(capturing_handler);
+    return 1;
+} ();
+
+TEST(NearAssertions, Passing) {
+    const int before = failures;
+    const double inf = std::numeric_limits<double>::infinity();
+    LIBASSERT_ASSERT_NEAR(0.1 + 0.2, 0.3, 1e-12);
+    LIBASSERT_ASSERT_NEAR(1e9, 1e9 + 1, libassert::relative_tolerance(1e-6));
+    LIBASSERT_ASSERT_NEAR(0.1 + 0.2, 0.3, libassert::ulp_tolerance(1));
+    LIBASSERT_ASSERT_NEAR(1.0f, std::nextafter(1.0f, 2.0f), libassert::ulp_tolerance(1));
+    LIBASSERT_ASSERT_NEAR(0.0, -0.0, libassert::ulp_tolerance(0));
+    LIBASSERT_ASSERT_NEAR(inf, inf, 0.0);
+    LIBASSERT_ASSERT_NEAR(3, 3.0000001, 1e-6);
+    LIBASSERT_ASSERT_NEAR(1.0L, 1.0L + 1e-12L, libassert::absolute_tolerance(1e-9));
+    EXPECT_EQ(failures, before);
+}
+
+TEST(NearAssertions, Absolute) {
+    const double a = 1.0;
+    const double b = 1.5;
+    LIBASSERT_ASSERT_NEAR(a, b, 0.1, "too far");
+    EXPECT_NE(last_report.find("ASSERT_NEAR(a, b, 0.1, ...);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("too far"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("a => 1.0\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("b => 1.5\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("difference => 0.5\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("ulps apart => 2251799813685248\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("tolerance  => 0.10000000000000001 (absolute)\n"), std::string::npos) << last_report;
+}
+
+TEST(NearAssertions, UlpsShowHexFloats) {
+    const float a = 1.0f;
+    const float b = std::nextafter(std::nextafter(a, 2.0f), 2.0f);
+    LIBASSERT_ASSERT_NEAR(a, b, libassert::ulp_tolerance(1));
+    EXPECT_NE(last_report.find("a => 1.0 0x1p+0\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("b => 1.00000024 0x1.000004p+0\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("ulps apart => 2\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("tolerance  => 1 ULPs\n"), std::string::npos) << last_report;
+    // far apart values don't
+    LIBASSERT_ASSERT_NEAR(a, 2.0f, libassert::relative_tolerance(0.1));
+    EXPECT_EQ(last_report.find("0x1p+0"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("(relative)"), std::string::npos) << last_report;
+}
+
+TEST(NearAssertions, NaN) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const int before = failures;
+    LIBASSERT_ASSERT_NEAR(nan, nan, libassert::ulp_tolerance(100));
+    LIBASSERT_ASSERT_NEAR(nan, 1.0, 1e9);
+    EXPECT_EQ(failures, before + 2);
+    EXPECT_EQ(last_report.find("ulps apart"), std::string::npos) << last_report;
+}
+
+TEST(NearAssertions, Infinity) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const int before = failures;
+    LIBASSERT_ASSERT_NEAR(inf, 1.0, libassert::relative_tolerance(0.1));
+    LIBASSERT_ASSERT_NEAR(inf, -inf, libassert::relative_tolerance(0.1));
+    LIBASSERT_ASSERT_NEAR(inf, 1.0, std::numeric_limits<double>::max());
+    LIBASSERT_ASSERT_NEAR(inf, -inf, inf);
+    LIBASSERT_ASSERT_NEAR(-inf, 1.0f, libassert::ulp_tolerance(100));
+    LIBASSERT_ASSERT_NEAR(inf, -inf, libassert::ulp_tolerance(100));
+    EXPECT_EQ(failures, before + 6);
+    const std::array<double, 2> a{1.0, inf};
+    const std::array<double, 2> b{1.0, 2.0};
+    LIBASSERT_ASSERT_ALL_NEAR(a, b, libassert::relative_tolerance(0.5));
+    EXPECT_EQ(failures, before + 7);
+    EXPECT_NE(last_report.find("mismatches      => 1 of 2\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("worst index     => 1\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("worst values    => inf, 2.0\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("difference      => inf\n"), std::string::npos) << last_report;
+}
+
+TEST(NearAssertions, Ranges) {
+    const int before = failures;
+    std::vector<double> a(1000);
+    std::vector<double> b(1000);
+    for(std::size_t i = 0; i < a.size(); i++) {
+        a[i] = static_cast<double>(i + 1) / 7;
+        b[i] = a[i] + 1e-12;
+    }
+    ASSERT_ALL_NEAR(a, b, 1e-9);
+    ASSERT_ALL_NEAR(a, b, libassert::relative_tolerance(1e-6));
+    EXPECT_EQ(failures, before);
+    b[100] += 0.5;
+    b[700] += 2;
+    b[900] -= 1;
+    ASSERT_ALL_NEAR(a, b, 1e-9, "results differ");
+    EXPECT_EQ(failures, before + 1);
+    EXPECT_NE(last_report.find("ASSERT_ALL_NEAR(a, b, 1e-9, ...);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("results differ"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("mismatches      => 3 of 1000\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("worst index     => 700\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("tolerance       => 1.0000000000000001e-09 (absolute)\n"), std::string::npos)
+        << last_report;
+    EXPECT_NE(last_report.find("max difference  => 2.0000000000"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("mean difference => 0.00350000000"), std::string::npos) << last_report;
+    // the ranges aren't stringified
+    EXPECT_EQ(last_report.find("std::vector"), std::string::npos) << last_report;
+}
+
+TEST(NearAssertions, RangeSizes) {
+    std::array<float, 3> a{1, 2, 3};
+    std::vector<float> b{1, 2};
+    ASSERT_ALL_NEAR(a, b, libassert::ulp_tolerance(4));
+    EXPECT_NE(last_report.find("sizes => 3 and 2\n"), std::string::npos) << last_report;
+    float c[] = {1, 2, 4};
+    ASSERT_ALL_NEAR(a, c, libassert::ulp_tolerance(4));
+    EXPECT_NE(last_report.find("worst index     => 2\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("worst values    => 3.0 0x1.8p+1, 4.0 0x1p+2\n"), std::string::npos) << last_report;
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <libassert/assert.hpp>
+
+#include <array>
+#include <chrono>
+#include <string>
+
+using libassert::failure_phase;
+
+std::string last_report;
+
+void rendering_handler(const libassert::assertion_info& info) {
+    last_report = info.to_string(0, libassert::color_scheme::ansi_rgb);
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(rendering_handler);
+    return 1;
+} ();
+
+using phase_timings = std::array<libassert::phase_timing, libassert::failure_phase_count>;
+
+const libassert::phase_timing& timing(const phase_timings& timings, failure_phase phase) {
+    return timings[static_cast<std::size_t>(phase)];
+}
+
+class PhaseTiming : public testing::Test {
+protected:
+    void SetUp() override {
+        libassert::enable_phase_timing(false);
+        libassert::reset_phase_timings();
+    }
+    void TearDown() override {
+        libassert::disable_phase_timing();
+    }
+};
+
+void check_equal(int a, int b) {
+    ASSERT(a == b, "values should match", a + b);
+}
+
+TEST_F(PhaseTiming, TimesEachPhase) {
+    check_equal(1, 2);
+    auto timings = libassert::phase_timings();
+    EXPECT_EQ(timing(timings, failure_phase::trace_capture).calls, 1);
+    EXPECT_EQ(timing(timings, failure_phase::stringification).calls, 1);
+    EXPECT_GE(timing(timings, failure_phase::decomposition).calls, 1);
+    #ifndef LIBASSERT_STACKTRACE_BACKEND_NONE
+    EXPECT_GE(timing(timings, failure_phase::symbolization).calls, 1);
+    #endif
+    EXPECT_GE(timing(timings, failure_phase::type_prettification).calls, 1);
+    EXPECT_GE(timing(timings, failure_phase::highlighting).calls, 1);
+    EXPECT_EQ(timing(timings, failure_phase::layout).calls, 1);
+    // only the default handler writes
+    EXPECT_EQ(timing(timings, failure_phase::output).calls, 0);
+    #ifndef LIBASSERT_STACKTRACE_BACKEND_NONE
+    EXPECT_GT(timing(timings, failure_phase::symbolization).time.count(), 0);
+    #endif
+}
+
+TEST_F(PhaseTiming, PhasesAreExclusive) {
+    auto start = std::chrono::steady_clock::now();
+    check_equal(1, 2);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::chrono::nanoseconds total{0};
+    for(const auto& t : libassert::phase_timings()) {
+        total += t.time;
+    }
+    EXPECT_LE(total, elapsed);
+}
+
+TEST_F(PhaseTiming, Reset) {
+    check_equal(1, 2);
+    libassert::reset_phase_timings();
+    for(const auto& t : libassert::phase_timings()) {
+        EXPECT_EQ(t.calls, 0);
+        EXPECT_EQ(t.time.count(), 0);
+    }
+}
+
+TEST_F(PhaseTiming, Disabled) {
+    libassert::disable_phase_timing();
+    check_equal(1, 2);
+    EXPECT_NE(last_report.find("values should match"), std::string::npos);
+    for(const auto& t : libassert::phase_timings()) {
+        EXPECT_EQ(t.calls, 0);
+    }
+}
+
+TEST_F(PhaseTiming, Summary) {
+    check_equal(1, 2);
+    check_equal(3, 4);
+    auto summary = libassert::phase_timing_summary();
+    EXPECT_NE(summary.find("Assertion failure path timing:"), std::string::npos) << summary;
+    EXPECT_NE(summary.find("Phase"), std::string::npos) << summary;
+    for(std::size_t i = 0; i < libassert::failure_phase_count; i++) {
+        EXPECT_NE(summary.find(libassert::phase_name(static_cast<failure_phase>(i))), std::string::npos) << summary;
+    }
+    EXPECT_NE(summary.find("trace capture               2"), std::string::npos) << summary;
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <libassert/range-assertions.hpp>
+
+#include <array>
+#include <execution>
+#include <functional>
+#include <list>
+#include <string>
+#include <vector>
+
+std::string last_report;
+int failures = 0;
+
+void capturing_handler(const libassert::assertion_info& info) {
+    last_report = info.to_string(0, libassert::color_scheme::blank);
+    failures++;
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(capturing_handler);
+    return 1;
+} ();
+
+bool is_positive(int x) {
+    return x > 0;
+}
+
+bool is_negative(int x) {
+    return x < 0;
+}
+
+TEST(RangeAssertions, Passing) {
+    const int before = failures;
+    std::vector<int> v(1000, 1);
+    ASSERT_ALL(v, is_positive);
+    ASSERT_NONE(v, is_negative);
+    v[999] = -1;
+    ASSERT_ANY(v, is_negative);
+    std::vector<int> empty;
+    ASSERT_ALL(empty, is_positive);
+    ASSERT_NONE(empty, is_positive);
+    EXPECT_EQ(failures, before);
+}
+
+TEST(RangeAssertions, AllReportsFirstOffender) {
+    // the offenders are past the first vectorized block and in the same block
+    std::vector<int> v(300, 1);
+    v[130] = -5;
+    v[131] = -6;
+    v[250] = -7;
+    ASSERT_ALL(v, is_positive, "values must be positive");
+    EXPECT_NE(last_report.find("ASSERT_ALL(v, is_positive, ...);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("values must be positive"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("index => 130\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("value => -5\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("size  => 300\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, Tail) {
+    // the offender is in the elements after the last whole block
+    std::array<int, 70> a{};
+    a.fill(1);
+    a[68] = 0;
+    ASSERT_ALL(a, is_positive);
+    EXPECT_NE(last_report.find("index => 68\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("value => 0\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, NoneAndAny) {
+    const int threshold = 2;
+    std::list<int> l{1, 2, 3, 4};
+    ASSERT_NONE(l, [threshold] (int x) { return x > threshold; }, threshold);
+    EXPECT_NE(last_report.find("ASSERT_NONE("), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("threshold => 2\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("index     => 2\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("value     => 3\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("size      => 4\n"), std::string::npos) << last_report;
+    last_report.clear();
+    ASSERT_ANY(l, is_negative);
+    EXPECT_NE(last_report.find("ASSERT_ANY(l, is_negative);"), std::string::npos) << last_report;
+    EXPECT_EQ(last_report.find("index"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("size => 4\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, ElementValues) {
+    std::vector<std::string> v{"foo", "", "bar"};
+    ASSERT_ALL(v, [] (const std::string& s) { return !s.empty(); });
+    EXPECT_NE(last_report.find("value => \"\"\n"), std::string::npos) << last_report;
+    int c_array[] = {3, 2, 1, 0};
+    ASSERT_ALL(c_array, is_positive);
+    EXPECT_NE(last_report.find("index => 3\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, RangeEvaluatedOnce) {
+    int calls = 0;
+    auto make = [&calls] () {
+        calls++;
+        return std::vector<int>{1, -1};
+    };
+    ASSERT_ALL(make(), is_positive);
+    EXPECT_EQ(calls, 1);
+    EXPECT_NE(last_report.find("value => -1\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, ExecutionPolicy) {
+    const int before = failures;
+    std::vector<int> v(5000, 1);
+    ASSERT_ALL_EXEC(std::execution::seq, v, is_positive);
+    v[4000] = -2;
+    v[4500] = -3;
+    ASSERT_ANY_EXEC(std::execution::seq, v, is_negative);
+    EXPECT_EQ(failures, before);
+    ASSERT_NONE_EXEC(std::execution::seq, v, is_negative);
+    EXPECT_EQ(failures, before + 1);
+    EXPECT_NE(last_report.find("ASSERT_NONE_EXEC(v, is_negative);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("index => 4000\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("value => -2\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, ParallelExecutionPolicy) {
+    std::vector<int> v(100000, 1);
+    v[60000] = -1;
+    v[70000] = -2;
+    v[99999] = -3;
+    ASSERT_ALL_EXEC(std::execution::par, v, is_positive);
+    // still the first offender
+    EXPECT_NE(last_report.find("index => 60000\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("value => -1\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("size  => 100000\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, InvariantsPassing) {
+    const int before = failures;
+    std::vector<int> v{1, 2, 2, 3, 5, 8};
+    ASSERT_SORTED(v);
+    ASSERT_SORTED_BY(v, [] (int a, int b) { return a / 2 < b / 2; });
+    std::vector<int> u{1, 2, 3, 5, 8};
+    ASSERT_UNIQUE_SORTED(u);
+    std::vector<int> d{8, 5, 3, 2, 1};
+    ASSERT_UNIQUE_SORTED_BY(d, std::greater<>{});
+    ASSERT_PARTITIONED(v, [] (int x) { return x < 3; });
+    std::vector<int> h{9, 5, 8, 1, 2, 7};
+    ASSERT_HEAP(h);
+    ASSERT_HEAP_BY(u, std::greater<>{});
+    std::list<int> l{1, 2, 3};
+    ASSERT_SORTED(l);
+    std::vector<int> empty;
+    ASSERT_SORTED(empty);
+    ASSERT_UNIQUE_SORTED(empty);
+    ASSERT_PARTITIONED(empty, is_positive);
+    ASSERT_HEAP(empty);
+    EXPECT_EQ(failures, before);
+}
+
+TEST(RangeAssertions, Sorted) {
+    std::vector<int> v(300);
+    for(int i = 0; i < 300; i++) {
+        v[i] = i;
+    }
+    v[200] = 150;
+    ASSERT_SORTED(v, "must be sorted");
+    EXPECT_NE(last_report.find("ASSERT_SORTED(v, ...);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("must be sorted"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("first  => [199] 199\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("second => [200] 150\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("window => [196..204] 196, 197, 198, 199, 150, 201, 202, 203, 204\n"), std::string::npos)
+        << last_report;
+    EXPECT_NE(last_report.find("size   => 300\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, SortedWindowAtEdges) {
+    std::list<int> l{2, 1, 3};
+    ASSERT_SORTED(l);
+    EXPECT_NE(last_report.find("first  => [0] 2\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("window => [0..2] 2, 1, 3\n"), std::string::npos) << last_report;
+    std::vector<std::string> v{"a", "b", "d", "c"};
+    ASSERT_SORTED_BY(v, std::less<std::string>{});
+    EXPECT_NE(last_report.find("ASSERT_SORTED_BY(v, std::less<std::string>{});"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("second => [3] \"c\"\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, UniqueSorted) {
+    std::vector<int> v{1, 2, 3, 3, 4};
+    ASSERT_UNIQUE_SORTED(v);
+    EXPECT_NE(last_report.find("first  => [2] 3\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("second => [3] 3\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, Partitioned) {
+    std::vector<int> v{-3, -1, 2, -4, 5};
+    ASSERT_PARTITIONED(v, is_negative);
+    EXPECT_NE(last_report.find("ASSERT_PARTITIONED(v, is_negative);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("first  => [2] 2\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("second => [3] -4\n"), std::string::npos) << last_report;
+}
+
+TEST(RangeAssertions, Heap) {
+    std::vector<int> h{9, 5, 8, 1, 2, 7, 10};
+    ASSERT_HEAP(h);
+    EXPECT_NE(last_report.find("parent => [2] 8\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("child  => [6] 10\n"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("size   => 7\n"), std::string::npos) << last_report;
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+// compiled with LIBASSERT_SITE_COST_SAMPLING
+#include <libassert/assert.hpp>
+#include <libassert/site-counters.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+std::optional<libassert::site_counter_snapshot> find_site(
+    const std::vector<libassert::site_counter_snapshot>& sites,
+    std::string_view expression
+) {
+    for(const auto& site : sites) {
+        if(site.expression == expression) {
+            return site;
+        }
+    }
+    return std::nullopt;
+}
+
+bool validate(const std::vector<int>& values) {
+    return std::is_sorted(values.begin(), values.end());
+}
+
+void check_valid(const std::vector<int>& values) {
+    ASSERT(validate(values));
+}
+
+void check_index(int i) {
+    ASSERT(i >= 0);
+}
+
+TEST(SiteCosts, RanksByEstimatedCost) {
+    // far enough apart that a preempted sample of the cheap site doesn't change the ranking
+    std::vector<int> values(100000);
+    std::iota(values.begin(), values.end(), 0);
+    for(int i = 0; i < 1000; i++) {
+        check_valid(values);
+    }
+    for(int i = 0; i < 1000000; i++) {
+        check_index(i);
+    }
+    const auto ranking = libassert::site_cost_ranking();
+    ASSERT_FALSE(ranking.empty());
+    EXPECT_EQ(ranking.front().expression, "validate(values)");
+    auto expensive = find_site(ranking, "validate(values)");
+    auto cheap = find_site(ranking, "i >= 0");
+    ASSERT_TRUE(expensive.has_value());
+    ASSERT_TRUE(cheap.has_value());
+    EXPECT_EQ(expensive->evaluations, 1000);
+    EXPECT_EQ(cheap->evaluations, 1000000);
+    EXPECT_GT(expensive->estimated_cost, cheap->estimated_cost);
+    // expensive sites are sampled far more often than cheap ones, where reading the clock would dominate
+    EXPECT_GT(expensive->sampled_evaluations, expensive->evaluations / 2);
+    EXPECT_GT(cheap->sampled_evaluations, 0);
+    EXPECT_LT(cheap->sampled_evaluations, cheap->evaluations / 20);
+    const auto report = libassert::site_cost_report();
+    EXPECT_NE(report.find("Assertion site cost:"), std::string::npos) << report;
+    EXPECT_LT(report.find("validate(values)"), report.find("i >= 0")) << report;
+}
+
+int checked_value(int x) {
+    return ASSERT_VAL(x);
+}
+
+TEST(SiteCosts, ValueForms) {
+    int sum = 0;
+    for(int i = 1; i < 5; i++) {
+        sum += checked_value(i);
+    }
+    EXPECT_EQ(sum, 10);
+    auto site = find_site(libassert::site_counters(), "x");
+    ASSERT_TRUE(site.has_value());
+    EXPECT_EQ(site->evaluations, 4);
+    // the first evaluation of a site is always sampled
+    EXPECT_GE(site->sampled_evaluations, 1);
+}
+
+TEST(SiteCosts, Budget) {
+    EXPECT_DOUBLE_EQ(libassert::site_cost_budget(), 0.01);
+    EXPECT_THROW(libassert::set_site_cost_budget(0), std::invalid_argument);
+    EXPECT_THROW(libassert::set_site_cost_budget(2), std::invalid_argument);
+    libassert::set_site_cost_budget(0.05);
+    EXPECT_DOUBLE_EQ(libassert::site_cost_budget(), 0.05);
+    libassert::set_site_cost_budget(0.01);
+}
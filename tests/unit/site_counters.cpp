@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+// compiled with LIBASSERT_SITE_COUNTERS
+#include <libassert/assert.hpp>
+#include <libassert/site-counters.hpp>
+
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+void ignoring_handler(const libassert::assertion_info&) {}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(ignoring_handler);
+    return 1;
+} ();
+
+const int check_positive_line = __LINE__ + 2;
+void check_positive(int x) {
+    ASSERT(x > 0);
+}
+
+int checked_value(int x) {
+    return ASSERT_VAL(x);
+}
+
+std::optional<libassert::site_counter_snapshot> find_site(
+    const std::vector<libassert::site_counter_snapshot>& sites,
+    std::string_view expression
+) {
+    for(const auto& site : sites) {
+        if(site.expression == expression) {
+            return site;
+        }
+    }
+    return std::nullopt;
+}
+
+TEST(SiteCounters, CountsEvaluationsAndFailures) {
+    for(int i = -5; i < 10; i++) {
+        check_positive(i);
+    }
+    auto site = find_site(libassert::site_counters(), "x > 0");
+    ASSERT_TRUE(site.has_value());
+    EXPECT_EQ(site->evaluations, 15);
+    EXPECT_EQ(site->failures, 6);
+    EXPECT_EQ(site->macro_name, "ASSERT");
+    EXPECT_NE(site->file_name.find("site_counters.cpp"), std::string::npos);
+    EXPECT_EQ(site->line, check_positive_line);
+}
+
+TEST(SiteCounters, ValueForms) {
+    int sum = 0;
+    for(int i = 0; i < 4; i++) {
+        sum += checked_value(i);
+    }
+    EXPECT_EQ(sum, 6);
+    auto site = find_site(libassert::site_counters(), "x");
+    ASSERT_TRUE(site.has_value());
+    EXPECT_EQ(site->evaluations, 4);
+    EXPECT_EQ(site->failures, 1);
+}
+
+void count_in_threads() {
+    ASSERT(true);
+}
+
+TEST(SiteCounters, ThreadsAreSummed) {
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; i++) {
+        threads.emplace_back([] {
+            for(int j = 0; j < 1000; j++) {
+                count_in_threads();
+            }
+        });
+    }
+    // still running threads and exited threads both count
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    count_in_threads();
+    auto site = find_site(libassert::site_counters(), "true");
+    ASSERT_TRUE(site.has_value());
+    EXPECT_EQ(site->evaluations, 4001);
+}
+
+#ifdef __linux__
+TEST(SiteCounters, Publisher) {
+    check_positive(1);
+    const std::string path = "/tmp/libassert-site-counters-test.counters";
+    std::string published_path;
+    {
+        libassert::site_counter_publisher publisher(std::chrono::milliseconds(10), path);
+        published_path = publisher.path();
+        EXPECT_EQ(published_path, path);
+        auto before = libassert::read_site_counters(path);
+        check_positive(2);
+        publisher.publish_now();
+        auto after = libassert::read_site_counters(path);
+        EXPECT_GT(after.publications, before.publications);
+        auto site_before = find_site(before.sites, "x > 0");
+        auto site_after = find_site(after.sites, "x > 0");
+        ASSERT_TRUE(site_before.has_value());
+        ASSERT_TRUE(site_after.has_value());
+        EXPECT_EQ(site_after->evaluations, site_before->evaluations + 1);
+        EXPECT_EQ(site_after->line, check_positive_line);
+    }
+    // removed with the publisher
+    EXPECT_EQ(std::fopen(published_path.c_str(), "r"), nullptr);
+    EXPECT_THROW((void)libassert::read_site_counters(path), std::system_error);
+}
+
+template<int N>
+void numbered_site() {
+    ASSERT(N >= 0);
+}
+
+template<int... N>
+void evaluate_numbered_sites(std::integer_sequence<int, N...>) {
+    (numbered_site<N>(), ...);
+}
+
+TEST(SiteCounters, ManySites) {
+    // more sites than fit in the initial file
+    evaluate_numbered_sites(std::make_integer_sequence<int, 100>{});
+    const std::string path = "/tmp/libassert-site-counters-grow.counters";
+    libassert::site_counter_publisher publisher(std::chrono::milliseconds(1000), path);
+    auto sample = libassert::read_site_counters(path);
+    EXPECT_EQ(sample.sites.size(), libassert::site_counters().size());
+    std::size_t numbered = 0;
+    for(const auto& site : sample.sites) {
+        numbered += site.expression == "N >= 0" && site.evaluations == 1;
+    }
+    EXPECT_EQ(numbered, 100);
+}
+
+TEST(SiteCounters, Profile) {
+    check_positive(1);
+    const std::string path = "/tmp/libassert-site-counters-test.profile";
+    libassert::write_site_profile(path);
+    auto profile = libassert::read_site_profile(path);
+    EXPECT_GT(profile.duration.count(), 0);
+    EXPECT_EQ(profile.sites.size(), libassert::site_counters().size());
+    auto site = find_site(profile.sites, "x > 0");
+    ASSERT_TRUE(site.has_value());
+    EXPECT_EQ(site->macro_name, "ASSERT");
+    EXPECT_EQ(site->line, check_positive_line);
+    EXPECT_GT(site->evaluations, 0);
+    EXPECT_NE(site->file_name.find("site_counters.cpp"), std::string::npos);
+    std::remove(path.c_str());
+    // not a profile
+    EXPECT_THROW((void)libassert::read_site_profile("/proc/self/status"), std::runtime_error);
+}
+
+TEST(SiteCounters, NotACounterFile) {
+    const std::string path = "/tmp/libassert-site-counters-invalid";
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    ASSERT_NE(file, nullptr);
+    std::fputs("definitely not a counter file, but long enough to hold a header if it were one............", file);
+    std::fclose(file);
+    EXPECT_THROW((void)libassert::read_site_counters(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+#endif
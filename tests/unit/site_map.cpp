@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+// compiled with LIBASSERT_STRIP_SITE_STRINGS
+#include <libassert/assert.hpp>
+#include <libassert/site-map.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string_view>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// provided by the linker for the section the site records are in, the test binary isn't stripped
+extern "C" const char __start_libassert_sites[]; // NOLINT
+extern "C" const char __stop_libassert_sites[]; // NOLINT
+
+std::string last_report;
+
+void capturing_handler(const libassert::assertion_info& info) {
+    last_report = info.to_string(0, libassert::color_scheme::blank);
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(capturing_handler);
+    return 1;
+} ();
+
+constexpr int assertion_line = __LINE__ + 3;
+void failing_site(int x, int y) {
+    ASSERT(
+        x == y, "values differ", x + y
+    );
+}
+
+std::vector<libassert::site_map_entry> own_sites() {
+    return libassert::parse_site_records(
+        std::string_view(__start_libassert_sites, std::size_t(__stop_libassert_sites - __start_libassert_sites))
+    );
+}
+
+const libassert::site_map_entry* find_site(const std::vector<libassert::site_map_entry>& sites, std::string_view expr) {
+    auto it = std::find_if(sites.begin(), sites.end(), [&](const auto& site) { return site.expression == expr; });
+    return it == sites.end() ? nullptr : &*it;
+}
+
+TEST(SiteMap, ReportHasNoStrings) {
+    failing_site(1, 2);
+    EXPECT_NE(last_report.find("Assertion failed at site#"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("    ASSERT(...);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("values differ"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("$2 => 3"), std::string::npos) << last_report;
+    EXPECT_EQ(last_report.find("x == y"), std::string::npos) << last_report;
+    EXPECT_EQ(last_report.find("x + y"), std::string::npos) << last_report;
+    EXPECT_EQ(last_report.find("site_map.cpp"), std::string::npos) << last_report;
+}
+
+TEST(SiteMap, Records) {
+    const auto sites = own_sites();
+    const auto* site = find_site(sites, "x == y");
+    ASSERT_NE(site, nullptr);
+    EXPECT_EQ(site->macro_name, "ASSERT");
+    EXPECT_NE(site->file_name.find("site_map.cpp"), std::string::npos) << site->file_name;
+    EXPECT_EQ(site->args, (std::vector<std::string>{"\"values differ\"", "x + y"}));
+    failing_site(1, 2);
+    char id[32]; // NOLINT(*-avoid-c-arrays)
+    (void)std::snprintf(id, sizeof(id), "site#%016llx:0", static_cast<unsigned long long>(site->id));
+    EXPECT_NE(last_report.find(id), std::string::npos) << last_report;
+    const auto* without_args = find_site(sites, "true == false");
+    ASSERT_NE(without_args, nullptr);
+    EXPECT_TRUE(without_args->args.empty());
+    // the line is that of the macro invocation, which compilers report as its first or last line
+    EXPECT_GE(site->line, assertion_line - 1);
+    EXPECT_LE(site->line, assertion_line + 1);
+}
+
+TEST(SiteMap, Expand) {
+    failing_site(1, 2);
+    const auto sites = own_sites();
+    const auto* site = find_site(sites, "x == y");
+    ASSERT_NE(site, nullptr);
+    const auto expanded = libassert::expand_site_ids(last_report, sites);
+    const auto location = site->file_name + ":" + std::to_string(site->line) + ":";
+    EXPECT_NE(expanded.find("Assertion failed at " + location), std::string::npos) << expanded;
+    EXPECT_NE(expanded.find("    ASSERT(x == y, ...);"), std::string::npos) << expanded;
+    EXPECT_NE(expanded.find("x + y => 3"), std::string::npos) << expanded;
+    EXPECT_EQ(expanded.find("site#"), std::string::npos) << expanded;
+    // unknown sites and other text are left alone
+    const std::string unknown = "at site#0123456789abcdef:0\n    ASSERT();\n";
+    EXPECT_EQ(libassert::expand_site_ids(unknown, sites), unknown);
+    EXPECT_EQ(libassert::expand_site_ids("site#", sites), "site#");
+}
+
+TEST(SiteMap, MapRoundTrip) {
+    const std::string path = testing::TempDir() + "libassert-site-map-test";
+    std::vector<libassert::site_map_entry> sites = {
+        {0x0123456789abcdef, "ASSERT", "a\tb.cpp", 12, "x\\y", {"\"m\\n\"", ""}},
+        {0xfedcba9876543210, "PANIC", "c.cpp", 3, "", {}}
+    };
+    libassert::write_site_map(path, sites);
+    const auto read = libassert::read_site_map(path);
+    ASSERT_EQ(read.size(), 2);
+    for(std::size_t i = 0; i < read.size(); i++) {
+        EXPECT_EQ(read[i].id, sites[i].id);
+        EXPECT_EQ(read[i].macro_name, sites[i].macro_name);
+        EXPECT_EQ(read[i].file_name, sites[i].file_name);
+        EXPECT_EQ(read[i].line, sites[i].line);
+        EXPECT_EQ(read[i].expression, sites[i].expression);
+        EXPECT_EQ(read[i].args, sites[i].args);
+    }
+    (void)std::remove(path.c_str());
+    EXPECT_THROW((void)libassert::read_site_map(path), std::system_error);
+}
+
+TEST(SiteMap, Malformed) {
+    EXPECT_THROW((void)libassert::parse_site_records(std::string_view("LAS2\4\0\0\0abc\0", 12)), std::runtime_error);
+    EXPECT_THROW((void)libassert::parse_site_records(std::string_view("LAS1\40\0\0\0abc\0", 12)), std::runtime_error);
+    EXPECT_TRUE(libassert::parse_site_records(std::string_view("\0\0\0\0", 4)).empty());
+}
+
+void site_without_args() {
+    ASSERT(true == false);
+}
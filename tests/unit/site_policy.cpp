@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+// compiled with LIBASSERT_SITE_POLICY_HEADER naming test_files/site_policy.hpp, which refers to the lines of the
+// assertions below
+#include <libassert/assert.hpp>
+
+int failures = 0;
+
+void counting_handler(const libassert::assertion_info&) {
+    failures++;
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(counting_handler);
+    return 1;
+} ();
+
+void sampled_site(int x) {
+    ASSERT(x > 0); // line 18, sampled one in 4
+}
+
+void debug_only_site(int x) {
+    ASSERT(x > 0); // line 22, debug_only
+}
+
+void checked_site(int x) {
+    ASSERT(x > 0);
+}
+
+constexpr int sampled_in_constexpr(int x) {
+    ASSERT(x > 0); // line 30, sampled one in 1000
+    return x;
+}
+
+static_assert(sampled_in_constexpr(1) == 1);
+static_assert(libassert::detail::site_file_matches("/src/tests/unit/site_policy.cpp", "unit/site_policy.cpp"));
+static_assert(libassert::detail::site_file_matches("site_policy.cpp", "site_policy.cpp"));
+static_assert(!libassert::detail::site_file_matches("/src/tests/unit/site_policy.cpp", "policy.cpp"));
+static_assert(
+    libassert::detail::find_site_policy(libassert::source_location{"/src/tests/unit/site_policy.cpp", 18}).policy
+        == libassert::detail::site_policy::sampled
+);
+static_assert(
+    libassert::detail::find_site_policy(libassert::source_location{"/src/tests/unit/site_policy.cpp", 19}).policy
+        == libassert::detail::site_policy::checked
+);
+
+TEST(SitePolicy, Sampled) {
+    failures = 0;
+    for(int i = 0; i < 8; i++) {
+        sampled_site(0);
+    }
+    EXPECT_EQ(failures, 2);
+}
+
+TEST(SitePolicy, DebugOnly) {
+    failures = 0;
+    for(int i = 0; i < 3; i++) {
+        debug_only_site(0);
+    }
+    #ifdef NDEBUG
+    EXPECT_EQ(failures, 0);
+    #else
+    EXPECT_EQ(failures, 3);
+    #endif
+}
+
+TEST(SitePolicy, OtherSitesAreChecked) {
+    failures = 0;
+    for(int i = 0; i < 3; i++) {
+        checked_site(0);
+    }
+    EXPECT_EQ(failures, 3);
+}
+
+TEST(SitePolicy, SampledInConstexprFunction) {
+    failures = 0;
+    volatile int x = 0;
+    for(int i = 0; i < 3; i++) {
+        (void)sampled_in_constexpr(x);
+    }
+    EXPECT_EQ(failures, 1);
+}
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include <libassert/assert.hpp>
+#include <libassert/socket-sink.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std::literals;
+
+std::uint32_t read_u32(std::string_view data) {
+    std::uint32_t value = 0;
+    for(int i = 0; i < 4; i++) {
+        value |= std::uint32_t(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+std::vector<std::string> split_fields(std::string_view payload) {
+    std::vector<std::string> fields;
+    while(payload.size() >= 4) {
+        auto size = read_u32(payload);
+        fields.emplace_back(payload.substr(4, size));
+        payload.remove_prefix(4 + size);
+    }
+    return fields;
+}
+
+// stand-in for the collector agent
+class collector {
+    std::string path;
+    int listen_fd = -1;
+    int client_fd = -1;
+    std::string buffer;
+public:
+    explicit collector(std::string path_) : path(std::move(path_)) {
+        ::unlink(path.c_str());
+        listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        if(bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listen_fd, 4) != 0) {
+            std::perror("collector");
+        }
+    }
+    ~collector() {
+        if(client_fd != -1) {
+            close(client_fd);
+        }
+        close(listen_fd);
+        ::unlink(path.c_str());
+    }
+    collector(const collector&) = delete;
+    collector& operator=(const collector&) = delete;
+
+    // receives until n records arrived or the timeout expired
+    std::vector<std::string> receive(std::size_t n, std::chrono::milliseconds timeout = 5s) {
+        std::vector<std::string> records;
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while(records.size() < n && std::chrono::steady_clock::now() < deadline) {
+            pollfd pfd{client_fd == -1 ? listen_fd : client_fd, POLLIN, 0};
+            if(poll(&pfd, 1, 10) <= 0) {
+                continue;
+            }
+            if(client_fd == -1) {
+                client_fd = accept(listen_fd, nullptr, nullptr);
+                continue;
+            }
+            char chunk[4096];
+            auto count = read(client_fd, chunk, sizeof(chunk));
+            if(count <= 0) {
+                break;
+            }
+            buffer.append(chunk, static_cast<std::size_t>(count));
+            while(buffer.size() >= 4 && buffer.size() >= 4 + read_u32(buffer)) {
+                auto size = read_u32(buffer);
+                records.push_back(buffer.substr(4, size));
+                buffer.erase(0, 4 + size);
+            }
+        }
+        return records;
+    }
+};
+
+std::string socket_path(const std::string& name) {
+    return testing::TempDir() + "libassert-sink-" + name + ".sock";
+}
+
+TEST(UnixSocketSink, SynchronousFlush) {
+    auto path = socket_path("flush");
+    collector c(path);
+    libassert::unix_socket_sink sink({path, 16, 1024, 1024, 10s});
+    EXPECT_TRUE(sink.submit("foo"));
+    EXPECT_TRUE(sink.submit("barbaz"));
+    EXPECT_TRUE(sink.flush());
+    EXPECT_EQ(sink.sent(), 2);
+    EXPECT_EQ(sink.dropped(), 0);
+    auto records = c.receive(2);
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0], "foo");
+    EXPECT_EQ(records[1], "barbaz");
+}
+
+TEST(UnixSocketSink, BackgroundFlush) {
+    auto path = socket_path("background");
+    collector c(path);
+    libassert::unix_socket_sink sink({path, 1024, 1024, 64, 5ms});
+    for(int i = 0; i < 100; i++) {
+        EXPECT_TRUE(sink.submit(std::to_string(i)));
+    }
+    auto records = c.receive(100);
+    ASSERT_EQ(records.size(), 100);
+    for(int i = 0; i < 100; i++) {
+        EXPECT_EQ(records[i], std::to_string(i));
+    }
+}
+
+TEST(UnixSocketSink, OversizedPayloadsAreDropped) {
+    auto path = socket_path("oversized");
+    collector c(path);
+    libassert::unix_socket_sink sink({path, 16, 8, 1024, 10s});
+    EXPECT_FALSE(sink.submit(std::string(20, 'x')));
+    EXPECT_TRUE(sink.submit(std::string(8, 'y')));
+    EXPECT_TRUE(sink.flush());
+    EXPECT_EQ(sink.dropped(), 1);
+    auto records = c.receive(1);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_EQ(records[0], std::string(8, 'y'));
+}
+
+TEST(UnixSocketSink, DropsWithoutCollector) {
+    auto path = socket_path("missing");
+    ::unlink(path.c_str());
+    libassert::unix_socket_sink sink({path, 4, 1024, 1024, 10s});
+    int queued = 0;
+    for(int i = 0; i < 10; i++) {
+        queued += sink.submit("record");
+    }
+    EXPECT_EQ(queued, 4);
+    EXPECT_EQ(sink.dropped(), 6);
+    EXPECT_FALSE(sink.flush(10ms));
+    EXPECT_EQ(sink.sent(), 0);
+    // records still queued are delivered once a collector shows up
+    collector c(path);
+    EXPECT_TRUE(sink.flush());
+    EXPECT_EQ(sink.sent(), 4);
+    EXPECT_EQ(c.receive(4).size(), 4);
+}
+
+libassert::unix_socket_sink* test_sink = nullptr;
+
+void sink_handler(const libassert::assertion_info& info) {
+    test_sink->submit(info);
+    test_sink->flush();
+}
+
+TEST(UnixSocketSink, FailureRecords) {
+    auto path = socket_path("failure");
+    collector c(path);
+    libassert::unix_socket_sink sink({path, 16, 64 * 1024, 64 * 1024, 10s});
+    test_sink = &sink;
+    libassert::set_failure_handler(sink_handler);
+    int a = 1;
+    int b = 2;
+    int line = __LINE__ + 1;
+    ASSERT(a == b, "sink message");
+    libassert::set_failure_handler(libassert::default_failure_handler);
+    test_sink = nullptr;
+    auto records = c.receive(1);
+    ASSERT_EQ(records.size(), 1);
+    auto fields = split_fields(records[0]);
+    ASSERT_EQ(fields.size(), 7);
+    EXPECT_EQ(fields[0], "Assertion failed");
+    EXPECT_NE(fields[1].find("socket_sink.cpp"), std::string::npos);
+    EXPECT_EQ(fields[2], std::to_string(line));
+    EXPECT_NE(fields[3].find("TestBody"), std::string::npos);
+    EXPECT_EQ(fields[4], "a == b");
+    EXPECT_EQ(fields[5], "sink message");
+    EXPECT_NE(fields[6].find("a => 1"), std::string::npos) << fields[6];
+}
+
+TEST(UnixSocketSink, OversizedFailureRecords) {
+    auto path = socket_path("oversized-failure");
+    collector c(path);
+    constexpr std::size_t max_record_size = 512;
+    libassert::unix_socket_sink sink({path, 16, max_record_size, 64 * 1024, 10s});
+    test_sink = &sink;
+    libassert::set_failure_handler(sink_handler);
+    std::string long_value(4000, 'z');
+    ASSERT(false, "sink message", long_value);
+    libassert::set_failure_handler(libassert::default_failure_handler);
+    test_sink = nullptr;
+    EXPECT_EQ(sink.dropped(), 0);
+    auto records = c.receive(1);
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_LE(records[0].size(), max_record_size);
+    // only the report is cut short, the record's fields are intact
+    auto fields = split_fields(records[0]);
+    ASSERT_EQ(fields.size(), 7);
+    EXPECT_EQ(fields[4], "false");
+    EXPECT_EQ(fields[5], "sink message");
+    EXPECT_FALSE(fields[6].empty());
+    EXPECT_EQ(fields[6].find(long_value), std::string::npos);
+}
+
+int counting_handler_calls = 0;
+
+void counting_handler(const libassert::assertion_info&) {
+    counting_handler_calls++;
+}
+
+int other_handler_calls = 0;
+
+void other_handler(const libassert::assertion_info&) {
+    other_handler_calls++;
+}
+
+TEST(UnixSocketSink, RestoresPreviousHandler) {
+    auto path = socket_path("handler");
+    ::unlink(path.c_str());
+    libassert::set_failure_handler(counting_handler);
+    {
+        libassert::unix_socket_sink sink({path, 4, 1024, 1024, 1ms});
+        sink.install_failure_handler();
+    }
+    ASSERT(false);
+    EXPECT_EQ(counting_handler_calls, 1);
+    // a handler set after the sink was installed is left alone
+    {
+        libassert::unix_socket_sink sink({path, 4, 1024, 1024, 1ms});
+        sink.install_failure_handler();
+        libassert::set_failure_handler(other_handler);
+    }
+    ASSERT(false);
+    EXPECT_EQ(other_handler_calls, 1);
+    EXPECT_EQ(counting_handler_calls, 1);
+    libassert::set_failure_handler(libassert::default_failure_handler);
+}
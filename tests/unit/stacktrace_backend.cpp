@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <libassert/assert.hpp>
+
+#include <string>
+
+std::string last_report;
+std::string last_trace;
+
+void capturing_handler(const libassert::assertion_info& info) {
+    last_report = info.to_string(0, libassert::color_scheme::blank);
+    last_trace = info.print_stacktrace(0, libassert::color_scheme::blank);
+}
+
+inline auto pre_main = [] () {
+    libassert::set_failure_handler(capturing_handler);
+    return 1;
+} ();
+
+LIBASSERT_ATTR_NOINLINE void check_positive(int x) {
+    ASSERT(x > 0);
+}
+
+#ifdef LIBASSERT_STACKTRACE_BACKEND_NONE
+
+TEST(StacktraceBackend, NoTraces) {
+    check_positive(0);
+    EXPECT_NE(last_report.find("ASSERT(x > 0);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("x => 0"), std::string::npos) << last_report;
+    EXPECT_EQ(last_report.find("Stack trace:"), std::string::npos) << last_report;
+    EXPECT_EQ(last_trace, "");
+    EXPECT_EQ(libassert::stacktrace(), "");
+}
+
+#else
+
+TEST(StacktraceBackend, Traces) {
+    check_positive(0);
+    EXPECT_NE(last_report.find("ASSERT(x > 0);"), std::string::npos) << last_report;
+    EXPECT_NE(last_report.find("Stack trace:"), std::string::npos) << last_report;
+    EXPECT_NE(last_trace, "");
+    EXPECT_NE(libassert::stacktrace(), "");
+}
+
+#endif
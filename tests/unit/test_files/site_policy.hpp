@@ -0,0 +1,10 @@
+// Site policy for tests/unit/site_policy.cpp, in the format libassert-demote generates
+
+namespace libassert::detail {
+    inline constexpr demoted_site demoted_sites[] = {
+        {"unit/site_policy.cpp", 18, site_policy::sampled, 4},
+        {"unit/site_policy.cpp", 22, site_policy::debug_only, 1},
+        {"unit/site_policy.cpp", 30, site_policy::sampled, 1000},
+        {nullptr, 0, site_policy::checked, 1}
+    };
+}
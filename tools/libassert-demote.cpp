@@ -0,0 +1,228 @@
+// Generates a site policy header from a site profile (see libassert::write_site_profile) which demotes the hottest
+// ASSERT sites to debug-only or sampled checks when the header is passed as LIBASSERT_SITE_POLICY_HEADER
+// Usage: libassert-demote [-n top] [-r min_rate] [-p debug_only|sampled] [-s sample_period] [-x strip_prefix]
+//                         -o header profile
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <string_view>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <libassert/site-counters.hpp>
+
+namespace {
+    struct options {
+        unsigned long long top = 0;
+        double min_rate = 0;
+        bool has_min_rate = false;
+        std::string policy = "sampled";
+        unsigned long long sample_period = 64;
+        std::string strip_prefix;
+        const char* output = nullptr;
+        const char* profile = nullptr;
+    };
+
+    struct candidate {
+        std::string file;
+        std::uint32_t line;
+        std::string expression;
+        std::uint64_t evaluations;
+        std::uint64_t failures;
+    };
+
+    bool parse_number(const char* str, unsigned long long& value) {
+        char* end = nullptr;
+        value = std::strtoull(str, &end, 10);
+        return end != str && *end == '\0';
+    }
+
+    bool parse_rate(const char* str, double& value) {
+        char* end = nullptr;
+        value = std::strtod(str, &end);
+        return end != str && *end == '\0' && value >= 0;
+    }
+
+    std::string c_string_literal(std::string_view str) {
+        std::string literal = "\"";
+        for(char c : str) {
+            if(c == '"' || c == '\\') {
+                literal += '\\';
+            }
+            literal += c;
+        }
+        return literal + '"';
+    }
+
+    // Only ASSERT can be demoted. Template instantiations and inline functions record one site per instantiation, these
+    // are merged by file and line. Sites which failed during the profiled run are never demoted.
+    std::vector<candidate> collect_candidates(const libassert::site_profile& profile, std::string_view strip_prefix) {
+        std::map<std::pair<std::string, std::uint32_t>, candidate> merged;
+        for(const auto& site : profile.sites) {
+            if(site.macro_name != "ASSERT") {
+                continue;
+            }
+            std::string_view file = site.file_name;
+            if(!strip_prefix.empty() && file.substr(0, strip_prefix.size()) == strip_prefix) {
+                file.remove_prefix(strip_prefix.size());
+                while(!file.empty() && (file.front() == '/' || file.front() == '\\')) {
+                    file.remove_prefix(1);
+                }
+            }
+            auto [it, inserted] = merged.try_emplace(
+                {std::string(file), site.line},
+                candidate{std::string(file), site.line, site.expression, 0, 0}
+            );
+            it->second.evaluations += site.evaluations;
+            it->second.failures += site.failures;
+        }
+        std::vector<candidate> candidates;
+        for(auto& [key, site] : merged) {
+            if(site.failures == 0) {
+                candidates.push_back(std::move(site));
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const candidate& a, const candidate& b) {
+            return std::tie(b.evaluations, a.file, a.line) < std::tie(a.evaluations, b.file, b.line);
+        });
+        return candidates;
+    }
+
+    double rate_of(const candidate& site, const libassert::site_profile& profile) {
+        double seconds = std::chrono::duration<double>(profile.duration).count();
+        return seconds > 0 ? static_cast<double>(site.evaluations) / seconds : 0;
+    }
+
+    std::string generate_header(const options& opts, const libassert::site_profile& profile) {
+        const auto candidates = collect_candidates(profile, opts.strip_prefix);
+        std::uint64_t total_evaluations = 0;
+        for(const auto& site : profile.sites) {
+            total_evaluations += site.evaluations;
+        }
+        std::vector<const candidate*> demoted;
+        for(std::size_t i = 0; i < candidates.size(); i++) {
+            if(i < opts.top || (opts.has_min_rate && rate_of(candidates[i], profile) >= opts.min_rate)) {
+                demoted.push_back(&candidates[i]);
+            }
+        }
+        std::uint64_t demoted_evaluations = 0;
+        for(const auto* site : demoted) {
+            demoted_evaluations += site->evaluations;
+        }
+        std::string header;
+        char buffer[256]; // NOLINT(*-avoid-c-arrays)
+        header += "// Generated by libassert-demote from " + std::string(opts.profile) + ", do not edit\n";
+        (void)std::snprintf(
+            buffer,
+            sizeof(buffer),
+            "// %zu of %zu sites demoted, covering %.1f%% of %llu profiled evaluations\n",
+            demoted.size(),
+            profile.sites.size(),
+            total_evaluations == 0 ? 0.0 : 100.0 * static_cast<double>(demoted_evaluations) / static_cast<double>(total_evaluations),
+            static_cast<unsigned long long>(total_evaluations)
+        );
+        header += buffer;
+        header += "\n";
+        header += "namespace libassert::detail {\n";
+        header += "    inline constexpr demoted_site demoted_sites[] = {\n";
+        for(const auto* site : demoted) {
+            (void)std::snprintf(
+                buffer,
+                sizeof(buffer),
+                ", %u, site_policy::%s, %llu}, // %.0f evals/s: ",
+                site->line,
+                opts.policy.c_str(),
+                opts.sample_period,
+                rate_of(*site, profile)
+            );
+            header += "        {" + c_string_literal(site->file) + buffer + site->expression + "\n";
+        }
+        header += "        {nullptr, 0, site_policy::checked, 1}\n";
+        header += "    };\n";
+        header += "}\n";
+        return header;
+    }
+
+    bool parse_options(int argc, char** argv, options& opts) {
+        for(int i = 1; i < argc; i++) {
+            std::string_view arg = argv[i];
+            if(arg.size() == 2 && arg[0] == '-' && std::strchr("nrpsxo", arg[1]) && i + 1 < argc) {
+                const char* value = argv[++i];
+                switch(arg[1]) {
+                    case 'n':
+                        if(!parse_number(value, opts.top)) {
+                            std::fprintf(stderr, "Invalid number \"%s\"\n", value);
+                            return false;
+                        }
+                        break;
+                    case 'r':
+                        if(!parse_rate(value, opts.min_rate)) {
+                            std::fprintf(stderr, "Invalid rate \"%s\"\n", value);
+                            return false;
+                        }
+                        opts.has_min_rate = true;
+                        break;
+                    case 'p':
+                        opts.policy = value;
+                        if(opts.policy != "debug_only" && opts.policy != "sampled") {
+                            std::fprintf(stderr, "Invalid policy \"%s\", expected debug_only or sampled\n", value);
+                            return false;
+                        }
+                        break;
+                    case 's':
+                        if(!parse_number(value, opts.sample_period) || opts.sample_period == 0 || opts.sample_period > UINT32_MAX) {
+                            std::fprintf(stderr, "Invalid sample period \"%s\"\n", value);
+                            return false;
+                        }
+                        break;
+                    case 'x':
+                        opts.strip_prefix = value;
+                        break;
+                    default:
+                        opts.output = value;
+                        break;
+                }
+            } else if(!opts.profile && !arg.empty() && arg[0] != '-') {
+                opts.profile = argv[i];
+            } else {
+                return false;
+            }
+        }
+        return opts.profile && opts.output;
+    }
+}
+
+int main(int argc, char** argv) {
+    options opts;
+    if(!parse_options(argc, argv, opts)) {
+        std::fprintf(
+            stderr,
+            "Usage: %s [-n top] [-r min_rate] [-p debug_only|sampled] [-s sample_period] [-x strip_prefix] "
+            "-o header profile\n",
+            argv[0]
+        );
+        return 2;
+    }
+    try {
+        auto profile = libassert::read_site_profile(opts.profile);
+        auto header = generate_header(opts, profile);
+        std::ofstream output(opts.output, std::ios::binary | std::ios::trunc);
+        output << header;
+        if(!output.flush()) {
+            std::fprintf(stderr, "Failed to write \"%s\"\n", opts.output);
+            return 1;
+        }
+    } catch(const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,39 @@
+// Dumps the most recent records from a libassert::failure_ring file
+// Usage: libassert-ring-dump <file> [count]
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+
+#include <libassert/failure-ring.hpp>
+
+int main(int argc, char** argv) {
+    if(argc < 2 || argc > 3) {
+        std::fprintf(stderr, "Usage: %s <file> [count]\n", argv[0]);
+        return 2;
+    }
+    std::size_t count = 10;
+    if(argc == 3) {
+        char* end = nullptr;
+        unsigned long long value = std::strtoull(argv[2], &end, 10);
+        if(end == argv[2] || *end != '\0') {
+            std::fprintf(stderr, "Invalid count \"%s\"\n", argv[2]);
+            return 2;
+        }
+        count = static_cast<std::size_t>(value);
+    }
+    try {
+        for(const auto& record : libassert::read_failure_ring(argv[1], count)) {
+            std::printf(
+                "---- #%llu%s ----\n%s\n",
+                static_cast<unsigned long long>(record.sequence),
+                record.truncated ? " (truncated)" : "",
+                record.text.c_str()
+            );
+        }
+    } catch(const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}
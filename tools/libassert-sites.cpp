@@ -0,0 +1,80 @@
+// Works with the site strings of a binary built with LIBASSERT_STRIP_SITE_STRINGS
+// Usage: libassert-sites extract -o <site map> <section>...
+//        libassert-sites expand <site map> [report]
+// extract reads libassert_sites sections dumped with objcopy --dump-section and writes a site map, expand rewrites the
+// site IDs in a failure report (or stdin) using the site map and writes it to stdout
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <string>
+#include <vector>
+
+#include <libassert/site-map.hpp>
+
+namespace {
+    std::string read_file(const char* path) {
+        std::ifstream stream(path, std::ios::binary);
+        if(!stream) {
+            throw std::runtime_error("Failed to open \"" + std::string(path) + "\"");
+        }
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    int extract(int argc, char** argv) {
+        if(argc < 5 || std::string_view(argv[2]) != "-o") {
+            return 2;
+        }
+        std::vector<libassert::site_map_entry> sites;
+        for(int i = 4; i < argc; i++) {
+            auto section_sites = libassert::parse_site_records(read_file(argv[i]));
+            sites.insert(sites.end(), section_sites.begin(), section_sites.end());
+        }
+        libassert::write_site_map(argv[3], sites);
+        return 0;
+    }
+
+    int expand(int argc, char** argv) {
+        if(argc != 3 && argc != 4) {
+            return 2;
+        }
+        auto sites = libassert::read_site_map(argv[2]);
+        std::string report;
+        if(argc == 4) {
+            report = read_file(argv[3]);
+        } else {
+            report.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+        }
+        const auto expanded = libassert::expand_site_ids(report, sites);
+        (void)std::fwrite(expanded.data(), 1, expanded.size(), stdout);
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    int status = 2;
+    try {
+        if(argc >= 2 && std::string_view(argv[1]) == "extract") {
+            status = extract(argc, argv);
+        } else if(argc >= 2 && std::string_view(argv[1]) == "expand") {
+            status = expand(argc, argv);
+        }
+    } catch(const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    if(status == 2) {
+        std::fprintf(
+            stderr,
+            "Usage: %s extract -o <site map> <section>...\n"
+            "       %s expand <site map> [report]\n",
+            argv[0],
+            argv[0]
+        );
+    }
+    return status;
+}
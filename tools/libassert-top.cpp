@@ -0,0 +1,133 @@
+// Samples the site counters published by a process running with LIBASSERT_SITE_COUNTERS and a
+// libassert::site_counter_publisher and shows the busiest assertion sites
+// Usage: libassert-top [-i interval_ms] [-n rows] [-b iterations] <pid | file>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <libassert/site-counters.hpp>
+
+namespace {
+    using site_id = std::tuple<std::string, std::uint32_t, std::string>;
+
+    site_id id_of(const libassert::site_counter_snapshot& site) {
+        return {site.file_name, site.line, site.expression};
+    }
+
+    bool parse_number(const char* str, unsigned long long& value) {
+        char* end = nullptr;
+        value = std::strtoull(str, &end, 10);
+        return end != str && *end == '\0';
+    }
+
+    void print_sample(
+        const libassert::site_counter_sample& sample,
+        const std::map<site_id, std::uint64_t>& previous,
+        double elapsed_seconds,
+        std::size_t rows
+    ) {
+        struct row {
+            double rate;
+            const libassert::site_counter_snapshot* site;
+        };
+        std::vector<row> table;
+        for(const auto& site : sample.sites) {
+            double rate = 0;
+            if(elapsed_seconds > 0) {
+                auto it = previous.find(id_of(site));
+                std::uint64_t before = it == previous.end() ? 0 : it->second;
+                rate = static_cast<double>(site.evaluations - before) / elapsed_seconds;
+            }
+            table.push_back({rate, &site});
+        }
+        std::sort(table.begin(), table.end(), [](const row& a, const row& b) {
+            return std::tie(a.rate, a.site->evaluations) > std::tie(b.rate, b.site->evaluations);
+        });
+        std::printf(
+            "pid %llu, %zu sites, publication %llu\n",
+            static_cast<unsigned long long>(sample.pid),
+            sample.sites.size(),
+            static_cast<unsigned long long>(sample.publications)
+        );
+        std::printf("%14s  %16s  %12s  %-18s  %s\n", "Evals/s", "Evaluations", "Failures", "Macro", "Location: Expression");
+        for(std::size_t i = 0; i < std::min(rows, table.size()); i++) {
+            const auto& site = *table[i].site;
+            std::printf(
+                "%14.0f  %16llu  %12llu  %-18s  %s:%u: %s\n",
+                table[i].rate,
+                static_cast<unsigned long long>(site.evaluations),
+                static_cast<unsigned long long>(site.failures),
+                site.macro_name.c_str(),
+                site.file_name.c_str(),
+                site.line,
+                site.expression.c_str()
+            );
+        }
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned long long interval_ms = 1000;
+    unsigned long long rows = 20;
+    unsigned long long iterations = 0; // forever
+    bool batch = false;
+    const char* target = nullptr;
+    for(int i = 1; i < argc; i++) {
+        if((!std::strcmp(argv[i], "-i") || !std::strcmp(argv[i], "-n") || !std::strcmp(argv[i], "-b")) && i + 1 < argc) {
+            auto& value = argv[i][1] == 'i' ? interval_ms : argv[i][1] == 'n' ? rows : iterations;
+            batch = batch || argv[i][1] == 'b';
+            if(!parse_number(argv[i + 1], value)) {
+                std::fprintf(stderr, "Invalid number \"%s\"\n", argv[i + 1]);
+                return 2;
+            }
+            i++;
+        } else if(!target && argv[i][0] != '-') {
+            target = argv[i];
+        } else {
+            target = nullptr;
+            break;
+        }
+    }
+    if(!target) {
+        std::fprintf(stderr, "Usage: %s [-i interval_ms] [-n rows] [-b iterations] <pid | file>\n", argv[0]);
+        return 2;
+    }
+    unsigned long long pid = 0;
+    std::string path = parse_number(target, pid) ? libassert::default_site_counter_path(pid) : target;
+    std::map<site_id, std::uint64_t> previous;
+    std::chrono::nanoseconds previous_timestamp{0};
+    try {
+        for(unsigned long long n = 0; !batch || n < iterations; n++) {
+            auto sample = libassert::read_site_counters(path);
+            double elapsed = previous_timestamp.count() == 0 || sample.timestamp <= previous_timestamp
+                ? 0
+                : std::chrono::duration<double>(sample.timestamp - previous_timestamp).count();
+            if(!batch) {
+                std::printf("\x1b[H\x1b[2J");
+            }
+            print_sample(sample, previous, elapsed, rows);
+            previous.clear();
+            for(const auto& site : sample.sites) {
+                previous[id_of(site)] = site.evaluations;
+            }
+            previous_timestamp = sample.timestamp;
+            if(!batch || n + 1 < iterations) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+            }
+        }
+    } catch(const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}